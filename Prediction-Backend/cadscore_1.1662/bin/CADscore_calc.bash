@@ -34,6 +34,7 @@ $0 parameters:
     -y    flag to generate more detailed summary
     -x    flag to delete non-summary data calculated for model
     -j    flag to turn off thread-safe mode
+    -k    flag to store intermediate data in binary format
     -v    path to atomic radii files directory
     -e    extra command to produce additional global scores
 
@@ -85,9 +86,10 @@ FULL_GLOBAL_SCORES=false
 DELETE_DETAILED_MODEL_DATA=false
 THREAD_SAFE_ON=true
 RADII_OPTION=""
+BINARY_IO_FLAG=""
 EXTRA_COMMAND=""
 
-while getopts "hD:t:m:lczqgi:arubnsyxjv:e:" OPTION
+while getopts "hD:t:m:lczqgi:arubnsyxjkv:e:" OPTION
 do
   case $OPTION in
     h)
@@ -149,6 +151,9 @@ do
     j)
       THREAD_SAFE_ON=false
       ;;
+    k)
+      BINARY_IO_FLAG="--binary-io"
+      ;;
     v)
       RADII_OPTION="--radius-classes $OPTARG/vdwr_classes --radius-members $OPTARG/vdwr_members"
       ;;
@@ -240,16 +245,16 @@ if mkdir $TARGET_DIR &> /dev/null
 then
   echo -n "$TARGET_PARAMETERS" > $TARGET_PARAMETERS_FILE
   
-  if [ ! -f $TARGET_ATOMS_FILE ] ; then cat $TARGET_FILE | $VOROPROT --mode collect-atoms $HETATM_FLAG $RADII_OPTION $RESETTING_CHAIN_NAMES > $TARGET_ATOMS_FILE ; fi
-  if [ -s "$TARGET_ATOMS_FILE" ] && [ ! -f $TARGET_INTER_ATOM_CONTACTS_FILE ] ; then cat $TARGET_ATOMS_FILE | $VOROPROT --mode calc-inter-atom-contacts > $TARGET_INTER_ATOM_CONTACTS_FILE ; fi
-  if [ -s "$TARGET_INTER_ATOM_CONTACTS_FILE" ] && [ ! -f $TARGET_RESIDUE_IDS_FILE ] ; then cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode collect-residue-ids  > $TARGET_RESIDUE_IDS_FILE ; fi
+  if [ ! -f $TARGET_ATOMS_FILE ] ; then cat $TARGET_FILE | $VOROPROT --mode collect-atoms $HETATM_FLAG $RADII_OPTION $RESETTING_CHAIN_NAMES $BINARY_IO_FLAG > $TARGET_ATOMS_FILE ; fi
+  if [ -s "$TARGET_ATOMS_FILE" ] && [ ! -f $TARGET_INTER_ATOM_CONTACTS_FILE ] ; then cat $TARGET_ATOMS_FILE | $VOROPROT --mode calc-inter-atom-contacts $BINARY_IO_FLAG > $TARGET_INTER_ATOM_CONTACTS_FILE ; fi
+  if [ -s "$TARGET_INTER_ATOM_CONTACTS_FILE" ] && [ ! -f $TARGET_RESIDUE_IDS_FILE ] ; then cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode collect-residue-ids $BINARY_IO_FLAG > $TARGET_RESIDUE_IDS_FILE ; fi
   if [ -s "$TARGET_INTER_ATOM_CONTACTS_FILE" ] && [ ! -f $TARGET_INTER_RESIDUE_CONTACTS_FILE ]
   then
     if $NUCLEIC_ACIDS_MODE
     then
-      (cat $TARGET_ATOMS_FILE ; cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION) | $VOROPROT --mode categorize-inter-nucleotide-side-chain-contacts > $TARGET_INTER_RESIDUE_CONTACTS_FILE
+      (cat $TARGET_ATOMS_FILE ; cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION $BINARY_IO_FLAG) | $VOROPROT --mode categorize-inter-nucleotide-side-chain-contacts $BINARY_IO_FLAG > $TARGET_INTER_RESIDUE_CONTACTS_FILE
     else
-      cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION > $TARGET_INTER_RESIDUE_CONTACTS_FILE
+      cat $TARGET_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION $BINARY_IO_FLAG > $TARGET_INTER_RESIDUE_CONTACTS_FILE
     fi
   fi
 
@@ -296,7 +301,7 @@ if [ ! -s "$TARGET_INTER_RESIDUE_CONTACTS_FILE" ] ; then echo "Fatal error: no i
 
 mkdir -p $MODEL_DIR
 
-test -f $MODEL_ATOMS_FILE || cat $MODEL_FILE | $VOROPROT --mode collect-atoms $HETATM_FLAG $RADII_OPTION $RESETTING_CHAIN_NAMES > $MODEL_ATOMS_FILE
+test -f $MODEL_ATOMS_FILE || cat $MODEL_FILE | $VOROPROT --mode collect-atoms $HETATM_FLAG $RADII_OPTION $RESETTING_CHAIN_NAMES $BINARY_IO_FLAG > $MODEL_ATOMS_FILE
 if [ ! -s "$MODEL_ATOMS_FILE" ] ; then echo "Fatal error: no atoms in the model" 1>&2 ; exit 1 ; fi
 
 if $DISABLE_MODEL_ATOMS_FILTERING
@@ -304,22 +309,22 @@ then
   MODEL_FILTERED_ATOMS_FILE=$MODEL_ATOMS_FILE
 fi
 
-test -f $MODEL_FILTERED_ATOMS_FILE || (cat $MODEL_ATOMS_FILE ; cat $TARGET_ATOMS_FILE) | $VOROPROT --mode filter-atoms-by-target $ALLOW_UNMATCHED_RESIDUE_NAMES_IN_FILTERING > $MODEL_FILTERED_ATOMS_FILE
+test -f $MODEL_FILTERED_ATOMS_FILE || (cat $MODEL_ATOMS_FILE ; cat $TARGET_ATOMS_FILE) | $VOROPROT --mode filter-atoms-by-target $ALLOW_UNMATCHED_RESIDUE_NAMES_IN_FILTERING $BINARY_IO_FLAG > $MODEL_FILTERED_ATOMS_FILE
 if [ ! -s "$MODEL_FILTERED_ATOMS_FILE" ] ; then echo "Fatal error: no atoms left in the model after filtering by target" 1>&2 ; exit 1 ; fi
 
-test -f $MODEL_INTER_ATOM_CONTACTS_FILE || cat $MODEL_FILTERED_ATOMS_FILE | $VOROPROT --mode calc-inter-atom-contacts > $MODEL_INTER_ATOM_CONTACTS_FILE
+test -f $MODEL_INTER_ATOM_CONTACTS_FILE || cat $MODEL_FILTERED_ATOMS_FILE | $VOROPROT --mode calc-inter-atom-contacts $BINARY_IO_FLAG > $MODEL_INTER_ATOM_CONTACTS_FILE
 if [ ! -s "$MODEL_INTER_ATOM_CONTACTS_FILE" ] ; then echo "Fatal error: no inter-atom contacts in the model" 1>&2 ; exit 1 ; fi
 
-test -f $MODEL_RESIDUE_IDS_FILE || cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode collect-residue-ids  > $MODEL_RESIDUE_IDS_FILE
+test -f $MODEL_RESIDUE_IDS_FILE || cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode collect-residue-ids $BINARY_IO_FLAG > $MODEL_RESIDUE_IDS_FILE
 if [ ! -s "$MODEL_RESIDUE_IDS_FILE" ] ; then echo "Fatal error: no filtered residues in the model" 1>&2 ; exit 1 ; fi
 	
 if [ ! -f $MODEL_INTER_RESIDUE_CONTACTS_FILE ]
 then
   if $NUCLEIC_ACIDS_MODE
   then
-  	(cat $MODEL_FILTERED_ATOMS_FILE ; cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION) | $VOROPROT --mode categorize-inter-nucleotide-side-chain-contacts > $MODEL_INTER_RESIDUE_CONTACTS_FILE
+  	(cat $MODEL_FILTERED_ATOMS_FILE ; cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION $BINARY_IO_FLAG) | $VOROPROT --mode categorize-inter-nucleotide-side-chain-contacts $BINARY_IO_FLAG > $MODEL_INTER_RESIDUE_CONTACTS_FILE
   else
-    cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION > $MODEL_INTER_RESIDUE_CONTACTS_FILE
+    cat $MODEL_INTER_ATOM_CONTACTS_FILE | $VOROPROT --mode calc-inter-residue-contacts $INTER_CHAIN_FLAG $INTERFACE_ZONE_FLAG $INTER_INTERVAL_OPTION $BINARY_IO_FLAG > $MODEL_INTER_RESIDUE_CONTACTS_FILE
   fi
 fi
 if [ ! -s "$MODEL_INTER_RESIDUE_CONTACTS_FILE" ] ; then echo "Fatal error: no inter-residue contacts in the model" 1>&2 ; exit 1 ; fi
@@ -329,14 +334,14 @@ if [ ! -s "$MODEL_INTER_RESIDUE_CONTACTS_FILE" ] ; then echo "Fatal error: no in
 
 if $QUATERNARY_CHAINS_RENAMING
 then
-  test -f $COMBINED_INTER_RESIDUE_CONTACTS_FILE || cat $TARGET_INTER_RESIDUE_CONTACTS_FILE $MODEL_INTER_RESIDUE_CONTACTS_FILE $TARGET_RESIDUE_IDS_FILE | $VOROPROT --mode calc-combined-inter-residue-contacts --optimally-rename-chains > $COMBINED_INTER_RESIDUE_CONTACTS_FILE
+  test -f $COMBINED_INTER_RESIDUE_CONTACTS_FILE || cat $TARGET_INTER_RESIDUE_CONTACTS_FILE $MODEL_INTER_RESIDUE_CONTACTS_FILE $TARGET_RESIDUE_IDS_FILE | $VOROPROT --mode calc-combined-inter-residue-contacts --optimally-rename-chains $BINARY_IO_FLAG > $COMBINED_INTER_RESIDUE_CONTACTS_FILE
 else
-  test -f $COMBINED_INTER_RESIDUE_CONTACTS_FILE || cat $TARGET_INTER_RESIDUE_CONTACTS_FILE $MODEL_INTER_RESIDUE_CONTACTS_FILE | $VOROPROT --mode calc-combined-inter-residue-contacts > $COMBINED_INTER_RESIDUE_CONTACTS_FILE
+  test -f $COMBINED_INTER_RESIDUE_CONTACTS_FILE || cat $TARGET_INTER_RESIDUE_CONTACTS_FILE $MODEL_INTER_RESIDUE_CONTACTS_FILE | $VOROPROT --mode calc-combined-inter-residue-contacts $BINARY_IO_FLAG > $COMBINED_INTER_RESIDUE_CONTACTS_FILE
 fi
 
 if [ ! -s "$COMBINED_INTER_RESIDUE_CONTACTS_FILE" ] ; then echo "Fatal error: combined inter-residue contacts file is empty" 1>&2 ; exit 1 ; fi
 	
-test -f $CAD_PROFILE_FILE || cat $COMBINED_INTER_RESIDUE_CONTACTS_FILE $TARGET_RESIDUE_IDS_FILE | $VOROPROT --mode calc-CAD-profile > $CAD_PROFILE_FILE
+test -f $CAD_PROFILE_FILE || cat $COMBINED_INTER_RESIDUE_CONTACTS_FILE $TARGET_RESIDUE_IDS_FILE | $VOROPROT --mode calc-CAD-profile $BINARY_IO_FLAG > $CAD_PROFILE_FILE
 if [ ! -s "$CAD_PROFILE_FILE" ] ; then echo "Fatal error: CAD profile file is empty" 1>&2 ; exit 1 ; fi
 
 test -f $CAD_GLOBAL_SCORES_FILE || cat $CAD_PROFILE_FILE | $VOROPROT --mode calc-CAD-global-scores $GLOBAL_SCORES_CATEGORIES > $CAD_GLOBAL_SCORES_FILE
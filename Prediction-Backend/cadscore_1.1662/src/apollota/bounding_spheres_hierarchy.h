@@ -5,6 +5,12 @@
 #include <algorithm>
 #include <limits>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "basic_operations_on_spheres.h"
 #include "splitting_of_spheres.h"
 
@@ -18,7 +24,8 @@ public:
 	BoundingSpheresHierarchy(const std::vector<InputSphereType>& input_spheres, const double initial_radius_for_spheres_bucketing, const std::size_t min_number_of_clusters) :
 		leaves_spheres_(convert_input_spheres_to_simple_spheres(input_spheres)),
 		input_radii_range_(calc_input_radii_range(leaves_spheres_)),
-		clusters_layers_(cluster_spheres_in_layers(leaves_spheres_, initial_radius_for_spheres_bucketing, min_number_of_clusters))
+		clusters_layers_(cluster_spheres_in_layers(leaves_spheres_, initial_radius_for_spheres_bucketing, min_number_of_clusters)),
+		leaves_blocks_(clusters_layers_.empty() ? LeavesBlocks() : LeavesBlocks(leaves_spheres_, clusters_layers_.front()))
 	{
 	}
 
@@ -59,59 +66,14 @@ public:
 	template<typename NodeChecker, typename LeafChecker>
 	std::vector<std::size_t> search(NodeChecker& node_checker, LeafChecker& leaf_checker) const
 	{
-		std::vector<std::size_t> results;
-		if(!clusters_layers_.empty())
-		{
-			std::vector<NodeCoordinates> stack;
-			stack.reserve(clusters_layers_.back().size()+clusters_layers_.size()+1);
-			{
-				const std::size_t top_level=clusters_layers_.size()-1;
-				for(std::size_t top_id=0;top_id<clusters_layers_[top_level].size();top_id++)
-				{
-					stack.push_back(NodeCoordinates(top_level, top_id, 0));
-				}
-			}
-			while(!stack.empty())
-			{
-				const NodeCoordinates ncs=stack.back();
-				if(
-						ncs.level_id<clusters_layers_.size()
-						&& ncs.cluster_id<clusters_layers_[ncs.level_id].size()
-						&& ncs.child_id<clusters_layers_[ncs.level_id][ncs.cluster_id].children.size()
-						&& (ncs.child_id>0 || node_checker(clusters_layers_[ncs.level_id][ncs.cluster_id]))
-					)
-				{
-					const std::vector<std::size_t>& children=clusters_layers_[ncs.level_id][ncs.cluster_id].children;
-					if(ncs.level_id==0)
-					{
-						for(std::size_t i=0;i<children.size();i++)
-						{
-							const std::size_t child=children[i];
-							const std::pair<bool, bool> status=leaf_checker(child, leaves_spheres_[child]);
-							if(status.first)
-							{
-								results.push_back(child);
-								if(status.second)
-								{
-									return results;
-								}
-							}
-						}
-						stack.pop_back();
-					}
-					else
-					{
-						stack.back().child_id++;
-						stack.push_back(NodeCoordinates(ncs.level_id-1, children[ncs.child_id], 0));
-					}
-				}
-				else
-				{
-					stack.pop_back();
-				}
-			}
-		}
-		return results;
+		return search_in_layers<false>(node_checker, leaf_checker);
+	}
+
+	// Leaf checker is called only for the leaves that intersect the sphere returned by its leaves_filter_sphere() function
+	template<typename NodeChecker, typename LeafChecker>
+	std::vector<std::size_t> search_with_leaves_filter(NodeChecker& node_checker, LeafChecker& leaf_checker) const
+	{
+		return search_in_layers<true>(node_checker, leaf_checker);
 	}
 
 	template<typename ListType, typename FunctorType>
@@ -165,6 +127,180 @@ private:
 		}
 	};
 
+	struct LeavesBlocks
+	{
+		std::vector<std::size_t> offsets;
+		std::vector<double> x;
+		std::vector<double> y;
+		std::vector<double> z;
+		std::vector<double> r;
+
+		LeavesBlocks()
+		{
+		}
+
+		LeavesBlocks(const std::vector<SimpleSphere>& leaves, const std::vector<Cluster>& bottom_clusters)
+		{
+			offsets.reserve(bottom_clusters.size());
+			std::size_t size=0;
+			for(std::size_t i=0;i<bottom_clusters.size();i++)
+			{
+				offsets.push_back(size);
+				size+=((bottom_clusters[i].children.size()+3)/4)*4;
+			}
+			x.resize(size, 0.0);
+			y.resize(size, 0.0);
+			z.resize(size, 0.0);
+			r.resize(size, -std::numeric_limits<double>::max());
+			for(std::size_t i=0;i<bottom_clusters.size();i++)
+			{
+				const std::vector<std::size_t>& children=bottom_clusters[i].children;
+				for(std::size_t j=0;j<children.size();j++)
+				{
+					const SimpleSphere& s=leaves[children[j]];
+					x[offsets[i]+j]=s.x;
+					y[offsets[i]+j]=s.y;
+					z[offsets[i]+j]=s.z;
+					r[offsets[i]+j]=s.r;
+				}
+			}
+		}
+
+		unsigned int intersections_mask(const std::size_t pos, const SimpleSphere& target) const
+		{
+#if defined(__AVX__)
+			const __m256d dx=_mm256_sub_pd(_mm256_loadu_pd(&x[pos]), _mm256_set1_pd(target.x));
+			const __m256d dy=_mm256_sub_pd(_mm256_loadu_pd(&y[pos]), _mm256_set1_pd(target.y));
+			const __m256d dz=_mm256_sub_pd(_mm256_loadu_pd(&z[pos]), _mm256_set1_pd(target.z));
+			const __m256d d=_mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz)));
+			const __m256d rs=_mm256_add_pd(_mm256_loadu_pd(&r[pos]), _mm256_set1_pd(target.r));
+			return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_add_pd(d, _mm256_set1_pd(default_comparison_epsilon())), rs, _CMP_LT_OQ)));
+#elif defined(__SSE2__)
+			return (intersections_mask_of_pair(pos, target) | (intersections_mask_of_pair(pos+2, target)<<2));
+#else
+			unsigned int mask=0;
+			for(std::size_t i=0;i<4;i++)
+			{
+				if(sphere_intersects_sphere(SimpleSphere(x[pos+i], y[pos+i], z[pos+i], r[pos+i]), target))
+				{
+					mask|=(1u<<i);
+				}
+			}
+			return mask;
+#endif
+		}
+
+#if !defined(__AVX__) && defined(__SSE2__)
+		unsigned int intersections_mask_of_pair(const std::size_t pos, const SimpleSphere& target) const
+		{
+			const __m128d dx=_mm_sub_pd(_mm_loadu_pd(&x[pos]), _mm_set1_pd(target.x));
+			const __m128d dy=_mm_sub_pd(_mm_loadu_pd(&y[pos]), _mm_set1_pd(target.y));
+			const __m128d dz=_mm_sub_pd(_mm_loadu_pd(&z[pos]), _mm_set1_pd(target.z));
+			const __m128d d=_mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz)));
+			const __m128d rs=_mm_add_pd(_mm_loadu_pd(&r[pos]), _mm_set1_pd(target.r));
+			return static_cast<unsigned int>(_mm_movemask_pd(_mm_cmplt_pd(_mm_add_pd(d, _mm_set1_pd(default_comparison_epsilon())), rs)));
+		}
+#endif
+	};
+
+	template<bool filtered>
+	struct LeavesFilteringTag
+	{
+	};
+
+	template<typename LeafChecker>
+	bool check_leaves(const std::size_t, const std::vector<std::size_t>& children, LeafChecker& leaf_checker, std::vector<std::size_t>& results, const LeavesFilteringTag<false>) const
+	{
+		for(std::size_t i=0;i<children.size();i++)
+		{
+			if(check_leaf(children[i], leaf_checker, results))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template<typename LeafChecker>
+	bool check_leaves(const std::size_t cluster_id, const std::vector<std::size_t>& children, LeafChecker& leaf_checker, std::vector<std::size_t>& results, const LeavesFilteringTag<true>) const
+	{
+		const SimpleSphere filter_sphere=leaf_checker.leaves_filter_sphere();
+		const std::size_t offset=leaves_blocks_.offsets[cluster_id];
+		for(std::size_t i=0;i<children.size();i+=4)
+		{
+			const unsigned int mask=leaves_blocks_.intersections_mask(offset+i, filter_sphere);
+			for(std::size_t j=0;j<4 && (i+j)<children.size();j++)
+			{
+				if(((mask>>j)&1u) && check_leaf(children[i+j], leaf_checker, results))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	template<typename LeafChecker>
+	bool check_leaf(const std::size_t id, LeafChecker& leaf_checker, std::vector<std::size_t>& results) const
+	{
+		const std::pair<bool, bool> status=leaf_checker(id, leaves_spheres_[id]);
+		if(status.first)
+		{
+			results.push_back(id);
+			return status.second;
+		}
+		return false;
+	}
+
+	template<bool filtered, typename NodeChecker, typename LeafChecker>
+	std::vector<std::size_t> search_in_layers(NodeChecker& node_checker, LeafChecker& leaf_checker) const
+	{
+		std::vector<std::size_t> results;
+		if(!clusters_layers_.empty())
+		{
+			std::vector<NodeCoordinates> stack;
+			stack.reserve(clusters_layers_.back().size()+clusters_layers_.size()+1);
+			{
+				const std::size_t top_level=clusters_layers_.size()-1;
+				for(std::size_t top_id=0;top_id<clusters_layers_[top_level].size();top_id++)
+				{
+					stack.push_back(NodeCoordinates(top_level, top_id, 0));
+				}
+			}
+			while(!stack.empty())
+			{
+				const NodeCoordinates ncs=stack.back();
+				if(
+						ncs.level_id<clusters_layers_.size()
+						&& ncs.cluster_id<clusters_layers_[ncs.level_id].size()
+						&& ncs.child_id<clusters_layers_[ncs.level_id][ncs.cluster_id].children.size()
+						&& (ncs.child_id>0 || node_checker(clusters_layers_[ncs.level_id][ncs.cluster_id]))
+					)
+				{
+					const std::vector<std::size_t>& children=clusters_layers_[ncs.level_id][ncs.cluster_id].children;
+					if(ncs.level_id==0)
+					{
+						if(check_leaves(ncs.cluster_id, children, leaf_checker, results, LeavesFilteringTag<filtered>()))
+						{
+							return results;
+						}
+						stack.pop_back();
+					}
+					else
+					{
+						stack.back().child_id++;
+						stack.push_back(NodeCoordinates(ncs.level_id-1, children[ncs.child_id], 0));
+					}
+				}
+				else
+				{
+					stack.pop_back();
+				}
+			}
+		}
+		return results;
+	}
+
 	template<typename InputSphereType>
 	static std::vector<SimpleSphere> convert_input_spheres_to_simple_spheres(const std::vector<InputSphereType>& input_spheres)
 	{
@@ -336,6 +472,7 @@ private:
 	std::vector<SimpleSphere> leaves_spheres_;
 	std::pair<double, double> input_radii_range_;
 	std::vector< std::vector<Cluster> > clusters_layers_;
+	LeavesBlocks leaves_blocks_;
 };
 
 }
@@ -0,0 +1,129 @@
+#ifndef APOLLOTA_COMPRESSED_NEIGHBORS_GRAPH_H_
+#define APOLLOTA_COMPRESSED_NEIGHBORS_GRAPH_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "tuple.h"
+
+namespace apollota
+{
+
+class NeighborsRange
+{
+public:
+	typedef const std::size_t* const_iterator;
+
+	NeighborsRange(const_iterator begin, const_iterator end) : begin_(begin), end_(end)
+	{
+	}
+
+	const_iterator begin() const
+	{
+		return begin_;
+	}
+
+	const_iterator end() const
+	{
+		return end_;
+	}
+
+	std::size_t size() const
+	{
+		return static_cast<std::size_t>(end_-begin_);
+	}
+
+	bool empty() const
+	{
+		return (begin_==end_);
+	}
+
+	std::size_t operator[](const std::size_t i) const
+	{
+		return begin_[i];
+	}
+
+	bool operator==(const NeighborsRange& r) const
+	{
+		return (size()==r.size() && std::equal(begin_, end_, r.begin_));
+	}
+
+	bool operator!=(const NeighborsRange& r) const
+	{
+		return !((*this)==r);
+	}
+
+private:
+	const_iterator begin_;
+	const_iterator end_;
+};
+
+// Compressed sparse rows: the neighbors of the vertex i are stored in ids from offsets[i] to offsets[i+1]
+struct CompressedNeighborsGraph
+{
+	std::vector<std::size_t> offsets;
+	std::vector<std::size_t> ids;
+
+	CompressedNeighborsGraph() : offsets(1, 0)
+	{
+	}
+
+	std::size_t size() const
+	{
+		return (offsets.size()-1);
+	}
+
+	std::size_t count_neighbors(const std::size_t i) const
+	{
+		return (offsets[i+1]-offsets[i]);
+	}
+
+	NeighborsRange neighbors(const std::size_t i) const
+	{
+		const std::size_t* data=(ids.empty() ? 0 : &ids[0]);
+		return NeighborsRange(data+offsets[i], data+offsets[i+1]);
+	}
+
+	void sort_and_remove_duplicates_in_rows(const std::size_t number_of_threads)
+	{
+		const int rows_count=static_cast<int>(size());
+		std::vector<std::size_t> sizes(size(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic, 256)
+#else
+		static_cast<void>(number_of_threads);
+#endif
+		for(int i=0;i<rows_count;i++)
+		{
+			std::vector<std::size_t>::iterator row_begin=ids.begin()+offsets[i];
+			std::vector<std::size_t>::iterator row_end=ids.begin()+offsets[i+1];
+			std::sort(row_begin, row_end);
+			sizes[i]=static_cast<std::size_t>(std::unique(row_begin, row_end)-row_begin);
+		}
+		std::size_t position=0;
+		for(std::size_t i=0;i<sizes.size();i++)
+		{
+			const std::size_t row_begin=offsets[i];
+			offsets[i]=position;
+			if(position!=row_begin)
+			{
+				std::copy(ids.begin()+row_begin, ids.begin()+row_begin+sizes[i], ids.begin()+position);
+			}
+			position+=sizes[i];
+		}
+		offsets.back()=position;
+		ids.resize(position);
+	}
+};
+
+// Edges list of the neighbors graph (pairs with the first id less than the second),
+// and for every pair, the compressed rows of the ids that form quadruples with it
+struct CompressedPairsNeighbors
+{
+	std::vector<Pair> pairs;
+	CompressedNeighborsGraph pairs_neighbors;
+};
+
+}
+
+#endif /* APOLLOTA_COMPRESSED_NEIGHBORS_GRAPH_H_ */
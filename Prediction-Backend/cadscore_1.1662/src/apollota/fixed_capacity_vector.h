@@ -0,0 +1,116 @@
+#ifndef APOLLOTA_FIXED_CAPACITY_VECTOR_H_
+#define APOLLOTA_FIXED_CAPACITY_VECTOR_H_
+
+#include <vector>
+#include <stdexcept>
+
+namespace apollota
+{
+
+template<typename T, std::size_t N>
+class FixedCapacityVector
+{
+public:
+	typedef T value_type;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	FixedCapacityVector() : size_(0)
+	{
+	}
+
+	FixedCapacityVector(const std::vector<T>& values) : size_(0)
+	{
+		for(std::size_t i=0;i<values.size();i++)
+		{
+			push_back(values[i]);
+		}
+	}
+
+	std::size_t size() const
+	{
+		return size_;
+	}
+
+	bool empty() const
+	{
+		return (size_==0);
+	}
+
+	static std::size_t capacity()
+	{
+		return N;
+	}
+
+	void push_back(const T& value)
+	{
+		if(size_>=N)
+		{
+			throw std::runtime_error("Fixed capacity vector overflow");
+		}
+		values_[size_++]=value;
+	}
+
+	void clear()
+	{
+		size_=0;
+	}
+
+	T& operator[](const std::size_t i)
+	{
+		return values_[i];
+	}
+
+	const T& operator[](const std::size_t i) const
+	{
+		return values_[i];
+	}
+
+	T& front()
+	{
+		return values_[0];
+	}
+
+	const T& front() const
+	{
+		return values_[0];
+	}
+
+	T& back()
+	{
+		return values_[size_-1];
+	}
+
+	const T& back() const
+	{
+		return values_[size_-1];
+	}
+
+	iterator begin()
+	{
+		return values_;
+	}
+
+	const_iterator begin() const
+	{
+		return values_;
+	}
+
+	iterator end()
+	{
+		return (values_+size_);
+	}
+
+	const_iterator end() const
+	{
+		return (values_+size_);
+	}
+
+private:
+	std::size_t size_;
+	T values_[N];
+};
+
+}
+
+#endif /* APOLLOTA_FIXED_CAPACITY_VECTOR_H_ */
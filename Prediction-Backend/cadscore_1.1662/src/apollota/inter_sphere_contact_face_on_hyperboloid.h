@@ -1,9 +1,7 @@
 #ifndef APOLLOTA_INTER_SPHERE_CONTACT_FACE_ON_HYPERBOLOID_H_
 #define APOLLOTA_INTER_SPHERE_CONTACT_FACE_ON_HYPERBOLOID_H_
 
-#include <list>
 #include <vector>
-#include <deque>
 
 #include "basic_operations_on_spheres.h"
 #include "hyperboloid_between_two_spheres.h"
@@ -20,14 +18,61 @@ public:
 	{
 	}
 
+	// Working storage of the face construction, can be reused to avoid allocations when constructing many faces
+	class ConstructionBuffers
+	{
+	public:
+		ConstructionBuffers()
+		{
+		}
+
+	private:
+		friend class InterSphereContactFaceOnHyperboloid;
+
+		struct ContourIntersection
+		{
+			SimplePoint point;
+			std::size_t left_id;
+			bool right_halfspace;
+			std::size_t position;
+
+			ContourIntersection(const SimplePoint& point, const std::size_t left_id, const bool right_halfspace) : point(point), left_id(left_id), right_halfspace(right_halfspace), position(0)
+			{
+			}
+		};
+
+		std::vector<SimplePoint> contour;
+		std::vector<SimplePoint> updated_contour;
+		std::vector<SimplePoint> extended_contour;
+		std::vector<bool> halfspaces;
+		std::vector<ContourIntersection> intersections;
+		std::vector<std::size_t> intersections_order;
+		std::vector<bool> removed;
+		std::vector<int> closed_pairs;
+	};
+
 	template<typename SphereType>
 	static InterSphereContactFaceOnHyperboloid construct(
 			const SphereType& a,
 			const SphereType& b,
-			std::vector<const SphereType*> list_of_c,
+			const std::vector<const SphereType*>& list_of_c,
 			const double probe,
 			const double step,
 			const int projections)
+	{
+		ConstructionBuffers buffers;
+		return construct(a, b, list_of_c, probe, step, projections, buffers);
+	}
+
+	template<typename SphereType>
+	static InterSphereContactFaceOnHyperboloid construct(
+			const SphereType& a,
+			const SphereType& b,
+			const std::vector<const SphereType*>& list_of_c,
+			const double probe,
+			const double step,
+			const int projections,
+			ConstructionBuffers& buffers)
 	{
 		InterSphereContactFaceOnHyperboloid hcf;
 		hcf.s1_=custom_sphere_from_object<SimpleSphere>(a);
@@ -37,7 +82,7 @@ public:
 		if(sphere_intersects_sphere(a_expanded, b_expanded))
 		{
 			hcf.intersection_circle_=spheres_intersection_circle<SimpleSphere>(a_expanded, b_expanded);
-			std::list<SimplePoint> contour;
+			std::vector<SimplePoint>& contour=buffers.contour;
 			bool rerun=false;
 			double using_step=step;
 			for(int j=0;j<9 && (j==0 || rerun);j++)
@@ -59,16 +104,16 @@ public:
 				rerun=false;
 				for(std::size_t i=0;i<list_of_c.size() && !contour.empty();i++)
 				{
-					std::size_t intersections_count=update_contour(a, b, (*(list_of_c[i])), using_step, projections, contour);
+					std::size_t intersections_count=update_contour(a, b, (*(list_of_c[i])), using_step, projections, buffers);
 					if(j>=3 && intersections_count>0 && (intersections_count%2)!=0)
 					{
-						for(std::list<SimplePoint>::iterator it=contour.begin();it!=contour.end();++it)
+						for(std::vector<SimplePoint>::iterator it=contour.begin();it!=contour.end();++it)
 						{
 							const double delta=0.00001*j;
 							double* coord_ptr=(j%3==0 ? &(it->x) : (j%3==1 ? &(it->y) : &(it->z)));
 							(*coord_ptr)+=delta;
 						}
-						intersections_count=update_contour(a, b, (*(list_of_c[i])), using_step, projections, contour);
+						intersections_count=update_contour(a, b, (*(list_of_c[i])), using_step, projections, buffers);
 					}
 					if(intersections_count>0 && (intersections_count%2)!=0)
 					{
@@ -84,11 +129,7 @@ public:
 			}
 			if(!contour.empty())
 			{
-				hcf.contour_points_.reserve(contour.size());
-				for(std::list<SimplePoint>::const_iterator it=contour.begin();it!=contour.end();++it)
-				{
-					hcf.contour_points_.push_back(*it);
-				}
+				hcf.contour_points_=contour;
 				init_mesh(hcf.contour_points_, hcf.mesh_vertices_, hcf.mesh_triples_);
 			}
 		}
@@ -149,6 +190,8 @@ private:
 		return custom_sphere_from_point<OutputSphereType>(ap+(cv.unit()*(a.r*cos_g)), a.r*sin_g);
 	}
 
+	// The contour is a closed sequence of points stored in buffers.contour,
+	// it is rebuilt into buffers.updated_contour and the two vectors are swapped
 	template<typename SphereType>
 	static std::size_t update_contour(
 			const SphereType& a,
@@ -156,8 +199,10 @@ private:
 			const SphereType& c,
 			const double step,
 			const int projections,
-			std::list<SimplePoint>& contour)
+			ConstructionBuffers& buffers)
 	{
+		std::vector<SimplePoint>& contour=buffers.contour;
+
 		if(contour.empty())
 		{
 			return 0;
@@ -165,7 +210,7 @@ private:
 
 		std::size_t out_count=0;
 		{
-			for(std::list<SimplePoint>::const_iterator it=contour.begin();it!=contour.end();++it)
+			for(std::vector<SimplePoint>::const_iterator it=contour.begin();it!=contour.end();++it)
 			{
 				if(less(minimal_distance_from_point_to_sphere(*it, c), minimal_distance_from_point_to_sphere(*it, a)))
 				{
@@ -184,63 +229,82 @@ private:
 			return 0;
 		}
 
-		std::deque< std::pair<std::list<SimplePoint>::iterator, bool> > intersection_iterators;
+		const std::size_t n=contour.size();
+
+		std::vector<bool>& halfspaces=buffers.halfspaces;
+		halfspaces.resize(n);
+		for(std::size_t i=0;i<n;i++)
 		{
-			std::list<SimplePoint>::iterator left_it=contour.begin();
-			while(left_it!=contour.end())
+			halfspaces[i]=minimal_distance_from_point_to_sphere(contour[i], c)<minimal_distance_from_point_to_sphere(contour[i], a);
+		}
+
+		std::vector<ConstructionBuffers::ContourIntersection>& intersections=buffers.intersections;
+		intersections.clear();
+		for(std::size_t i=0;i<n;i++)
+		{
+			const std::size_t i_next=(i+1<n ? i+1 : 0);
+			if(halfspaces[i]!=halfspaces[i_next])
 			{
-				std::list<SimplePoint>::iterator right_it=left_it;
-				++right_it;
-				bool right_it_was_on_end=false;
-				if(right_it==contour.end())
-				{
-					right_it_was_on_end=true;
-					right_it=contour.begin();
-				}
-				const SimplePoint& left_point=*left_it;
-				const SimplePoint& right_point=*right_it;
-				const bool left_halfspace=minimal_distance_from_point_to_sphere(left_point, c)<minimal_distance_from_point_to_sphere(left_point, a);
-				const bool right_halfspace=minimal_distance_from_point_to_sphere(right_point, c)<minimal_distance_from_point_to_sphere(right_point, a);
-				if(left_halfspace!=right_halfspace)
+				const SimplePoint& left_point=contour[i];
+				const SimplePoint& right_point=contour[i_next];
+				const double pos=HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(left_point, right_point, a, c);
+				if(pos>0.0)
 				{
-					const double pos=HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(left_point, right_point, a, c);
-					if(pos>0.0)
-					{
-						const SimplePoint intersection_point=left_point+((right_point-left_point).unit()*pos);
-						std::list<SimplePoint>::iterator intersection_iterator=contour.insert(right_it, intersection_point);
-						intersection_iterators.push_back(std::make_pair(intersection_iterator, right_halfspace));
-					}
-				}
-				if(right_it_was_on_end)
-				{
-					left_it=contour.end();
+					intersections.push_back(ConstructionBuffers::ContourIntersection(left_point+((right_point-left_point).unit()*pos), i, halfspaces[i_next]));
 				}
-				else
+			}
+		}
+
+		// The intersection point after the last contour point goes to the beginning of the contour
+		std::vector<SimplePoint>& extended_contour=buffers.extended_contour;
+		extended_contour.clear();
+		const bool wrapping_intersection=(!intersections.empty() && intersections.back().left_id+1==n);
+		if(wrapping_intersection)
+		{
+			intersections.back().position=extended_contour.size();
+			extended_contour.push_back(intersections.back().point);
+		}
+		{
+			std::size_t k=0;
+			for(std::size_t i=0;i<n;i++)
+			{
+				extended_contour.push_back(contour[i]);
+				if(k<intersections.size() && intersections[k].left_id==i && i+1<n)
 				{
-					left_it=right_it;
+					intersections[k].position=extended_contour.size();
+					extended_contour.push_back(intersections[k].point);
+					k++;
 				}
 			}
 		}
 
-		if(intersection_iterators.size()>0 && intersection_iterators.size()%2==0)
+		const std::size_t m=extended_contour.size();
+		bool valid_sequence=false;
+		std::vector<std::size_t>& order=buffers.intersections_order;
+		order.clear();
+
+		if(intersections.size()>0 && intersections.size()%2==0)
 		{
-			if(!intersection_iterators.front().second)
+			if(!intersections.front().right_halfspace)
 			{
-				intersection_iterators.push_front(intersection_iterators.back());
-				intersection_iterators.pop_back();
+				order.push_back(intersections.size()-1);
+			}
+			for(std::size_t k=0;order.size()<intersections.size();k++)
+			{
+				order.push_back(k);
 			}
 
-			bool valid_sequence=true;
-			for(std::size_t k=0;k<intersection_iterators.size() && valid_sequence;k+=2)
+			valid_sequence=true;
+			for(std::size_t k=0;k<order.size() && valid_sequence;k+=2)
 			{
-				valid_sequence=valid_sequence && (intersection_iterators[k].second && !intersection_iterators[k+1].second);
+				valid_sequence=valid_sequence && (intersections[order[k]].right_halfspace && !intersections[order[k+1]].right_halfspace);
 			}
 
 			if(valid_sequence)
 			{
-				for(std::size_t j=0;j<intersection_iterators.size();j++)
+				for(std::size_t k=0;k<order.size();k++)
 				{
-					SimplePoint& point=*(intersection_iterators[j].first);
+					SimplePoint& point=extended_contour[intersections[order[k]].position];
 					for(int i=0;i<projections;i++)
 					{
 						point=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(point, b, c);
@@ -249,49 +313,59 @@ private:
 					}
 				}
 
-				for(std::size_t k=0;k<intersection_iterators.size();k+=2)
+				buffers.removed.assign(m, false);
+				buffers.closed_pairs.assign(m, -1);
+				for(std::size_t k=0;k<order.size();k+=2)
 				{
-					std::list<SimplePoint>::iterator first_intersection=intersection_iterators[k].first;
-					std::list<SimplePoint>::iterator second_intersection=intersection_iterators[k+1].first;
-
+					const std::size_t first_position=intersections[order[k]].position;
+					const std::size_t second_position=intersections[order[k+1]].position;
+					for(std::size_t p=(first_position+1)%m;p!=second_position;p=(p+1)%m)
 					{
-						std::list<SimplePoint>::iterator it=first_intersection;
-						++it;
-						while(it!=second_intersection && it!=contour.end())
-						{
-							it=contour.erase(it);
-						}
-						if(it!=second_intersection)
-						{
-							it=contour.begin();
-							while(it!=second_intersection && it!=contour.end())
-							{
-								it=contour.erase(it);
-							}
-						}
+						buffers.removed[p]=true;
 					}
+					buffers.closed_pairs[second_position]=static_cast<int>(k);
+				}
+			}
+		}
 
+		std::vector<SimplePoint>& updated_contour=buffers.updated_contour;
+		updated_contour.clear();
+		if(!valid_sequence)
+		{
+			updated_contour.swap(extended_contour);
+		}
+		else
+		{
+			for(std::size_t p=0;p<m;p++)
+			{
+				if(!buffers.removed[p])
+				{
+					if(buffers.closed_pairs[p]>=0)
 					{
-						const SimplePoint& left_point=*(first_intersection);
-						const SimplePoint& right_point=*(second_intersection);
+						const std::size_t k=static_cast<std::size_t>(buffers.closed_pairs[p]);
+						const SimplePoint& left_point=extended_contour[intersections[order[k]].position];
+						const SimplePoint& right_point=extended_contour[intersections[order[k+1]].position];
 						const double distance=distance_from_point_to_point(left_point, right_point);
 						const SimplePoint direction=(right_point-left_point).unit();
 						for(double pos=step;pos<distance;pos+=step)
 						{
-							SimplePoint p=left_point+(direction*pos);
+							SimplePoint point=left_point+(direction*pos);
 							for(int i=0;i<projections;i++)
 							{
-								p=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(p, a, c);
-								p=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(p, a, b);
-								p=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(p, b, c);
+								point=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(point, a, c);
+								point=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(point, a, b);
+								point=HyperboloidBetweenTwoSpheres::project_point_on_hyperboloid(point, b, c);
 							}
-							contour.insert(second_intersection, p);
+							updated_contour.push_back(point);
 						}
 					}
+					updated_contour.push_back(extended_contour[p]);
 				}
 			}
 		}
-		return intersection_iterators.size();
+		contour.swap(updated_contour);
+
+		return intersections.size();
 	}
 
 	static void init_mesh(
@@ -2,11 +2,16 @@
 #define APOLLOTA_INTER_SPHERE_CONTACT_SURFACE_ON_SPHERE_H_
 
 #include <vector>
+#include <utility>
+#include <algorithm>
 #include <map>
+#include <limits>
 
 #include "basic_operations_on_spheres.h"
 #include "subdivided_icosahedron.h"
 #include "hyperboloid_between_two_spheres.h"
+#include "spatial_ordering_of_spheres.h"
+#include "compressed_neighbors_graph.h"
 
 namespace apollota
 {
@@ -14,16 +19,94 @@ namespace apollota
 class InterSphereContactSurfaceOnSphere
 {
 public:
-	typedef std::map<std::size_t, double> SurfaceArea;
+	typedef std::vector< std::pair<std::size_t, double> > SurfaceArea;
 
 	template<typename SphereType>
 	static std::vector<SurfaceArea> calculate_surface_areas(
 			const std::vector<SphereType>& spheres,
-			const std::vector< std::vector<std::size_t> >& graph,
+			const CompressedNeighborsGraph& graph,
 			const std::size_t subdivision_depth,
-			const double probe_radius)
+			const double probe_radius,
+			const std::size_t number_of_threads=1,
+			const bool spatial_ordering=false)
 	{
-		return construct_surfaces<SurfaceAreaOutputFunctor>(spheres, graph, subdivision_depth, probe_radius);
+		return construct_surfaces<SurfaceAreaOutputFunctor>(spheres, graph, subdivision_depth, probe_radius, number_of_threads, spatial_ordering);
+	}
+
+	template<typename SphereType>
+	static void update_surface_areas(
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const std::size_t subdivision_depth,
+			const double probe_radius,
+			const std::vector<std::size_t>& ids_to_update,
+			std::vector<SurfaceArea>& surface_areas)
+	{
+		const SubdividedIcosahedron& unit_sih=SubdividedIcosahedron::unit_icosahedron(subdivision_depth);
+		Workspace workspace;
+		surface_areas.resize(spheres.size());
+		for(std::size_t i=0;i<ids_to_update.size();i++)
+		{
+			if(ids_to_update[i]<spheres.size())
+			{
+				construct_surface_of_sphere<SurfaceAreaOutputFunctor>(unit_sih, spheres, graph, probe_radius, ids_to_update[i], workspace, surface_areas[ids_to_update[i]]);
+			}
+		}
+	}
+
+	// Starts from the coarse subdivision depth and subdivides only the triangles that cross or approach the borders between neighbors,
+	// the other triangles get the summed areas of their descendants at the maximal depth
+	template<typename SphereType>
+	static std::vector<SurfaceArea> calculate_surface_areas_adaptively(
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const std::size_t coarse_subdivision_depth,
+			const std::size_t max_subdivision_depth,
+			const double probe_radius,
+			const std::size_t number_of_threads=1)
+	{
+		std::vector<SurfaceArea> surface_areas(spheres.size());
+		const AdaptiveSubdivision& subdivision=AdaptiveSubdivision::get(coarse_subdivision_depth, max_subdivision_depth);
+		const std::size_t block_size=64;
+		const int blocks_count=static_cast<int>((spheres.size()+block_size-1)/block_size);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#else
+		static_cast<void>(number_of_threads);
+#endif
+		for(int i=0;i<blocks_count;i++)
+		{
+			AdaptiveWorkspace workspace(subdivision);
+			const std::size_t begin=static_cast<std::size_t>(i)*block_size;
+			const std::size_t end=std::min(begin+block_size, spheres.size());
+			for(std::size_t id=begin;id<end;id++)
+			{
+				construct_surface_of_sphere_adaptively(subdivision, spheres, graph, probe_radius, id, workspace, surface_areas[id]);
+			}
+		}
+		return surface_areas;
+	}
+
+	template<typename SphereType>
+	static void update_surface_areas_adaptively(
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const std::size_t coarse_subdivision_depth,
+			const std::size_t max_subdivision_depth,
+			const double probe_radius,
+			const std::vector<std::size_t>& ids_to_update,
+			std::vector<SurfaceArea>& surface_areas)
+	{
+		const AdaptiveSubdivision& subdivision=AdaptiveSubdivision::get(coarse_subdivision_depth, max_subdivision_depth);
+		AdaptiveWorkspace workspace(subdivision);
+		surface_areas.resize(spheres.size());
+		for(std::size_t i=0;i<ids_to_update.size();i++)
+		{
+			if(ids_to_update[i]<spheres.size())
+			{
+				construct_surface_of_sphere_adaptively(subdivision, spheres, graph, probe_radius, ids_to_update[i], workspace, surface_areas[ids_to_update[i]]);
+			}
+		}
 	}
 
 	template<typename SphereType>
@@ -68,126 +151,476 @@ private:
 
 		void operator()(const std::size_t id, const SimplePoint& a, const SimplePoint& b, const SimplePoint& c)
 		{
-			result[id]+=triangle_area(a, b, c);
+			(*this)(id, triangle_area(a, b, c));
+		}
+
+		void operator()(const std::size_t id, const double area)
+		{
+			for(ResultType::iterator it=result.begin();it!=result.end();++it)
+			{
+				if(it->first==id)
+				{
+					it->second+=area;
+					return;
+				}
+			}
+			result.push_back(std::make_pair(id, area));
+		}
+
+		void finalize()
+		{
+			std::sort(result.begin(), result.end());
 		}
 	};
 
-	template<typename OutputFunctor, typename SphereType>
-	static std::vector<typename OutputFunctor::ResultType> construct_surfaces(
+	// Coordinates of the sphere (that goes first) and its neighbours in separate arrays, so that the distances to all of them are calculated in one simple loop
+	struct InfluenceSearch
+	{
+		std::vector<std::size_t> ids;
+		std::vector<double> x;
+		std::vector<double> y;
+		std::vector<double> z;
+		std::vector<double> r;
+		std::vector<double> distances;
+
+		template<typename SphereType>
+		void init(const std::vector<SphereType>& spheres, const std::size_t self_id, const NeighborsRange& neighbours)
+		{
+			const std::size_t n=neighbours.size()+1;
+			ids.resize(n);
+			x.resize(n);
+			y.resize(n);
+			z.resize(n);
+			r.resize(n);
+			distances.resize(n);
+			for(std::size_t i=0;i<n;i++)
+			{
+				const std::size_t id=(i==0 ? self_id : neighbours[i-1]);
+				const SphereType& sphere=spheres[id];
+				ids[i]=id;
+				x[i]=sphere.x;
+				y[i]=sphere.y;
+				z[i]=sphere.z;
+				r[i]=sphere.r;
+			}
+		}
+
+		// The margin is the difference between the two smallest distances
+		void find(const SimplePoint& point, std::size_t& influence, double& margin)
+		{
+			const int n=static_cast<int>(ids.size());
+			const double* xs=&x[0];
+			const double* ys=&y[0];
+			const double* zs=&z[0];
+			const double* rs=&r[0];
+			double* ds=&distances[0];
+			for(int i=0;i<n;i++)
+			{
+				const double dx=point.x-xs[i];
+				const double dy=point.y-ys[i];
+				const double dz=point.z-zs[i];
+				ds[i]=sqrt(dx*dx+dy*dy+dz*dz)-rs[i];
+			}
+			int best=0;
+			double min_distance=ds[0];
+			double second_min_distance=std::numeric_limits<double>::max();
+			for(int i=1;i<n;i++)
+			{
+				if(ds[i]<min_distance)
+				{
+					second_min_distance=min_distance;
+					min_distance=ds[i];
+					best=i;
+				}
+				else if(ds[i]<second_min_distance)
+				{
+					second_min_distance=ds[i];
+				}
+			}
+			influence=ids[best];
+			margin=second_min_distance-min_distance;
+		}
+	};
+
+	struct Workspace
+	{
+		std::vector<SimplePoint> vertices;
+		std::vector<std::size_t> influences;
+		std::vector<double> margins;
+		InfluenceSearch influence_search;
+	};
+
+	// Triangles of the subdivided icosahedron at every depth from the coarse to the maximal one,
+	// the children of the triangle i are the triangles from 4i to 4i+3 of the next depth, and the vertices of all depths share ids
+	struct AdaptiveSubdivision
+	{
+		const std::vector<SimplePoint>* vertices;
+		const std::vector<Pair>* vertices_parents;
+		std::vector<const std::vector<Triple>*> levels;
+		// Every point of a triangle patch is within the covering radius of the level from some vertex, and the difference of the distances to two spheres
+		// changes not faster than twice the distance between points, so vertices of one influence with margins above twice the covering radius
+		// guarantee that the whole patch has this influence
+		std::vector<double> covering_radii;
+		std::vector< std::vector<double> > leaves_areas;
+
+		AdaptiveSubdivision(const std::size_t coarse_depth, const std::size_t max_depth)
+		{
+			for(std::size_t depth=coarse_depth;depth<=max_depth;depth++)
+			{
+				const SubdividedIcosahedron& sih=SubdividedIcosahedron::unit_icosahedron(depth);
+				levels.push_back(&sih.triples());
+				double covering_radius=0.0;
+				for(std::size_t i=0;i<sih.triples().size();i++)
+				{
+					const Triple& t=sih.triples()[i];
+					covering_radius=std::max(covering_radius, calc_covering_radius(sih.vertices()[t.get(0)], sih.vertices()[t.get(1)], sih.vertices()[t.get(2)]));
+				}
+				covering_radii.push_back(covering_radius);
+			}
+			vertices=&SubdividedIcosahedron::unit_icosahedron(max_depth).vertices();
+			vertices_parents=&SubdividedIcosahedron::unit_icosahedron(max_depth).vertices_parents();
+			leaves_areas.resize(levels.size());
+			for(std::size_t l=levels.size();l>0;l--)
+			{
+				const std::vector<Triple>& triples=*levels[l-1];
+				std::vector<double>& areas=leaves_areas[l-1];
+				areas.resize(triples.size(), 0.0);
+				for(std::size_t i=0;i<triples.size();i++)
+				{
+					if(l==levels.size())
+					{
+						areas[i]=triangle_area((*vertices)[triples[i].get(0)], (*vertices)[triples[i].get(1)], (*vertices)[triples[i].get(2)]);
+					}
+					else
+					{
+						const std::vector<double>& children_areas=leaves_areas[l];
+						areas[i]=children_areas[i*4]+children_areas[i*4+1]+children_areas[i*4+2]+children_areas[i*4+3];
+					}
+				}
+			}
+		}
+
+		// If the triangle contains the center of its circumscribed circle on the sphere, the farthest point from the vertices is that center,
+		// otherwise the longest edge is used as a looser bound
+		static double calc_covering_radius(const SimplePoint& a, const SimplePoint& b, const SimplePoint& c)
+		{
+			const double longest_edge=std::max(distance_from_point_to_point(a, b), std::max(distance_from_point_to_point(b, c), distance_from_point_to_point(c, a)));
+			SimplePoint o=unit_point<SimplePoint>((b-a)&(c-a));
+			if((o*a)<0.0)
+			{
+				o=o*(-1.0);
+			}
+			const double sab=((a&b)*o);
+			const double sbc=((b&c)*o);
+			const double sca=((c&a)*o);
+			if((sab>=0.0 && sbc>=0.0 && sca>=0.0) || (sab<=0.0 && sbc<=0.0 && sca<=0.0))
+			{
+				return std::min(longest_edge, std::max(distance_from_point_to_point(o, a), std::max(distance_from_point_to_point(o, b), distance_from_point_to_point(o, c))));
+			}
+			return longest_edge;
+		}
+
+		static const AdaptiveSubdivision& get(const std::size_t coarse_depth, const std::size_t max_depth)
+		{
+			static std::map<Pair, AdaptiveSubdivision> cache;
+			const AdaptiveSubdivision* result=0;
+#ifdef _OPENMP
+#pragma omp critical(InterSphereContactSurfaceOnSphere_AdaptiveSubdivision_get)
+#endif
+			{
+				const Pair key(coarse_depth, std::max(coarse_depth, max_depth));
+				std::map<Pair, AdaptiveSubdivision>::iterator it=cache.find(key);
+				if(it==cache.end())
+				{
+					it=cache.insert(std::make_pair(key, AdaptiveSubdivision(key.get(0), key.get(1)))).first;
+				}
+				result=&(it->second);
+			}
+			return (*result);
+		}
+	};
+
+	// Vertices are fitted and classified only when some triangle needs them, stamps mark the ones already done for the current sphere
+	struct AdaptiveWorkspace : public Workspace
+	{
+		std::vector<unsigned int> stamps;
+		unsigned int stamp;
+
+		explicit AdaptiveWorkspace(const AdaptiveSubdivision& subdivision) :
+			stamps(subdivision.vertices->size(), 0),
+			stamp(0)
+		{
+			vertices.resize(subdivision.vertices->size());
+			influences.resize(subdivision.vertices->size(), 0);
+			margins.resize(subdivision.vertices->size(), 0.0);
+		}
+	};
+
+	template<typename SphereType>
+	static void construct_surface_of_sphere_adaptively(
+			const AdaptiveSubdivision& subdivision,
 			const std::vector<SphereType>& spheres,
-			const std::vector< std::vector<std::size_t> >& graph,
-			const std::size_t subdivision_depth,
-			const double probe_radius)
-	{
-		std::vector<typename OutputFunctor::ResultType> surfaces;
-		SubdividedIcosahedron sih(subdivision_depth);
-		surfaces.reserve(graph.size());
-		for(std::size_t i=0;i<spheres.size();i++)
-		{
-			sih.fit_into_sphere(spheres[i], spheres[i].r+probe_radius);
-			OutputFunctor output_functor;
-			construct_surface(
-					sih,
-					spheres,
-					collect_influences(sih, spheres, i, graph[i]),
-					output_functor);
-			surfaces.push_back(output_functor.result);
+			const CompressedNeighborsGraph& graph,
+			const double probe_radius,
+			const std::size_t id,
+			AdaptiveWorkspace& workspace,
+			SurfaceArea& surface)
+	{
+		workspace.stamp++;
+		if(workspace.stamp==0)
+		{
+			std::fill(workspace.stamps.begin(), workspace.stamps.end(), 0);
+			workspace.stamp=1;
 		}
-		return surfaces;
+		const double radius=spheres[id].r+probe_radius;
+		const NeighborsRange neighbours=graph.neighbors(id);
+		workspace.influence_search.init(spheres, id, neighbours);
+		SurfaceAreaOutputFunctor output_functor;
+		output_functor.result.reserve(neighbours.size()+1);
+		const std::vector<Triple>& coarse_triples=*subdivision.levels.front();
+		for(std::size_t i=0;i<coarse_triples.size();i++)
+		{
+			refine_triangle(subdivision, spheres, id, radius, 0, i, workspace, output_functor);
+		}
+		output_functor.finalize();
+		std::swap(surface, output_functor.result);
 	}
 
 	template<typename SphereType>
-	static std::vector<std::size_t> collect_influences(
-			const SubdividedIcosahedron& sih,
+	static void refine_triangle(
+			const AdaptiveSubdivision& subdivision,
 			const std::vector<SphereType>& spheres,
 			const std::size_t self_id,
-			const std::vector<size_t>& neighbours)
+			const double radius,
+			const std::size_t level,
+			const std::size_t triple_id,
+			AdaptiveWorkspace& workspace,
+			SurfaceAreaOutputFunctor& output_functor)
+	{
+		const Triple& triple=(*subdivision.levels[level])[triple_id];
+		for(int j=0;j<3;j++)
+		{
+			const std::size_t v=triple.get(j);
+			if(workspace.stamps[v]!=workspace.stamp)
+			{
+				const SimplePoint& unit_vertex=(*subdivision.vertices)[v];
+				const SphereType& self=spheres[self_id];
+				workspace.vertices[v]=SimplePoint(self.x+unit_vertex.x*radius, self.y+unit_vertex.y*radius, self.z+unit_vertex.z*radius);
+				// Parents from the depths below the coarse one, or from not refined triangles, still hold the values of some previous sphere
+				const Pair& parents=(*subdivision.vertices_parents)[v];
+				const std::size_t p0=(workspace.stamps[parents.get(0)]==workspace.stamp ? parents.get(0) : v);
+				const std::size_t p1=(workspace.stamps[parents.get(1)]==workspace.stamp ? parents.get(1) : v);
+				assign_influence(v, Pair(p0, p1), workspace);
+				workspace.stamps[v]=workspace.stamp;
+			}
+		}
+		const std::size_t a=triple.get(0);
+		const std::size_t b=triple.get(1);
+		const std::size_t c=triple.get(2);
+		if(level+1==subdivision.levels.size())
+		{
+			construct_surface_of_triangle(workspace.vertices, triple, spheres, workspace.influences, output_functor);
+		}
+		else if(workspace.influences[a]==workspace.influences[b] && workspace.influences[a]==workspace.influences[c]
+				&& std::min(workspace.margins[a], std::min(workspace.margins[b], workspace.margins[c]))>2.0*subdivision.covering_radii[level]*radius)
+		{
+			output_functor(workspace.influences[a], subdivision.leaves_areas[level][triple_id]*radius*radius);
+		}
+		else
+		{
+			for(std::size_t i=triple_id*4;i<triple_id*4+4;i++)
+			{
+				refine_triangle(subdivision, spheres, self_id, radius, level+1, i, workspace, output_functor);
+			}
+		}
+	}
+
+	// The difference of the distances to two spheres changes not faster than twice the distance between points,
+	// so if the margin at a parent vertex is large enough, the child vertex has the same influence and does not need the search
+	static void assign_influence(const std::size_t v, const Pair& parents, Workspace& workspace)
 	{
-		std::vector<std::size_t> influences(sih.vertices().size());
-		for(std::size_t i=0;i<influences.size();i++)
+		for(int i=0;i<2;i++)
 		{
-			double min_distance=minimal_distance_from_point_to_sphere(sih.vertices().at(i), spheres.at(self_id));
-			influences[i]=self_id;
-			for(std::size_t j=0;j<neighbours.size();j++)
+			const std::size_t p=parents.get(i);
+			if(p!=v)
 			{
-				double distance=minimal_distance_from_point_to_sphere(sih.vertices().at(i), spheres.at(neighbours[j]));
-				if(distance<min_distance)
+				const double margin=workspace.margins[p]-2*distance_from_point_to_point(workspace.vertices[v], workspace.vertices[p]);
+				if(margin>inherited_margin_tolerance())
 				{
-					min_distance=distance;
-					influences[i]=neighbours[j];
+					workspace.influences[v]=workspace.influences[p];
+					workspace.margins[v]=margin;
+					return;
 				}
 			}
 		}
-		return influences;
+		workspace.influence_search.find(workspace.vertices[v], workspace.influences[v], workspace.margins[v]);
+	}
+
+	static double inherited_margin_tolerance()
+	{
+		return 1e-9;
+	}
+
+	template<typename OutputFunctor, typename SphereType>
+	static std::vector<typename OutputFunctor::ResultType> construct_surfaces(
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const std::size_t subdivision_depth,
+			const double probe_radius,
+			const std::size_t number_of_threads,
+			const bool spatial_ordering)
+	{
+		std::vector<typename OutputFunctor::ResultType> surfaces(spheres.size());
+		const SubdividedIcosahedron& unit_sih=SubdividedIcosahedron::unit_icosahedron(subdivision_depth);
+		const std::vector<std::size_t> processing_order=(spatial_ordering ? SpatialOrderingOfSpheres::calc_morton_order(spheres) : std::vector<std::size_t>());
+		if(number_of_threads<2)
+		{
+			construct_surfaces_in_range<OutputFunctor>(unit_sih, spheres, graph, probe_radius, processing_order, 0, spheres.size(), surfaces);
+		}
+		else
+		{
+			const std::size_t block_size=64;
+			const int blocks_count=static_cast<int>((spheres.size()+block_size-1)/block_size);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+			for(int i=0;i<blocks_count;i++)
+			{
+				const std::size_t begin=static_cast<std::size_t>(i)*block_size;
+				construct_surfaces_in_range<OutputFunctor>(unit_sih, spheres, graph, probe_radius, processing_order, begin, std::min(begin+block_size, spheres.size()), surfaces);
+			}
+		}
+		return surfaces;
+	}
+
+	template<typename OutputFunctor, typename SphereType>
+	static void construct_surfaces_in_range(
+			const SubdividedIcosahedron& unit_sih,
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const double probe_radius,
+			const std::vector<std::size_t>& processing_order,
+			const std::size_t begin,
+			const std::size_t end,
+			std::vector<typename OutputFunctor::ResultType>& surfaces)
+	{
+		Workspace workspace;
+		for(std::size_t i=begin;i<end;i++)
+		{
+			const std::size_t id=(processing_order.empty() ? i : processing_order[i]);
+			construct_surface_of_sphere<OutputFunctor>(unit_sih, spheres, graph, probe_radius, id, workspace, surfaces[id]);
+		}
+	}
+
+	template<typename OutputFunctor, typename SphereType>
+	static void construct_surface_of_sphere(
+			const SubdividedIcosahedron& unit_sih,
+			const std::vector<SphereType>& spheres,
+			const CompressedNeighborsGraph& graph,
+			const double probe_radius,
+			const std::size_t id,
+			Workspace& workspace,
+			typename OutputFunctor::ResultType& surface)
+	{
+		unit_sih.fill_vertices_fitted_into_sphere(spheres[id], spheres[id].r+probe_radius, workspace.vertices);
+		workspace.influence_search.init(spheres, id, graph.neighbors(id));
+		collect_influences(unit_sih.vertices_parents(), workspace);
+		OutputFunctor output_functor;
+		output_functor.result.reserve(graph.count_neighbors(id)+1);
+		construct_surface(workspace.vertices, unit_sih.triples(), spheres, workspace.influences, output_functor);
+		output_functor.finalize();
+		std::swap(surface, output_functor.result);
+	}
+
+	// Vertices go from coarse to fine subdivision levels, so the parents of every vertex are processed before it
+	static void collect_influences(const std::vector<Pair>& vertices_parents, Workspace& workspace)
+	{
+		workspace.influences.resize(workspace.vertices.size());
+		workspace.margins.resize(workspace.vertices.size());
+		for(std::size_t i=0;i<workspace.vertices.size();i++)
+		{
+			assign_influence(i, vertices_parents[i], workspace);
+		}
 	}
 
 	template<typename SphereType, typename OutputFunctor>
 	static void construct_surface(
-			const SubdividedIcosahedron& sih,
+			const std::vector<SimplePoint>& vertices,
+			const std::vector<Triple>& triples,
 			const std::vector<SphereType>& spheres,
 			const std::vector<std::size_t>& influences,
 			OutputFunctor& output_functor)
 	{
-		for(std::size_t e=0;e<sih.triples().size();e++)
+		for(std::size_t e=0;e<triples.size();e++)
 		{
-			const Triple& triple=sih.triples()[e];
-			const std::size_t a=triple.get(0);
-			const std::size_t b=triple.get(1);
-			const std::size_t c=triple.get(2);
-			if(influences[a]==influences[b] && influences[a]==influences[c])
-			{
-				output_functor(influences[a], sih.vertices()[a], sih.vertices()[b], sih.vertices()[c]);
-			}
-			else if(influences[a]!=influences[b] && influences[a]!=influences[c] && influences[b]!=influences[c])
-			{
-				const SimplePoint& pa=sih.vertices()[a];
-				const SimplePoint& pb=sih.vertices()[b];
-				const SimplePoint& pc=sih.vertices()[c];
+			construct_surface_of_triangle(vertices, triples[e], spheres, influences, output_functor);
+		}
+	}
 
-				const SimplePoint a_b_border=pa+((pb-pa).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pa, pb, spheres[influences[a]], spheres[influences[b]]));
-				const SimplePoint a_c_border=pa+((pc-pa).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pa, pc, spheres[influences[a]], spheres[influences[c]]));
-				const SimplePoint b_c_border=pb+((pc-pb).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pb, pc, spheres[influences[b]], spheres[influences[c]]));
+	template<typename SphereType, typename OutputFunctor>
+	static void construct_surface_of_triangle(
+			const std::vector<SimplePoint>& vertices,
+			const Triple& triple,
+			const std::vector<SphereType>& spheres,
+			const std::vector<std::size_t>& influences,
+			OutputFunctor& output_functor)
+	{
+		const std::size_t a=triple.get(0);
+		const std::size_t b=triple.get(1);
+		const std::size_t c=triple.get(2);
+		if(influences[a]==influences[b] && influences[a]==influences[c])
+		{
+			output_functor(influences[a], vertices[a], vertices[b], vertices[c]);
+		}
+		else if(influences[a]!=influences[b] && influences[a]!=influences[c] && influences[b]!=influences[c])
+		{
+			const SimplePoint& pa=vertices[a];
+			const SimplePoint& pb=vertices[b];
+			const SimplePoint& pc=vertices[c];
 
-				const SimplePoint middle=(a_b_border+a_c_border+b_c_border)*(1.0/3.0);
+			const SimplePoint a_b_border=pa+((pb-pa).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pa, pb, spheres[influences[a]], spheres[influences[b]]));
+			const SimplePoint a_c_border=pa+((pc-pa).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pa, pc, spheres[influences[a]], spheres[influences[c]]));
+			const SimplePoint b_c_border=pb+((pc-pb).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(pb, pc, spheres[influences[b]], spheres[influences[c]]));
 
-				output_functor(influences[a], pa, a_b_border, a_c_border);
-				output_functor(influences[a], middle, a_b_border, a_c_border);
+			const SimplePoint middle=(a_b_border+a_c_border+b_c_border)*(1.0/3.0);
 
-				output_functor(influences[b], pb, a_b_border, b_c_border);
-				output_functor(influences[b], middle, a_b_border, b_c_border);
+			output_functor(influences[a], pa, a_b_border, a_c_border);
+			output_functor(influences[a], middle, a_b_border, a_c_border);
 
-				output_functor(influences[c], pc, a_c_border, b_c_border);
-				output_functor(influences[c], middle, a_c_border, b_c_border);
+			output_functor(influences[b], pb, a_b_border, b_c_border);
+			output_functor(influences[b], middle, a_b_border, b_c_border);
+
+			output_functor(influences[c], pc, a_c_border, b_c_border);
+			output_functor(influences[c], middle, a_c_border, b_c_border);
+		}
+		else
+		{
+			std::size_t s=a;
+			std::size_t d1=b;
+			std::size_t d2=c;
+			if(influences[b]!=influences[a] && influences[b]!=influences[c])
+			{
+				s=b;
+				d1=a;
+				d2=c;
 			}
-			else
+			else if(influences[c]!=influences[a] && influences[c]!=influences[b])
 			{
-				std::size_t s=a;
-				std::size_t d1=b;
-				std::size_t d2=c;
-				if(influences[b]!=influences[a] && influences[b]!=influences[c])
-				{
-					s=b;
-					d1=a;
-					d2=c;
-				}
-				else if(influences[c]!=influences[a] && influences[c]!=influences[b])
-				{
-					s=c;
-					d1=a;
-					d2=b;
-				}
+				s=c;
+				d1=a;
+				d2=b;
+			}
 
-				const SimplePoint& ps=sih.vertices()[s];
-				const SimplePoint& pd1=sih.vertices()[d1];
-				const SimplePoint& pd2=sih.vertices()[d2];
+			const SimplePoint& ps=vertices[s];
+			const SimplePoint& pd1=vertices[d1];
+			const SimplePoint& pd2=vertices[d2];
 
-				const SimplePoint s_d1_border=ps+((pd1-ps).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(ps, pd1, spheres[influences[s]], spheres[influences[d1]]));
-				const SimplePoint s_d2_border=ps+((pd2-ps).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(ps, pd2, spheres[influences[s]], spheres[influences[d2]]));
+			const SimplePoint s_d1_border=ps+((pd1-ps).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(ps, pd1, spheres[influences[s]], spheres[influences[d1]]));
+			const SimplePoint s_d2_border=ps+((pd2-ps).unit()*HyperboloidBetweenTwoSpheres::intersect_vector_with_hyperboloid(ps, pd2, spheres[influences[s]], spheres[influences[d2]]));
 
-				output_functor(influences[s], ps, s_d1_border, s_d2_border);
-				output_functor(influences[d1], pd1, s_d1_border, s_d2_border);
-				output_functor(influences[d2], pd2, pd1, s_d2_border);
-			}
+			output_functor(influences[s], ps, s_d1_border, s_d2_border);
+			output_functor(influences[d1], pd1, s_d1_border, s_d2_border);
+			output_functor(influences[d2], pd2, pd1, s_d2_border);
 		}
 	}
 };
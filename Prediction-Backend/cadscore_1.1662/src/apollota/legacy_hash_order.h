@@ -0,0 +1,92 @@
+#ifndef APOLLOTA_LEGACY_HASH_ORDER_H_
+#define APOLLOTA_LEGACY_HASH_ORDER_H_
+
+#include <vector>
+#include <algorithm>
+
+namespace apollota
+{
+
+// Reproduces the order of iteration over the libstdc++ std::tr1 hash containers that the earlier versions used to store quadruples
+// and the neighbors of pairs of spheres, because the areas of some faces depend on the order in which the faces are cut by the neighbors.
+// The containers select buckets by the hash values modulo a prime number of buckets, put every new element to the front of its bucket,
+// and rebuild the buckets (moving every element to the front of its new bucket) when there are more elements than buckets.
+class LegacyHashOrder
+{
+public:
+	// The hash values belong to distinct keys listed in the order of their insertion,
+	// the resulting positions of the keys are listed in the order of iteration
+	static std::vector<std::size_t> calc_iteration_order(const std::vector<std::size_t>& hash_values)
+	{
+		const std::size_t npos=static_cast<std::size_t>(-1);
+		std::vector<std::size_t> heads(next_buckets_count(0), npos);
+		std::vector<std::size_t> next(hash_values.size(), npos);
+		for(std::size_t i=0;i<hash_values.size();i++)
+		{
+			if(i+1>heads.size() && next_buckets_count(heads.size())>heads.size())
+			{
+				std::vector<std::size_t> rebuilt_heads(next_buckets_count(heads.size()), npos);
+				for(std::size_t j=0;j<heads.size();j++)
+				{
+					std::size_t p=heads[j];
+					while(p!=npos)
+					{
+						const std::size_t p_next=next[p];
+						const std::size_t bucket=hash_values[p]%rebuilt_heads.size();
+						next[p]=rebuilt_heads[bucket];
+						rebuilt_heads[bucket]=p;
+						p=p_next;
+					}
+				}
+				heads.swap(rebuilt_heads);
+			}
+			const std::size_t bucket=hash_values[i]%heads.size();
+			next[i]=heads[bucket];
+			heads[bucket]=i;
+		}
+		std::vector<std::size_t> order;
+		order.reserve(hash_values.size());
+		for(std::size_t j=0;j<heads.size();j++)
+		{
+			for(std::size_t p=heads[j];p!=npos;p=next[p])
+			{
+				order.push_back(p);
+			}
+		}
+		return order;
+	}
+
+	// The ids are given in the order of their insertion into a set (repetitions are ignored),
+	// and are left in the order of iteration over the set
+	static void arrange_ids_as_in_set(std::vector<std::size_t>& ids)
+	{
+		std::vector<std::size_t> distinct_ids;
+		distinct_ids.reserve(ids.size());
+		for(std::size_t i=0;i<ids.size();i++)
+		{
+			if(std::find(distinct_ids.begin(), distinct_ids.end(), ids[i])==distinct_ids.end())
+			{
+				distinct_ids.push_back(ids[i]);
+			}
+		}
+		const std::vector<std::size_t> order=calc_iteration_order(distinct_ids);
+		ids.resize(order.size());
+		for(std::size_t i=0;i<order.size();i++)
+		{
+			ids[i]=distinct_ids[order[i]];
+		}
+	}
+
+private:
+	static std::size_t next_buckets_count(const std::size_t buckets_count)
+	{
+		static const std::size_t buckets_counts[]={11, 23, 47, 97, 199, 409, 823, 1741, 3739, 7517, 15173, 30727, 62233, 126271, 256279, 520241, 1056323, 2144977, 4355707, 8844859, 17961079, 36473443, 74066549, 150406843, 305431229, 620239453, 1259520799};
+		const std::size_t* buckets_counts_end=buckets_counts+(sizeof(buckets_counts)/sizeof(buckets_counts[0]));
+		const std::size_t* p=std::upper_bound(buckets_counts, buckets_counts_end, buckets_count);
+		return (p!=buckets_counts_end ? (*p) : buckets_count);
+	}
+};
+
+}
+
+#endif /* APOLLOTA_LEGACY_HASH_ORDER_H_ */
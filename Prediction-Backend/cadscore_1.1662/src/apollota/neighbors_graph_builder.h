@@ -0,0 +1,131 @@
+#ifndef APOLLOTA_NEIGHBORS_GRAPH_BUILDER_H_
+#define APOLLOTA_NEIGHBORS_GRAPH_BUILDER_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "tuple.h"
+#include "compressed_neighbors_graph.h"
+
+namespace apollota
+{
+
+// Collects the neighborhood relations of quadruples without storing the quadruples themselves.
+// Edges are kept as a sorted list of unique id pairs, new edges are buffered and merged into the list when the buffer grows too big.
+class NeighborsGraphBuilder
+{
+public:
+	NeighborsGraphBuilder() : compacted_size_(0), quadruples_count_(0)
+	{
+	}
+
+	void add_quadruple(const Quadruple& quadruple)
+	{
+		quadruples_count_++;
+		for(int a=0;a<4;a++)
+		{
+			for(int b=a+1;b<4;b++)
+			{
+				add_edge(quadruple.get(a), quadruple.get(b));
+			}
+		}
+		if(edges_.size()>std::max(minimal_buffer_size(), compacted_size_*2))
+		{
+			compact();
+		}
+	}
+
+	// Quadruples are not kept, so a quadruple added again is counted again
+	std::size_t count_added_quadruples() const
+	{
+		return quadruples_count_;
+	}
+
+	std::size_t count_edges()
+	{
+		compact();
+		return edges_.size();
+	}
+
+	// The mapping (if not empty) translates the added ids into the ids of the resulting graph,
+	// neighbors lists of the resulting graph are sorted
+	CompressedNeighborsGraph collect_neighbors_graph(const std::size_t number_of_vertices, const std::vector<std::size_t>& mapping)
+	{
+		compact();
+		CompressedNeighborsGraph graph;
+		graph.offsets.assign(number_of_vertices+1, 0);
+		for(std::size_t i=0;i<edges_.size();i++)
+		{
+			const std::size_t a=map_id(edges_[i].first, mapping);
+			const std::size_t b=map_id(edges_[i].second, mapping);
+			if(a<number_of_vertices && b<number_of_vertices)
+			{
+				graph.offsets[a+1]++;
+				graph.offsets[b+1]++;
+			}
+		}
+		for(std::size_t i=0;i<number_of_vertices;i++)
+		{
+			graph.offsets[i+1]+=graph.offsets[i];
+		}
+		graph.ids.resize(graph.offsets.back());
+		std::vector<std::size_t> positions(graph.offsets.begin(), graph.offsets.end()-1);
+		for(std::size_t i=0;i<edges_.size();i++)
+		{
+			const std::size_t a=map_id(edges_[i].first, mapping);
+			const std::size_t b=map_id(edges_[i].second, mapping);
+			if(a<number_of_vertices && b<number_of_vertices)
+			{
+				graph.ids[positions[a]++]=b;
+				graph.ids[positions[b]++]=a;
+			}
+		}
+		if(!mapping.empty())
+		{
+			graph.sort_and_remove_duplicates_in_rows(1);
+		}
+		return graph;
+	}
+
+private:
+	typedef unsigned int Id;
+	typedef std::pair<Id, Id> Edge;
+
+	static std::size_t minimal_buffer_size()
+	{
+		return 65536;
+	}
+
+	static std::size_t map_id(const Id id, const std::vector<std::size_t>& mapping)
+	{
+		return (mapping.empty() ? static_cast<std::size_t>(id) : (id<mapping.size() ? mapping[id] : static_cast<std::size_t>(-1)));
+	}
+
+	void add_edge(const std::size_t a, const std::size_t b)
+	{
+		if(a>=static_cast<std::size_t>(static_cast<Id>(-1)) || b>=static_cast<std::size_t>(static_cast<Id>(-1)))
+		{
+			throw std::runtime_error("Too big sphere id for neighbors graph");
+		}
+		edges_.push_back(a<b ? Edge(static_cast<Id>(a), static_cast<Id>(b)) : Edge(static_cast<Id>(b), static_cast<Id>(a)));
+	}
+
+	void compact()
+	{
+		if(edges_.size()>compacted_size_)
+		{
+			std::sort(edges_.begin(), edges_.end());
+			edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+			compacted_size_=edges_.size();
+		}
+	}
+
+	std::vector<Edge> edges_;
+	std::size_t compacted_size_;
+	std::size_t quadruples_count_;
+};
+
+}
+
+#endif /* APOLLOTA_NEIGHBORS_GRAPH_BUILDER_H_ */
@@ -0,0 +1,267 @@
+#ifndef APOLLOTA_OPEN_ADDRESSING_HASH_MAP_H_
+#define APOLLOTA_OPEN_ADDRESSING_HASH_MAP_H_
+
+#include <vector>
+#include <utility>
+
+namespace apollota
+{
+
+struct IdentityHashFunctor
+{
+	std::size_t operator()(const std::size_t value) const
+	{
+		return value;
+	}
+};
+
+// Entries are kept contiguously in insertion order (erasing moves the last entry into the freed place),
+// and a linear probing table of entry positions is used for lookup.
+template<typename Key, typename Value, typename HashFunctor>
+class OpenAddressingHashMap
+{
+public:
+	typedef Key key_type;
+	typedef Value mapped_type;
+	typedef std::pair<Key, Value> value_type;
+	typedef typename std::vector<value_type>::iterator iterator;
+	typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+	OpenAddressingHashMap()
+	{
+	}
+
+	std::size_t size() const
+	{
+		return entries_.size();
+	}
+
+	bool empty() const
+	{
+		return entries_.empty();
+	}
+
+	iterator begin()
+	{
+		return entries_.begin();
+	}
+
+	const_iterator begin() const
+	{
+		return entries_.begin();
+	}
+
+	iterator end()
+	{
+		return entries_.end();
+	}
+
+	const_iterator end() const
+	{
+		return entries_.end();
+	}
+
+	void clear()
+	{
+		entries_.clear();
+		table_.clear();
+	}
+
+	void reserve(const std::size_t expected_size)
+	{
+		entries_.reserve(expected_size);
+		if(table_.size()<expected_size*2)
+		{
+			rebuild_table(expected_size*2);
+		}
+	}
+
+	void swap(OpenAddressingHashMap& m)
+	{
+		entries_.swap(m.entries_);
+		table_.swap(m.table_);
+	}
+
+	iterator find(const Key& key)
+	{
+		const std::size_t slot=find_slot(key);
+		return (slot<table_.size() && table_[slot]!=empty_slot() ? entries_.begin()+table_[slot] : entries_.end());
+	}
+
+	const_iterator find(const Key& key) const
+	{
+		const std::size_t slot=find_slot(key);
+		return (slot<table_.size() && table_[slot]!=empty_slot() ? entries_.begin()+table_[slot] : entries_.end());
+	}
+
+	std::size_t count(const Key& key) const
+	{
+		return (find(key)==entries_.end() ? 0 : 1);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& entry)
+	{
+		std::size_t slot=find_slot(entry.first);
+		if(slot<table_.size() && table_[slot]!=empty_slot())
+		{
+			return std::make_pair(entries_.begin()+table_[slot], false);
+		}
+		if((entries_.size()+1)*2>table_.size())
+		{
+			rebuild_table(table_.empty() ? 16 : table_.size()*2);
+			slot=find_slot(entry.first);
+		}
+		table_[slot]=static_cast<Position>(entries_.size());
+		entries_.push_back(entry);
+		return std::make_pair(entries_.end()-1, true);
+	}
+
+	Value& operator[](const Key& key)
+	{
+		return insert(value_type(key, Value())).first->second;
+	}
+
+	std::size_t erase(const Key& key)
+	{
+		std::size_t slot=find_slot(key);
+		if(slot>=table_.size() || table_[slot]==empty_slot())
+		{
+			return 0;
+		}
+		const std::size_t position=table_[slot];
+		const std::size_t mask=table_.size()-1;
+		std::size_t next=slot;
+		while(true)
+		{
+			next=(next+1)&mask;
+			if(table_[next]==empty_slot())
+			{
+				break;
+			}
+			const std::size_t home=hash_of(entries_[table_[next]].first)&mask;
+			if(((next-home)&mask)>=((next-slot)&mask))
+			{
+				table_[slot]=table_[next];
+				slot=next;
+			}
+		}
+		table_[slot]=empty_slot();
+		const std::size_t last=entries_.size()-1;
+		if(position!=last)
+		{
+			std::size_t last_slot=hash_of(entries_[last].first)&mask;
+			while(table_[last_slot]!=last)
+			{
+				last_slot=(last_slot+1)&mask;
+			}
+			table_[last_slot]=static_cast<Position>(position);
+			entries_[position]=entries_[last];
+		}
+		entries_.pop_back();
+		return 1;
+	}
+
+private:
+	typedef unsigned int Position;
+
+	static Position empty_slot()
+	{
+		return static_cast<Position>(-1);
+	}
+
+	static std::size_t hash_of(const Key& key)
+	{
+		std::size_t h=HashFunctor()(key);
+		h^=(h>>16);
+		h*=0x85ebca6bU;
+		h^=(h>>13);
+		h*=0xc2b2ae35U;
+		h^=(h>>16);
+		return h;
+	}
+
+	std::size_t find_slot(const Key& key) const
+	{
+		if(table_.empty())
+		{
+			return 0;
+		}
+		const std::size_t mask=table_.size()-1;
+		std::size_t slot=hash_of(key)&mask;
+		while(table_[slot]!=empty_slot() && !(entries_[table_[slot]].first==key))
+		{
+			slot=(slot+1)&mask;
+		}
+		return slot;
+	}
+
+	void rebuild_table(const std::size_t min_size)
+	{
+		std::size_t table_size=16;
+		while(table_size<min_size)
+		{
+			table_size*=2;
+		}
+		table_.assign(table_size, empty_slot());
+		const std::size_t mask=table_size-1;
+		for(std::size_t i=0;i<entries_.size();i++)
+		{
+			std::size_t slot=hash_of(entries_[i].first)&mask;
+			while(table_[slot]!=empty_slot())
+			{
+				slot=(slot+1)&mask;
+			}
+			table_[slot]=static_cast<Position>(i);
+		}
+	}
+
+	std::vector<value_type> entries_;
+	std::vector<Position> table_;
+};
+
+template<typename Key, typename HashFunctor>
+class OpenAddressingHashSet
+{
+public:
+	std::size_t size() const
+	{
+		return map_.size();
+	}
+
+	bool empty() const
+	{
+		return map_.empty();
+	}
+
+	void clear()
+	{
+		map_.clear();
+	}
+
+	void reserve(const std::size_t expected_size)
+	{
+		map_.reserve(expected_size);
+	}
+
+	bool insert(const Key& key)
+	{
+		return map_.insert(std::make_pair(key, true)).second;
+	}
+
+	std::size_t count(const Key& key) const
+	{
+		return map_.count(key);
+	}
+
+	std::size_t erase(const Key& key)
+	{
+		return map_.erase(key);
+	}
+
+private:
+	OpenAddressingHashMap<Key, bool, HashFunctor> map_;
+};
+
+}
+
+#endif /* APOLLOTA_OPEN_ADDRESSING_HASH_MAP_H_ */
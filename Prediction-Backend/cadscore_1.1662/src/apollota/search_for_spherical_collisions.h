@@ -2,6 +2,7 @@
 #define APOLLOTA_SEARCH_FOR_SPHERICAL_COLLISIONS_H_
 
 #include <set>
+#include <algorithm>
 
 #include "bounding_spheres_hierarchy.h"
 
@@ -15,7 +16,7 @@ public:
 	{
 		NodeCheckerForCollisions node_checker(target);
 		LeafCheckerForCollisions leaf_checker(target, one_hit_is_enough);
-		return bsh.search(node_checker, leaf_checker);
+		return bsh.search_with_leaves_filter(node_checker, leaf_checker);
 	}
 
 	static std::vector<std::size_t> find_all_collisions(const BoundingSpheresHierarchy& bsh, const SimpleSphere& target)
@@ -28,10 +29,40 @@ public:
 		return find_collisions(bsh, target, true);
 	}
 
-	static std::set<std::size_t> find_all_hidden_spheres(const BoundingSpheresHierarchy& bsh)
+	static std::set<std::size_t> find_all_hidden_spheres(const BoundingSpheresHierarchy& bsh, const std::size_t number_of_threads=1)
 	{
 		std::set<std::size_t> result;
-		for(std::size_t i=0;i<bsh.leaves_spheres().size();i++)
+		if(number_of_threads<2)
+		{
+			std::vector<std::size_t> hidden_spheres_ids;
+			collect_hidden_spheres_in_range(bsh, 0, bsh.leaves_spheres().size(), hidden_spheres_ids);
+			result.insert(hidden_spheres_ids.begin(), hidden_spheres_ids.end());
+		}
+		else
+		{
+			const std::size_t block_size=256;
+			const int blocks_count=static_cast<int>((bsh.leaves_spheres().size()+block_size-1)/block_size);
+			std::vector< std::vector<std::size_t> > blocks_hidden_spheres_ids(blocks_count);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+			for(int i=0;i<blocks_count;i++)
+			{
+				const std::size_t begin=static_cast<std::size_t>(i)*block_size;
+				collect_hidden_spheres_in_range(bsh, begin, std::min(begin+block_size, bsh.leaves_spheres().size()), blocks_hidden_spheres_ids[i]);
+			}
+			for(std::size_t i=0;i<blocks_hidden_spheres_ids.size();i++)
+			{
+				result.insert(blocks_hidden_spheres_ids[i].begin(), blocks_hidden_spheres_ids[i].end());
+			}
+		}
+		return result;
+	}
+
+private:
+	static void collect_hidden_spheres_in_range(const BoundingSpheresHierarchy& bsh, const std::size_t begin, const std::size_t end, std::vector<std::size_t>& hidden_spheres_ids)
+	{
+		for(std::size_t i=begin;i<end;i++)
 		{
 			std::vector<std::size_t> candidates=find_all_collisions(bsh, custom_sphere_from_object<SimpleSphere>(bsh.leaves_spheres()[i]));
 			for(std::size_t j=0;j<candidates.size();j++)
@@ -42,30 +73,21 @@ public:
 					const bool candidate_j_contains_i=sphere_contains_sphere(bsh.leaves_spheres()[candidates[j]], bsh.leaves_spheres()[i]);
 					if(i_contains_candidate_j && candidate_j_contains_i)
 					{
-						if(i<candidates[j])
-						{
-							result.insert(candidates[j]);
-						}
-						else
-						{
-							result.insert(i);
-						}
+						hidden_spheres_ids.push_back(i<candidates[j] ? candidates[j] : i);
 					}
 					else if(i_contains_candidate_j)
 					{
-						result.insert(candidates[j]);
+						hidden_spheres_ids.push_back(candidates[j]);
 					}
 					else if(candidate_j_contains_i)
 					{
-						result.insert(i);
+						hidden_spheres_ids.push_back(i);
 					}
 				}
 			}
 		}
-		return result;
 	}
 
-private:
 	struct NodeCheckerForCollisions
 	{
 		const SimpleSphere& target;
@@ -87,14 +109,15 @@ private:
 
 		LeafCheckerForCollisions(const SimpleSphere& target, const bool one_hit_is_enough) : target(target), one_hit_is_enough(one_hit_is_enough) {}
 
+		const SimpleSphere& leaves_filter_sphere() const
+		{
+			return target;
+		}
+
 		template<typename Sphere>
-		std::pair<bool, bool> operator()(const std::size_t /*id*/, const Sphere& sphere) const
+		std::pair<bool, bool> operator()(const std::size_t /*id*/, const Sphere& /*sphere*/) const
 		{
-			if(sphere_intersects_sphere(sphere, target))
-			{
-				return std::make_pair(true, one_hit_is_enough);
-			}
-			return std::make_pair(false, false);
+			return std::make_pair(true, one_hit_is_enough);
 		}
 	};
 };
@@ -0,0 +1,84 @@
+#ifndef APOLLOTA_SPATIAL_ORDERING_OF_SPHERES_H_
+#define APOLLOTA_SPATIAL_ORDERING_OF_SPHERES_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace apollota
+{
+
+class SpatialOrderingOfSpheres
+{
+public:
+	// Returns the ids of spheres sorted along the Morton (Z-order) curve of their centers,
+	// so that spheres close in the resulting order are also close in space
+	template<typename SphereType>
+	static std::vector<std::size_t> calc_morton_order(const std::vector<SphereType>& spheres)
+	{
+		std::vector<std::size_t> order(spheres.size());
+		if(spheres.empty())
+		{
+			return order;
+		}
+		double min_coords[3]={std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+		double max_coords[3]={-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()};
+		for(std::size_t i=0;i<spheres.size();i++)
+		{
+			const double coords[3]={spheres[i].x, spheres[i].y, spheres[i].z};
+			for(int k=0;k<3;k++)
+			{
+				min_coords[k]=std::min(min_coords[k], coords[k]);
+				max_coords[k]=std::max(max_coords[k], coords[k]);
+			}
+		}
+		const double max_span=std::max(max_coords[0]-min_coords[0], std::max(max_coords[1]-min_coords[1], max_coords[2]-min_coords[2]));
+		const double scale=(max_span>0.0 ? static_cast<double>(max_cell_index())/max_span : 0.0);
+		std::vector< std::pair<unsigned int, std::size_t> > keys(spheres.size());
+		for(std::size_t i=0;i<spheres.size();i++)
+		{
+			const unsigned int cx=static_cast<unsigned int>((spheres[i].x-min_coords[0])*scale);
+			const unsigned int cy=static_cast<unsigned int>((spheres[i].y-min_coords[1])*scale);
+			const unsigned int cz=static_cast<unsigned int>((spheres[i].z-min_coords[2])*scale);
+			keys[i]=std::make_pair((spread_bits(cx)<<2)|(spread_bits(cy)<<1)|spread_bits(cz), i);
+		}
+		std::sort(keys.begin(), keys.end());
+		for(std::size_t i=0;i<keys.size();i++)
+		{
+			order[i]=keys[i].second;
+		}
+		return order;
+	}
+
+	template<typename T>
+	static std::vector<T> apply_order(const std::vector<T>& values, const std::vector<std::size_t>& order)
+	{
+		std::vector<T> result;
+		result.reserve(order.size());
+		for(std::size_t i=0;i<order.size();i++)
+		{
+			result.push_back(values[order[i]]);
+		}
+		return result;
+	}
+
+private:
+	static unsigned int max_cell_index()
+	{
+		return 1023;
+	}
+
+	static unsigned int spread_bits(unsigned int v)
+	{
+		v&=0x3FF;
+		v=(v|(v<<16))&0x030000FF;
+		v=(v|(v<<8))&0x0300F00F;
+		v=(v|(v<<4))&0x030C30C3;
+		v=(v|(v<<2))&0x09249249;
+		return v;
+	}
+};
+
+}
+
+#endif /* APOLLOTA_SPATIAL_ORDERING_OF_SPHERES_H_ */
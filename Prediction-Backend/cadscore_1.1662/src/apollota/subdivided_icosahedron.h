@@ -2,9 +2,11 @@
 #define APOLLOTA_SUBDIVIDED_ICOSAHEDRON_H_
 
 #include <cmath>
+#include <map>
 
 #include "basic_operations_on_points.h"
 #include "tuple.h"
+#include "open_addressing_hash_map.h"
 
 namespace apollota
 {
@@ -50,6 +52,11 @@ public:
 		triples_.push_back(Triple(6, 1, 3));
 		triples_.push_back(Triple(11, 7, 5));
 
+		for(std::size_t i=0;i<vertices_.size();i++)
+		{
+			vertices_parents_.push_back(Pair(i, i));
+		}
+
 		for(std::size_t i=0;i<depth;i++)
 		{
 			grow();
@@ -71,6 +78,13 @@ public:
 		return triples_;
 	}
 
+	// The ends of the edge that was split to make the vertex (twice the vertex itself for the initial vertices),
+	// parents always have smaller ids than their children
+	const std::vector<Pair>& vertices_parents() const
+	{
+		return vertices_parents_;
+	}
+
 	template<typename PointType>
 	void fit_into_sphere(const PointType& center, const double radius)
 	{
@@ -82,6 +96,38 @@ public:
 		center_=new_center;
 	}
 
+	template<typename PointType>
+	void fill_vertices_fitted_into_sphere(const PointType& center, const double radius, std::vector<SimplePoint>& output_vertices) const
+	{
+		output_vertices.resize(vertices_.size());
+		for(std::size_t i=0;i<vertices_.size();i++)
+		{
+			const SimplePoint& v=vertices_[i];
+			SimplePoint& ov=output_vertices[i];
+			ov.x=center.x+(v.x-center_.x)*radius;
+			ov.y=center.y+(v.y-center_.y)*radius;
+			ov.z=center.z+(v.z-center_.z)*radius;
+		}
+	}
+
+	static const SubdividedIcosahedron& unit_icosahedron(const std::size_t depth)
+	{
+		static std::map<std::size_t, SubdividedIcosahedron> cache;
+		const SubdividedIcosahedron* result=0;
+#ifdef _OPENMP
+#pragma omp critical(SubdividedIcosahedron_unit_icosahedron)
+#endif
+		{
+			std::map<std::size_t, SubdividedIcosahedron>::iterator it=cache.find(depth);
+			if(it==cache.end())
+			{
+				it=cache.insert(std::make_pair(depth, SubdividedIcosahedron(depth))).first;
+			}
+			result=&(it->second);
+		}
+		return (*result);
+	}
+
 	double edge_length_estimate() const
 	{
 		return distance_from_point_to_point(vertices_.at(triples_.front().get(0)), vertices_.at(triples_.front().get(1)));
@@ -90,7 +136,7 @@ public:
 private:
 	void grow()
 	{
-		typedef std::tr1::unordered_map<Pair, std::size_t, Pair::HashFunctor> PairsMap;
+		typedef OpenAddressingHashMap<Pair, std::size_t, Pair::HashFunctor> PairsMap;
 		PairsMap pairs_vertices;
 		std::vector<Triple> new_triples;
 		new_triples.reserve(triples_.size()*4);
@@ -106,6 +152,7 @@ private:
 				{
 					middle_point_ids[j]=vertices_.size();
 					vertices_.push_back(((vertices_[pair.get(0)]+vertices_[pair.get(1)])*(0.5)).unit());
+					vertices_parents_.push_back(pair);
 					pairs_vertices[pair]=middle_point_ids[j];
 				}
 				else
@@ -123,6 +170,7 @@ private:
 
 	SimplePoint center_;
 	std::vector<SimplePoint> vertices_;
+	std::vector<Pair> vertices_parents_;
 	std::vector<Triple> triples_;
 };
 
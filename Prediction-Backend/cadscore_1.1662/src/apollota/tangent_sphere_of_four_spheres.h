@@ -7,6 +7,7 @@
 #include "rotation.h"
 #include "safer_quadratic_equation_root.h"
 #include "safer_summation.h"
+#include "fixed_capacity_vector.h"
 
 namespace apollota
 {
@@ -14,16 +15,52 @@ namespace apollota
 class TangentSphereOfFourSpheres
 {
 public:
+	struct BatchWorkspace
+	{
+		std::vector<double> u1;
+		std::vector<double> v1;
+		std::vector<double> u2;
+		std::vector<double> v2;
+		std::vector<double> u3;
+		std::vector<double> v3;
+		std::vector<double> w;
+		std::vector<double> a;
+		std::vector<double> b;
+		std::vector<double> c;
+
+		void resize(const std::size_t size)
+		{
+			u1.resize(size);
+			v1.resize(size);
+			u2.resize(size);
+			v2.resize(size);
+			u3.resize(size);
+			v3.resize(size);
+			w.resize(size);
+			a.resize(size);
+			b.resize(size);
+			c.resize(size);
+		}
+	};
+
 	template<typename InputSphereTypeA, typename InputSphereTypeB, typename InputSphereTypeC, typename InputSphereTypeD>
 	static inline std::vector<SimpleSphere> calculate(const InputSphereTypeA& sm, const InputSphereTypeB& s1, const InputSphereTypeC& s2, const InputSphereTypeD& s3)
+	{
+		std::vector<SimpleSphere> results;
+		calculate(sm, s1, s2, s3, results);
+		return results;
+	}
+
+	template<typename InputSphereTypeA, typename InputSphereTypeB, typename InputSphereTypeC, typename InputSphereTypeD, typename ResultsContainer>
+	static inline void calculate(const InputSphereTypeA& sm, const InputSphereTypeB& s1, const InputSphereTypeC& s2, const InputSphereTypeD& s3, ResultsContainer& results)
 	{
 		{
 			const double min_r=std::min(sm.r, std::min(s1.r, std::min(s2.r, s3.r)));
 			if(sm.r!=min_r)
 			{
-				if(s1.r==min_r) return calculate(s1, sm, s2, s3);
-				if(s2.r==min_r) return calculate(s2, sm, s1, s3);
-				if(s3.r==min_r) return calculate(s3, sm, s1, s2);
+				if(s1.r==min_r) return calculate(s1, sm, s2, s3, results);
+				if(s2.r==min_r) return calculate(s2, sm, s1, s3, results);
+				if(s3.r==min_r) return calculate(s3, sm, s1, s2, results);
 			}
 		}
 
@@ -38,8 +75,6 @@ public:
 		}
 
 		const unsigned int rotation_steps=2;
-		const SimplePoint rotation_axis(1.0, 1.0, 1.0);
-		const double rotation_step_angle=30.0;
 
 		for(unsigned int rotation_step=0;rotation_step<=rotation_steps;rotation_step++)
 		{
@@ -49,7 +84,7 @@ public:
 
 			if(rotation_step>0)
 			{
-				const Rotation rotation(rotation_axis, rotation_step_angle*static_cast<double>(rotation_step));
+				const Rotation rotation(rotation_axis(), rotation_step_angle()*static_cast<double>(rotation_step));
 				ts1=SimpleSphere(rotation.rotate<SimplePoint>(ts1), ts1.r);
 				ts2=SimpleSphere(rotation.rotate<SimplePoint>(ts2), ts2.r);
 				ts3=SimpleSphere(rotation.rotate<SimplePoint>(ts3), ts3.r);
@@ -107,48 +142,167 @@ public:
 				if(check_if_quadratic_equation_is_solvable(a, b))
 				{
 					const double c = safer_sum(v1*v1, v2*v2, v3*v3);
-					std::vector<SimpleSphere> results;
-					std::vector<double> radiuses;
-					if(solve_quadratic_equation(a, b, c, radiuses))
-					{
-						results.reserve(radiuses.size());
-						for(std::size_t i=0;i<radiuses.size();i++)
-						{
-							const double r=radiuses[i];
-							if(r>=0.0)
-							{
-								SimpleSphere candidate(safer_sum(u1*r, v1), safer_sum(u2*r, v2), safer_sum(u3*r, v3), r);
-								if(rotation_step>0)
-								{
-									const Rotation rotation(rotation_axis, (0.0-rotation_step_angle)*static_cast<double>(rotation_step));
-									candidate=SimpleSphere(rotation.rotate<SimplePoint>(candidate), candidate.r);
-								}
-								candidate.x+=usm.x;
-								candidate.y+=usm.y;
-								candidate.z+=usm.z;
-								candidate.r-=usm.r;
-								std::pair<double, double> error_estimate=calculate_tangent_sphere_radius_error_estimate(sm, s1, s2, s3, candidate);
-								if(error_estimate.first<0.0)
-								{
-									candidate.r+=error_estimate.first;
-									error_estimate=calculate_tangent_sphere_radius_error_estimate(sm, s1, s2, s3, candidate);
-								}
-								if(std::max(fabs(error_estimate.first), fabs(error_estimate.second))<tangent_spheres_max_allowed_error())
-								{
-									results.push_back(candidate);
-								}
-							}
-						}
-					}
-					return results;
+					add_tangent_spheres_from_solution(sm, s1, s2, s3, usm, rotation_step, u1, v1, u2, v2, u3, v3, a, b, c, results);
+					return;
 				}
 			}
 		}
+	}
+
+	// Gives the same results as calling calculate(a, b, c, candidates[i], results[i]) for every candidate,
+	// but the linear part of the solution is computed for all the candidates in one loop without branching.
+	// Candidates that are smaller than a, b and c or need the degeneracy handling are passed to the general function.
+	template<typename InputSphereTypeA, typename InputSphereTypeB, typename InputSphereTypeC, typename ResultsContainer>
+	static inline void calculate_for_candidates(const InputSphereTypeA& a, const InputSphereTypeB& b, const InputSphereTypeC& c, const std::vector<SimpleSphere>& candidates, BatchWorkspace& workspace, std::vector<ResultsContainer>& results)
+	{
+		results.resize(candidates.size());
+		for(std::size_t i=0;i<results.size();i++)
+		{
+			results[i].clear();
+		}
+		if(candidates.empty())
+		{
+			return;
+		}
+
+		const double abc_min_r=std::min(a.r, std::min(b.r, c.r));
+		const SimpleSphere sm=(a.r==abc_min_r ? SimpleSphere(a) : (b.r==abc_min_r ? SimpleSphere(b) : SimpleSphere(c)));
+		const SimpleSphere s1=(a.r==abc_min_r ? SimpleSphere(b) : SimpleSphere(a));
+		const SimpleSphere s2=((a.r==abc_min_r || b.r==abc_min_r) ? SimpleSphere(c) : SimpleSphere(b));
+
+		const double x1=s1.x-sm.x;
+		const double y1=s1.y-sm.y;
+		const double z1=s1.z-sm.z;
+		const double r1=s1.r-sm.r;
+
+		const double x2=s2.x-sm.x;
+		const double y2=s2.y-sm.y;
+		const double z2=s2.z-sm.z;
+		const double r2=s2.r-sm.r;
+
+		const double a1=2*x1;
+		const double b1=2*y1;
+		const double c1=2*z1;
+		const double d1=2*r1;
+		const double o1=safer_sum(r1*r1, -x1*x1, -y1*y1, -z1*z1);
+
+		const double a2=2*x2;
+		const double b2=2*y2;
+		const double c2=2*z2;
+		const double d2=2*r2;
+		const double o2=safer_sum(r2*r2, -x2*x2, -y2*y2, -z2*z2);
+
+		workspace.resize(candidates.size());
+
+		for(std::size_t i=0;i<candidates.size();i++)
+		{
+			const double x3=candidates[i].x-sm.x;
+			const double y3=candidates[i].y-sm.y;
+			const double z3=candidates[i].z-sm.z;
+			const double r3=candidates[i].r-sm.r;
+
+			const double a3=2*x3;
+			const double b3=2*y3;
+			const double c3=2*z3;
+			const double d3=2*r3;
+			const double o3=safer_sum(r3*r3, -x3*x3, -y3*y3, -z3*z3);
+
+			const double w = safer_sum(a1*b3*c2, -a1*b2*c3, b1*a2*c3, -b1*a3*c2, c1*a3*b2, -c1*a2*b3);
 
-		return std::vector<SimpleSphere>();
+			const double u1 = -safer_sum( b1*c3*d2, -b1*c2*d3, c1*b2*d3, -c1*b3*d2, d1*b3*c2, -d1*b2*c3 ) / w;
+			const double v1 = -safer_sum( b1*c3*o2, -b1*c2*o3, c1*b2*o3, -c1*b3*o2, o1*b3*c2, -o1*b2*c3 ) / w;
+
+			const double u2 =  safer_sum( a1*c3*d2, -a1*c2*d3, c1*a2*d3, -c1*a3*d2, d1*a3*c2, -d1*a2*c3 ) / w;
+			const double v2 =  safer_sum( a1*c3*o2, -a1*c2*o3, c1*a2*o3, -c1*a3*o2, o1*a3*c2, -o1*a2*c3 ) / w;
+
+			const double u3 = -safer_sum( a1*b3*d2, -a1*b2*d3, b1*a2*d3, -b1*a3*d2, d1*a3*b2, -d1*a2*b3 ) / w;
+			const double v3 = -safer_sum( a1*b3*o2, -a1*b2*o3, b1*a2*o3, -b1*a3*o2, o1*a3*b2, -o1*a2*b3 ) / w;
+
+			workspace.u1[i]=u1;
+			workspace.v1[i]=v1;
+			workspace.u2[i]=u2;
+			workspace.v2[i]=v2;
+			workspace.u3[i]=u3;
+			workspace.v3[i]=v3;
+			workspace.w[i]=w;
+			workspace.a[i]=safer_sum(u1*u1, u2*u2, u3*u3, -1.0);
+			workspace.b[i]=safer_sum(2*u1*v1, 2*u2*v2, 2*u3*v3);
+			workspace.c[i]=safer_sum(v1*v1, v2*v2, v3*v3);
+		}
+
+		for(std::size_t i=0;i<candidates.size();i++)
+		{
+			const SimpleSphere& s3=candidates[i];
+			if(
+					s3.r<abc_min_r
+					|| equal(fabs(signed_volume_of_tetrahedron(sm, s1, s2, s3)), 0.0)
+					|| !(workspace.w[i]>0.0 || workspace.w[i]<0.0)
+					|| !check_if_quadratic_equation_is_solvable(workspace.a[i], workspace.b[i])
+				)
+			{
+				calculate(a, b, c, s3, results[i]);
+			}
+			else
+			{
+				add_tangent_spheres_from_solution(sm, s1, s2, s3, sm, 0,
+						workspace.u1[i], workspace.v1[i], workspace.u2[i], workspace.v2[i], workspace.u3[i], workspace.v3[i],
+						workspace.a[i], workspace.b[i], workspace.c[i], results[i]);
+			}
+		}
 	}
 
 private:
+	static SimplePoint rotation_axis()
+	{
+		return SimplePoint(1.0, 1.0, 1.0);
+	}
+
+	static double rotation_step_angle()
+	{
+		return 30.0;
+	}
+
+	template<typename InputSphereTypeA, typename InputSphereTypeB, typename InputSphereTypeC, typename InputSphereTypeD, typename ResultsContainer>
+	static inline void add_tangent_spheres_from_solution(
+			const InputSphereTypeA& sm, const InputSphereTypeB& s1, const InputSphereTypeC& s2, const InputSphereTypeD& s3,
+			const SimpleSphere& usm, const unsigned int rotation_step,
+			const double u1, const double v1, const double u2, const double v2, const double u3, const double v3,
+			const double a, const double b, const double c,
+			ResultsContainer& results)
+	{
+		FixedCapacityVector<double, 2> radiuses;
+		if(solve_quadratic_equation(a, b, c, radiuses))
+		{
+			for(std::size_t i=0;i<radiuses.size();i++)
+			{
+				const double r=radiuses[i];
+				if(r>=0.0)
+				{
+					SimpleSphere candidate(safer_sum(u1*r, v1), safer_sum(u2*r, v2), safer_sum(u3*r, v3), r);
+					if(rotation_step>0)
+					{
+						const Rotation rotation(rotation_axis(), (0.0-rotation_step_angle())*static_cast<double>(rotation_step));
+						candidate=SimpleSphere(rotation.rotate<SimplePoint>(candidate), candidate.r);
+					}
+					candidate.x+=usm.x;
+					candidate.y+=usm.y;
+					candidate.z+=usm.z;
+					candidate.r-=usm.r;
+					std::pair<double, double> error_estimate=calculate_tangent_sphere_radius_error_estimate(sm, s1, s2, s3, candidate);
+					if(error_estimate.first<0.0)
+					{
+						candidate.r+=error_estimate.first;
+						error_estimate=calculate_tangent_sphere_radius_error_estimate(sm, s1, s2, s3, candidate);
+					}
+					if(std::max(fabs(error_estimate.first), fabs(error_estimate.second))<tangent_spheres_max_allowed_error())
+					{
+						results.push_back(candidate);
+					}
+				}
+			}
+		}
+	}
+
 	template<typename InputSphereTypeA, typename InputSphereTypeB, typename InputSphereTypeC, typename InputSphereTypeD, typename InputSphereTypeE>
 	static inline std::pair<double, double> calculate_tangent_sphere_radius_error_estimate(const InputSphereTypeA& s1, const InputSphereTypeB& s2, const InputSphereTypeC& s3, const InputSphereTypeD& s4, const InputSphereTypeE& tangent)
 	{
@@ -6,15 +6,12 @@
 #include <map>
 #include <set>
 
-#ifdef _MSC_VER
-#include <unordered_map>
-#include <unordered_set>
-#else
-#include <tr1/unordered_map>
-#include <tr1/unordered_set>
-#endif
-
 #include "tuple.h"
+#include "fixed_capacity_vector.h"
+#include "neighbors_graph_builder.h"
+#include "open_addressing_hash_map.h"
+#include "legacy_hash_order.h"
+#include "spatial_ordering_of_spheres.h"
 #include "search_for_spherical_collisions.h"
 #include "tangent_plane_of_three_spheres.h"
 #include "tangent_sphere_of_four_spheres.h"
@@ -28,7 +25,8 @@ static const std::size_t npos=static_cast<std::size_t>(-1);
 class Triangulation
 {
 public:
-	typedef std::tr1::unordered_map<Quadruple, std::vector<SimpleSphere>, Quadruple::HashFunctor> QuadruplesMap;
+	typedef FixedCapacityVector<SimpleSphere, 2> TangentSpheres;
+	typedef OpenAddressingHashMap<Quadruple, TangentSpheres, Quadruple::HashFunctor> QuadruplesMap;
 	typedef std::vector< std::pair<Quadruple, SimpleSphere> > VerticesVector;
 	typedef std::vector< std::vector<std::size_t> > VerticesGraph;
 
@@ -67,7 +65,8 @@ public:
 			const std::vector<SimpleSphere>& spheres,
 			const double initial_radius_for_spheres_bucketing,
 			const bool exclude_hidden_spheres,
-			const bool include_surplus_valid_quadruples)
+			const bool include_surplus_valid_quadruples,
+			const std::size_t number_of_threads=1)
 	{
 		Result result;
 
@@ -77,29 +76,13 @@ public:
 			std::vector<std::size_t> refined_spheres_backward_mapping;
 			if(exclude_hidden_spheres)
 			{
-				result.excluded_hidden_spheres_ids=SearchForSphericalCollisions::find_all_hidden_spheres(bsh);
-				if(!result.excluded_hidden_spheres_ids.empty())
-				{
-					std::vector<SimpleSphere> refined_spheres;
-					const std::size_t refined_spheres_count=bsh.leaves_spheres().size()-result.excluded_hidden_spheres_ids.size();
-					refined_spheres.reserve(refined_spheres_count);
-					refined_spheres_backward_mapping.reserve(refined_spheres_count);
-					for(std::size_t i=0;i<bsh.leaves_spheres().size();i++)
-					{
-						if(result.excluded_hidden_spheres_ids.count(i)==0)
-						{
-							refined_spheres.push_back(bsh.leaves_spheres()[i]);
-							refined_spheres_backward_mapping.push_back(i);
-						}
-					}
-					bsh=BoundingSpheresHierarchy(refined_spheres, initial_radius_for_spheres_bucketing, 1);
-				}
+				result.excluded_hidden_spheres_ids=exclude_hidden_spheres_from_hierarchy(initial_radius_for_spheres_bucketing, number_of_threads, bsh, refined_spheres_backward_mapping);
 			}
 
-			result.quadruples_search_log=find_valid_quadruples(bsh, std::vector<int>(bsh.leaves_spheres().size(), 1), result.quadruples_map);
+			result.quadruples_search_log=search_for_valid_quadruples(bsh, result.quadruples_map);
 			if(include_surplus_valid_quadruples)
 			{
-				result.surplus_quadruples_search_log=find_surplus_valid_quadruples(bsh, result.quadruples_map);
+				result.surplus_quadruples_search_log=find_surplus_valid_quadruples(bsh, result.quadruples_map, number_of_threads);
 			}
 
 			if(!refined_spheres_backward_mapping.empty())
@@ -113,6 +96,83 @@ public:
 		return result;
 	}
 
+	// Same as construct_result, but the spheres are processed in the spatial order for better memory locality,
+	// and all the resulting ids refer to the original order
+	static Result construct_result_in_spatial_order(
+			const std::vector<SimpleSphere>& spheres,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const bool include_surplus_valid_quadruples,
+			const std::size_t number_of_threads=1)
+	{
+		const std::vector<std::size_t> order=SpatialOrderingOfSpheres::calc_morton_order(spheres);
+		Result result=construct_result(SpatialOrderingOfSpheres::apply_order(spheres, order), initial_radius_for_spheres_bucketing, exclude_hidden_spheres, include_surplus_valid_quadruples, number_of_threads);
+		result.quadruples_map=renumber_quadruples_map(result.quadruples_map, order);
+		result.excluded_hidden_spheres_ids=renumber_ids(result.excluded_hidden_spheres_ids, order);
+		result.ignored_spheres_ids=renumber_ids(result.ignored_spheres_ids, order);
+		return result;
+	}
+
+	// Produces the same neighbors as construct_result followed by the collection of the neighbors graph from the quadruples map,
+	// but the found quadruples and their tangent spheres are not kept, only the neighborhood relations
+	static CompressedNeighborsGraph construct_neighbors_graph(
+			const std::vector<SimpleSphere>& spheres,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const std::size_t number_of_threads=1)
+	{
+		QuadruplesSearchLog unused_log;
+		return construct_neighbors_graph(spheres, initial_radius_for_spheres_bucketing, exclude_hidden_spheres, number_of_threads, unused_log);
+	}
+
+	// The log counts every recorded quadruple (a quadruple found from several faces is counted for each of them),
+	// added_tangent_spheres stays zero
+	static CompressedNeighborsGraph construct_neighbors_graph(
+			const std::vector<SimpleSphere>& spheres,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const std::size_t number_of_threads,
+			QuadruplesSearchLog& quadruples_search_log)
+	{
+		NeighborsGraphBuilder neighbors_graph_builder;
+		std::vector<std::size_t> refined_spheres_backward_mapping;
+
+		{
+			BoundingSpheresHierarchy bsh(spheres, initial_radius_for_spheres_bucketing, 1);
+
+			if(exclude_hidden_spheres)
+			{
+				exclude_hidden_spheres_from_hierarchy(initial_radius_for_spheres_bucketing, number_of_threads, bsh, refined_spheres_backward_mapping);
+			}
+
+			quadruples_search_log=find_valid_quadruples(bsh, std::vector<int>(bsh.leaves_spheres().size(), 1), neighbors_graph_builder);
+		}
+
+		return neighbors_graph_builder.collect_neighbors_graph(spheres.size(), refined_spheres_backward_mapping);
+	}
+
+	static CompressedNeighborsGraph construct_neighbors_graph_in_spatial_order(
+			const std::vector<SimpleSphere>& spheres,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const std::size_t number_of_threads=1)
+	{
+		const std::vector<std::size_t> order=SpatialOrderingOfSpheres::calc_morton_order(spheres);
+		return renumber_neighbors_graph(construct_neighbors_graph(SpatialOrderingOfSpheres::apply_order(spheres, order), initial_radius_for_spheres_bucketing, exclude_hidden_spheres, number_of_threads), order);
+	}
+
+	// Validating the candidates for d in batches gives the same quadruples more slowly, it is an option only for the benchmark
+	static QuadruplesSearchLog search_for_valid_quadruples(const BoundingSpheresHierarchy& bsh, QuadruplesMap& quadruples_map, const bool validate_d_in_batches=false)
+	{
+		quadruples_map.reserve(bsh.leaves_spheres().size()*expected_number_of_quadruples_per_sphere());
+		return find_valid_quadruples(bsh, std::vector<int>(bsh.leaves_spheres().size(), 1), quadruples_map, validate_d_in_batches);
+	}
+
+	static SurplusQuadruplesSearchLog search_for_surplus_valid_quadruples(const BoundingSpheresHierarchy& bsh, const std::size_t number_of_threads, QuadruplesMap& quadruples_map)
+	{
+		return find_surplus_valid_quadruples(bsh, quadruples_map, number_of_threads);
+	}
+
 	template<typename AdmittanceSet>
 	static Result construct_result_for_admittance_set(
 			const BoundingSpheresHierarchy& bsh,
@@ -143,12 +203,129 @@ public:
 		return result;
 	}
 
+	static Result update_result(
+			const std::vector<SimpleSphere>& spheres,
+			const Result& previous_result,
+			const std::set<std::size_t>& moved_spheres_ids,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const bool include_surplus_valid_quadruples)
+	{
+		Result result;
+
+		BoundingSpheresHierarchy bsh(spheres, initial_radius_for_spheres_bucketing, 1);
+
+		if(exclude_hidden_spheres)
+		{
+			result.excluded_hidden_spheres_ids=SearchForSphericalCollisions::find_all_hidden_spheres(bsh);
+		}
+
+		if(result.excluded_hidden_spheres_ids!=previous_result.excluded_hidden_spheres_ids)
+		{
+			return construct_result(spheres, initial_radius_for_spheres_bucketing, exclude_hidden_spheres, include_surplus_valid_quadruples);
+		}
+
+		std::vector<std::size_t> refined_spheres_forward_mapping;
+		std::vector<std::size_t> refined_spheres_backward_mapping;
+		if(!result.excluded_hidden_spheres_ids.empty())
+		{
+			std::vector<SimpleSphere> refined_spheres;
+			refined_spheres_forward_mapping.resize(spheres.size(), npos);
+			for(std::size_t i=0;i<spheres.size();i++)
+			{
+				if(result.excluded_hidden_spheres_ids.count(i)==0)
+				{
+					refined_spheres_forward_mapping[i]=refined_spheres.size();
+					refined_spheres.push_back(spheres[i]);
+					refined_spheres_backward_mapping.push_back(i);
+				}
+			}
+			bsh=BoundingSpheresHierarchy(refined_spheres, initial_radius_for_spheres_bucketing, 1);
+		}
+
+		std::vector<int> moved_spheres_mapping(bsh.leaves_spheres().size(), 0);
+		std::vector<SimpleSphere> moved_spheres;
+		std::set<std::size_t> affected_spheres_ids;
+		for(std::set<std::size_t>::const_iterator it=moved_spheres_ids.begin();it!=moved_spheres_ids.end();++it)
+		{
+			const std::size_t id=(refined_spheres_forward_mapping.empty() ? (*it) : ((*it)<refined_spheres_forward_mapping.size() ? refined_spheres_forward_mapping[*it] : npos));
+			if(id<moved_spheres_mapping.size())
+			{
+				moved_spheres_mapping[id]=1;
+				moved_spheres.push_back(bsh.leaves_spheres()[id]);
+				affected_spheres_ids.insert(id);
+			}
+		}
+
+		if(moved_spheres.empty())
+		{
+			return previous_result;
+		}
+
+		const BoundingSpheresHierarchy moved_spheres_bsh(moved_spheres, initial_radius_for_spheres_bucketing, 1);
+
+		for(QuadruplesMap::const_iterator it=previous_result.quadruples_map.begin();it!=previous_result.quadruples_map.end();++it)
+		{
+			const Quadruple& q=it->first;
+			const Quadruple rq=(refined_spheres_forward_mapping.empty() ? q : Quadruple(
+					refined_spheres_forward_mapping.at(q.get(0)),
+					refined_spheres_forward_mapping.at(q.get(1)),
+					refined_spheres_forward_mapping.at(q.get(2)),
+					refined_spheres_forward_mapping.at(q.get(3))));
+			if(rq.get(3)<moved_spheres_mapping.size())
+			{
+				TangentSpheres valid_tangent_spheres;
+				if(moved_spheres_mapping[rq.get(0)]==0 && moved_spheres_mapping[rq.get(1)]==0 && moved_spheres_mapping[rq.get(2)]==0 && moved_spheres_mapping[rq.get(3)]==0)
+				{
+					for(std::size_t i=0;i<it->second.size();i++)
+					{
+						if(SearchForSphericalCollisions::find_any_collision(moved_spheres_bsh, it->second[i]).empty())
+						{
+							valid_tangent_spheres.push_back(it->second[i]);
+						}
+					}
+				}
+				if(!valid_tangent_spheres.empty())
+				{
+					result.quadruples_map[rq]=valid_tangent_spheres;
+				}
+				if(valid_tangent_spheres.size()<it->second.size())
+				{
+					for(int i=0;i<4;i++)
+					{
+						affected_spheres_ids.insert(rq.get(i));
+					}
+				}
+			}
+		}
+
+		{
+			const Result partial_result=construct_result_for_admittance_set(bsh, affected_spheres_ids, false);
+			merge_quadruples_maps(partial_result.quadruples_map, result.quadruples_map);
+			result.quadruples_search_log=partial_result.quadruples_search_log;
+		}
+
+		if(include_surplus_valid_quadruples)
+		{
+			result.surplus_quadruples_search_log=find_surplus_valid_quadruples(bsh, result.quadruples_map);
+		}
+
+		if(!refined_spheres_backward_mapping.empty())
+		{
+			result.quadruples_map=renumber_quadruples_map(result.quadruples_map, refined_spheres_backward_mapping);
+		}
+
+		result.ignored_spheres_ids=collect_ignored_spheres_ids(std::vector<int>(spheres.size(), 1), result.quadruples_map);
+
+		return result;
+	}
+
 	static void merge_quadruples_maps(const QuadruplesMap& source_quadruples_map, QuadruplesMap& destination_quadruples_map)
 	{
 		for(QuadruplesMap::const_iterator it=source_quadruples_map.begin();it!=source_quadruples_map.end();++it)
 		{
 			const Quadruple& quadruple=it->first;
-			const std::vector<SimpleSphere>& tangent_spheres=it->second;
+			const TangentSpheres& tangent_spheres=it->second;
 			for(std::size_t i=0;i<tangent_spheres.size();i++)
 			{
 				augment_quadruples_map(quadruple, tangent_spheres[i], destination_quadruples_map);
@@ -168,7 +345,7 @@ public:
 		vertices_vector.reserve(count_tangent_spheres_in_quadruples_map(quadruples_map));
 		for(QuadruplesOrderedMultimap::const_iterator it=quadruples_ordered_multimap.begin();it!=quadruples_ordered_multimap.end();++it)
 		{
-			const std::vector<SimpleSphere>& tangent_spheres=it->second;
+			const TangentSpheres& tangent_spheres=it->second;
 			if(tangent_spheres.size()==1)
 			{
 				vertices_vector.push_back(std::make_pair(it->first, tangent_spheres.front()));
@@ -202,6 +379,19 @@ public:
 		return sum;
 	}
 
+	// Positions of the quadruples in the order of iteration over the hash map that the earlier versions used,
+	// given that the quadruples were inserted in the order of their positions
+	static std::vector<std::size_t> calc_legacy_order_of_quadruples_map(const QuadruplesMap& quadruples_map)
+	{
+		std::vector<std::size_t> hash_values;
+		hash_values.reserve(quadruples_map.size());
+		for(QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
+		{
+			hash_values.push_back(Quadruple::HashFunctor()(it->first));
+		}
+		return LegacyHashOrder::calc_iteration_order(hash_values);
+	}
+
 	template<typename SphereType>
 	static bool check_quadruples_map(const std::vector<SphereType>& spheres, const QuadruplesMap& quadruples_map)
 	{
@@ -230,7 +420,7 @@ public:
 
 	static VerticesGraph construct_vertices_graph(const std::vector<apollota::SimpleSphere>& spheres, const QuadruplesMap& quadruples_map)
 	{
-		typedef std::tr1::unordered_map<Triple, std::vector<std::size_t>, Triple::HashFunctor> TriplesVerticesMap;
+		typedef OpenAddressingHashMap<Triple, std::vector<std::size_t>, Triple::HashFunctor> TriplesVerticesMap;
 
 		const VerticesVector valid_vertices_vector=collect_vertices_vector_from_quadruples_map(quadruples_map);
 		const VerticesVector invalid_vertices_vector=collect_vertices_vector_from_quadruples_map(collect_invalid_tangent_spheres_of_valid_quadruples(spheres, quadruples_map));
@@ -302,52 +492,44 @@ private:
 					);
 		}
 
-		std::pair<bool, SimpleSphere> check_candidate_for_d(const std::size_t d_id, const std::size_t d_number) const
+		// Reused by the searches for all faces, so that the candidates processing does not allocate memory for every face
+		struct CandidatesBuffer
 		{
-			if(
+			std::vector<std::size_t> ids;
+			std::vector<SimpleSphere> spheres;
+			std::vector<TangentSpheres> tangent_spheres;
+			TangentSphereOfFourSpheres::BatchWorkspace workspace;
+		};
+
+		bool candidate_for_d_is_admissible(const std::size_t d_id, const std::size_t d_number) const
+		{
+			return (
 					can_have_d_
 					&& (d_id!=npos)
 					&& (d_number<2)
 					&& (d_id!=d_ids_and_tangent_spheres_[d_number].first)
 					&& (!abc_ids_.contains(d_id))
 					&& (halfspace_of_sphere(tangent_planes_[d_number].first, tangent_planes_[d_number].second, spheres_->at(d_id))>=0)
-				)
+				);
+		}
+
+		std::pair<bool, SimpleSphere> check_candidate_for_d(const std::size_t d_id, const std::size_t d_number) const
+		{
+			if(candidate_for_d_is_admissible(d_id, d_number))
 			{
-				const std::vector<SimpleSphere> tangent_spheres=TangentSphereOfFourSpheres::calculate((*a_sphere_), (*b_sphere_), (*c_sphere_), spheres_->at(d_id));
-				if(!tangent_spheres.empty())
-				{
-					std::size_t i=0;
-					if(tangent_spheres.size()==2)
-					{
-						const double hs0=halfspace_of_point(central_planes_[d_number].first, central_planes_[d_number].second, tangent_spheres[0]);
-						const double hs1=halfspace_of_point(central_planes_[d_number].first, central_planes_[d_number].second, tangent_spheres[1]);
-						if(hs0==1 && hs1==-1)
-						{
-							i=0;
-						}
-						else if(hs0==-1 && hs1==1)
-						{
-							i=1;
-						}
-						else if(hs0==-1 && hs1==-1)
-						{
-							i=(tangent_spheres[0].r<tangent_spheres[1].r ? 0 : 1);
-						}
-						else if(hs0==1 && hs1==1)
-						{
-							i=(tangent_spheres[0].r>tangent_spheres[1].r ? 0 : 1);
-						}
-					}
-					const SimpleSphere& tangent_sphere=tangent_spheres[i];
-					if(!sphere_intersects_recorded_sphere(d_ids_and_tangent_spheres_, tangent_sphere) && !sphere_intersects_recorded_sphere(e_ids_and_tangent_spheres_, tangent_sphere))
-					{
-						return std::make_pair(true, tangent_sphere);
-					}
-				}
+				TangentSpheres tangent_spheres;
+				TangentSphereOfFourSpheres::calculate((*a_sphere_), (*b_sphere_), (*c_sphere_), spheres_->at(d_id), tangent_spheres);
+				return select_tangent_sphere_for_d(tangent_spheres, d_number);
 			}
 			return std::make_pair(false, SimpleSphere());
 		}
 
+		// For admissible candidates whose tangent spheres were calculated by calculate_tangent_spheres_for_candidates
+		std::pair<bool, SimpleSphere> check_calculated_candidate_for_d(const TangentSpheres& tangent_spheres, const std::size_t d_number) const
+		{
+			return select_tangent_sphere_for_d(tangent_spheres, d_number);
+		}
+
 		void set_d(const std::size_t d_id, const std::size_t d_number, const SimpleSphere& tangent_sphere)
 		{
 			if(can_have_d_ && d_number<2 && d_ids_and_tangent_spheres_[d_number].first!=d_id)
@@ -438,30 +620,40 @@ private:
 					);
 		}
 
-		std::vector<SimpleSphere> check_candidate_for_e(const std::size_t e_id) const
+		bool candidate_for_e_is_admissible(const std::size_t e_id) const
 		{
-			if(
+			return (
 					can_have_e_
 					&& (e_id!=npos)
 					&& (!abc_ids_.contains(e_id))
 					&& (!can_have_d_ || (e_id!=d_ids_and_tangent_spheres_[0].first && e_id!=d_ids_and_tangent_spheres_[1].first))
 					&& (!can_have_d_ || !middle_region_approximation_sphere_.first || sphere_intersects_sphere(middle_region_approximation_sphere_.second, spheres_->at(e_id)))
 					&& (!can_have_d_ || (halfspace_of_sphere(tangent_planes_[0].first, tangent_planes_[0].second, spheres_->at(e_id))==-1 && halfspace_of_sphere(tangent_planes_[1].first, tangent_planes_[1].second, spheres_->at(e_id))==-1))
-				)
+				);
+		}
+
+		const std::vector<TangentSpheres>& calculate_tangent_spheres_for_candidates(const std::vector<std::size_t>& ids, CandidatesBuffer& buffer) const
+		{
+			buffer.spheres.clear();
+			for(std::size_t i=0;i<ids.size();i++)
+			{
+				buffer.spheres.push_back(spheres_->at(ids[i]));
+			}
+			TangentSphereOfFourSpheres::calculate_for_candidates((*a_sphere_), (*b_sphere_), (*c_sphere_), buffer.spheres, buffer.workspace, buffer.tangent_spheres);
+			return buffer.tangent_spheres;
+		}
+
+		TangentSpheres select_free_tangent_spheres(const TangentSpheres& tangent_spheres) const
+		{
+			TangentSpheres free_tangent_spheres;
+			for(std::size_t i=0;i<tangent_spheres.size();i++)
 			{
-				const std::vector<SimpleSphere> tangent_spheres=TangentSphereOfFourSpheres::calculate((*a_sphere_), (*b_sphere_), (*c_sphere_), spheres_->at(e_id));
-				std::vector<SimpleSphere> valid_tangent_spheres;
-				for(std::size_t i=0;i<tangent_spheres.size();i++)
+				if(tangent_sphere_is_free(tangent_spheres[i]))
 				{
-					const SimpleSphere& tangent_sphere=tangent_spheres[i];
-					if(!sphere_intersects_recorded_sphere(d_ids_and_tangent_spheres_, tangent_sphere) && !sphere_intersects_recorded_sphere(e_ids_and_tangent_spheres_, tangent_sphere))
-					{
-						valid_tangent_spheres.push_back(tangent_sphere);
-					}
+					free_tangent_spheres.push_back(tangent_spheres[i]);
 				}
-				return valid_tangent_spheres;
 			}
-			return std::vector<SimpleSphere>();
+			return free_tangent_spheres;
 		}
 
 		void add_e(const std::size_t e_id, const SimpleSphere& tangent_sphere)
@@ -513,6 +705,46 @@ private:
 		}
 
 	private:
+		std::pair<bool, SimpleSphere> select_tangent_sphere_for_d(const TangentSpheres& tangent_spheres, const std::size_t d_number) const
+		{
+			if(!tangent_spheres.empty())
+			{
+				std::size_t i=0;
+				if(tangent_spheres.size()==2)
+				{
+					const double hs0=halfspace_of_point(central_planes_[d_number].first, central_planes_[d_number].second, tangent_spheres[0]);
+					const double hs1=halfspace_of_point(central_planes_[d_number].first, central_planes_[d_number].second, tangent_spheres[1]);
+					if(hs0==1 && hs1==-1)
+					{
+						i=0;
+					}
+					else if(hs0==-1 && hs1==1)
+					{
+						i=1;
+					}
+					else if(hs0==-1 && hs1==-1)
+					{
+						i=(tangent_spheres[0].r<tangent_spheres[1].r ? 0 : 1);
+					}
+					else if(hs0==1 && hs1==1)
+					{
+						i=(tangent_spheres[0].r>tangent_spheres[1].r ? 0 : 1);
+					}
+				}
+				const SimpleSphere& tangent_sphere=tangent_spheres[i];
+				if(tangent_sphere_is_free(tangent_sphere))
+				{
+					return std::make_pair(true, tangent_sphere);
+				}
+			}
+			return std::make_pair(false, SimpleSphere());
+		}
+
+		bool tangent_sphere_is_free(const SimpleSphere& tangent_sphere) const
+		{
+			return (!sphere_intersects_recorded_sphere(d_ids_and_tangent_spheres_, tangent_sphere) && !sphere_intersects_recorded_sphere(e_ids_and_tangent_spheres_, tangent_sphere));
+		}
+
 		void init_central_planes()
 		{
 			central_planes_.clear();
@@ -690,7 +922,7 @@ private:
 				LeafCheckerForValidD leaf_checker(face, d_number);
 				while(face.has_d(d_number))
 				{
-					const std::vector<std::size_t> results=bsh.search(node_checker, leaf_checker);
+					const std::vector<std::size_t> results=bsh.search_with_leaves_filter(node_checker, leaf_checker);
 					if(results.empty())
 					{
 						return true;
@@ -704,6 +936,47 @@ private:
 			return false;
 		}
 
+		// Gives the same result as find_valid_d, but the candidates of every search are collected first and their tangent spheres are calculated together,
+		// which is slower, because find_valid_d stops at the first valid candidate
+		static bool find_valid_d_in_batches(const BoundingSpheresHierarchy& bsh, Face& face, const std::size_t d_number, Face::CandidatesBuffer& candidates_buffer)
+		{
+			if(face.has_d(d_number))
+			{
+				NodeCheckerForValidD node_checker(face, d_number);
+				OpenAddressingHashSet<std::size_t, IdentityHashFunctor> safety_monitor;
+				while(face.has_d(d_number))
+				{
+					candidates_buffer.ids.clear();
+					LeafCollectorForValidD leaf_collector(face, d_number, candidates_buffer.ids);
+					bsh.search_with_leaves_filter(node_checker, leaf_collector);
+					if(leaf_collector.leaves_count==0)
+					{
+						return true;
+					}
+					bool d_replaced=false;
+					if(!candidates_buffer.ids.empty())
+					{
+						const std::vector<TangentSpheres>& candidates_tangent_spheres=face.calculate_tangent_spheres_for_candidates(candidates_buffer.ids, candidates_buffer);
+						for(std::size_t i=0;i<candidates_buffer.ids.size() && !d_replaced;i++)
+						{
+							const std::pair<bool, SimpleSphere> check_result=face.check_calculated_candidate_for_d(candidates_tangent_spheres[i], d_number);
+							if(check_result.first && safety_monitor.count(candidates_buffer.ids[i])==0)
+							{
+								face.set_d(candidates_buffer.ids[i], d_number, check_result.second);
+								safety_monitor.insert(candidates_buffer.ids[i]);
+								d_replaced=true;
+							}
+						}
+					}
+					if(!d_replaced && face.get_d_id(d_number)!=leaf_collector.last_leaf_id)
+					{
+						face.unset_d(d_number);
+					}
+				}
+			}
+			return false;
+		}
+
 	private:
 		struct NodeCheckerForValidD
 		{
@@ -724,15 +997,20 @@ private:
 		{
 			Face& face;
 			const std::size_t d_number;
-			std::tr1::unordered_set<std::size_t> safety_monitor;
+			OpenAddressingHashSet<std::size_t, IdentityHashFunctor> safety_monitor;
 
 			LeafCheckerForValidD(Face& target, const std::size_t d_number) : face(target), d_number(d_number)
 			{
 			}
 
-			std::pair<bool, bool> operator()(const std::size_t id, const SimpleSphere& sphere)
+			SimpleSphere leaves_filter_sphere() const
 			{
-				if(face.has_d(d_number) && sphere_intersects_sphere(sphere, face.get_d_tangent_sphere(d_number)))
+				return face.get_d_tangent_sphere(d_number);
+			}
+
+			std::pair<bool, bool> operator()(const std::size_t id, const SimpleSphere&)
+			{
+				if(face.has_d(d_number))
 				{
 					const std::pair<bool, SimpleSphere> check_result=face.check_candidate_for_d(id, d_number);
 					if(check_result.first && safety_monitor.count(id)==0)
@@ -749,17 +1027,65 @@ private:
 				return std::make_pair(false, false);
 			}
 		};
+
+		struct LeafCollectorForValidD
+		{
+			const Face& face;
+			const std::size_t d_number;
+			std::vector<std::size_t>& candidates_ids;
+			std::size_t leaves_count;
+			std::size_t last_leaf_id;
+
+			LeafCollectorForValidD(const Face& target, const std::size_t d_number, std::vector<std::size_t>& candidates_ids) : face(target), d_number(d_number), candidates_ids(candidates_ids), leaves_count(0), last_leaf_id(npos)
+			{
+			}
+
+			SimpleSphere leaves_filter_sphere() const
+			{
+				return face.get_d_tangent_sphere(d_number);
+			}
+
+			std::pair<bool, bool> operator()(const std::size_t id, const SimpleSphere&)
+			{
+				leaves_count++;
+				last_leaf_id=id;
+				if(face.candidate_for_d_is_admissible(id, d_number))
+				{
+					candidates_ids.push_back(id);
+				}
+				return std::make_pair(false, false);
+			}
+		};
 	};
 
 	class SearchForValidEOfFace
 	{
 	public:
-		static bool find_valid_e(const BoundingSpheresHierarchy& bsh, Face& face)
+		static bool find_valid_e(const BoundingSpheresHierarchy& bsh, Face& face, Face::CandidatesBuffer& candidates_buffer)
 		{
 			face.update_middle_region_approximation();
 			NodeCheckerForValidE node_checker(face);
-			LeafCheckerForValidE leaf_checker(face, bsh);
-			return !bsh.search(node_checker, leaf_checker).empty();
+			candidates_buffer.ids.clear();
+			LeafCheckerForValidE leaf_checker(face, candidates_buffer.ids);
+			bsh.search(node_checker, leaf_checker);
+			bool e_added=false;
+			if(!leaf_checker.candidates_ids.empty())
+			{
+				const std::vector<TangentSpheres>& candidates_tangent_spheres=face.calculate_tangent_spheres_for_candidates(leaf_checker.candidates_ids, candidates_buffer);
+				for(std::size_t i=0;i<leaf_checker.candidates_ids.size();i++)
+				{
+					const TangentSpheres free_tangent_spheres=face.select_free_tangent_spheres(candidates_tangent_spheres[i]);
+					for(std::size_t j=0;j<free_tangent_spheres.size();j++)
+					{
+						if(SearchForSphericalCollisions::find_any_collision(bsh, free_tangent_spheres[j]).empty())
+						{
+							face.add_e(leaf_checker.candidates_ids[i], free_tangent_spheres[j]);
+							e_added=true;
+						}
+					}
+				}
+			}
+			return e_added;
 		}
 
 	private:
@@ -777,28 +1103,23 @@ private:
 			}
 		};
 
+		// Only collects the candidates, as the tangent spheres for all of them are calculated together after the search
 		struct LeafCheckerForValidE
 		{
-			Face& face;
-			const BoundingSpheresHierarchy& bsh;
+			const Face& face;
+			std::vector<std::size_t>& candidates_ids;
 
-			LeafCheckerForValidE(Face& target, const BoundingSpheresHierarchy& bsh) : face(target), bsh(bsh)
+			LeafCheckerForValidE(const Face& target, std::vector<std::size_t>& candidates_ids) : face(target), candidates_ids(candidates_ids)
 			{
 			}
 
 			std::pair<bool, bool> operator()(const std::size_t id, const SimpleSphere&)
 			{
-				const std::vector<SimpleSphere> check_result=face.check_candidate_for_e(id);
-				bool e_added=false;
-				for(std::size_t i=0;i<check_result.size();i++)
+				if(face.candidate_for_e_is_admissible(id))
 				{
-					if(SearchForSphericalCollisions::find_any_collision(bsh, check_result[i]).empty())
-					{
-						face.add_e(id, check_result[i]);
-						e_added=true;
-					}
+					candidates_ids.push_back(id);
 				}
-				return std::make_pair(e_added, false);
+				return std::make_pair(false, false);
 			}
 		};
 	};
@@ -842,7 +1163,28 @@ private:
 		return result;
 	}
 
-	static std::vector<Face> find_first_valid_faces(
+	// Face that is waiting in the search stack, it is kept in this compact form and constructed only when taken from the stack
+	struct Preface
+	{
+		Triple abc_ids;
+		std::vector< std::pair<std::size_t, SimpleSphere> > d_ids_and_tangent_spheres;
+
+		explicit Preface(const Triple& abc_ids) : abc_ids(abc_ids)
+		{
+		}
+
+		Face construct_face(const BoundingSpheresHierarchy& bsh) const
+		{
+			Face face(bsh.leaves_spheres(), abc_ids, bsh.min_input_radius());
+			for(std::size_t i=0;i<d_ids_and_tangent_spheres.size();i++)
+			{
+				face.set_d_with_d_number_selection(d_ids_and_tangent_spheres[i].first, d_ids_and_tangent_spheres[i].second);
+			}
+			return face;
+		}
+	};
+
+	static std::vector<Preface> find_first_valid_faces(
 			const BoundingSpheresHierarchy& bsh,
 			const std::vector<int>& admittance,
 			const std::size_t starting_sphere_id,
@@ -852,7 +1194,7 @@ private:
 			const std::size_t max_size_of_traversal=std::numeric_limits<std::size_t>::max())
 	{
 		const std::vector<SimpleSphere>& spheres=bsh.leaves_spheres();
-		std::vector<Face> result;
+		std::vector<Preface> result;
 		if(spheres.size()>=4 && starting_sphere_id<spheres.size() && admittance.size()==spheres.size())
 		{
 			const std::vector<std::size_t> traversal=BoundingSpheresHierarchy::sort_objects_by_distance_to_one_of_them(spheres, starting_sphere_id, minimal_distance_from_sphere_to_sphere<SimpleSphere, SimpleSphere>);
@@ -875,7 +1217,7 @@ private:
 										|| (allow_quadruples_with_two_tangent_spheres && tangents.size()==2 && (SearchForSphericalCollisions::find_any_collision(bsh, tangents.front()).empty() || SearchForSphericalCollisions::find_any_collision(bsh, tangents.back()).empty()))
 									)
 								{
-									result.push_back(Face(bsh.leaves_spheres(), triple, bsh.min_input_radius()));
+									result.push_back(Preface(triple));
 									return result;
 								}
 							}
@@ -900,7 +1242,7 @@ private:
 		}
 		else
 		{
-			std::vector<SimpleSphere>& quadruple_tangent_spheres_list=qm_it->second;
+			TangentSpheres& quadruple_tangent_spheres_list=qm_it->second;
 			if(quadruple_tangent_spheres_list.size()==1 && !spheres_equal(quadruple_tangent_spheres_list.front(), quadruple_tangent_sphere, tangent_spheres_equality_epsilon()))
 			{
 				quadruple_tangent_spheres_list.push_back(quadruple_tangent_sphere);
@@ -910,27 +1252,41 @@ private:
 		return std::make_pair(quadruple_added, quadruple_tangent_sphere_added);
 	}
 
-	static QuadruplesSearchLog find_valid_quadruples(const BoundingSpheresHierarchy& bsh, const std::vector<int>& admittance, QuadruplesMap& quadruples_map)
+	static std::pair<bool, bool> record_quadruple(const Quadruple& quadruple, const SimpleSphere& quadruple_tangent_sphere, QuadruplesMap& quadruples_map)
+	{
+		return augment_quadruples_map(quadruple, quadruple_tangent_sphere, quadruples_map);
+	}
+
+	// Tangent spheres are not kept by the builder, so only the quadruple is reported as added
+	static std::pair<bool, bool> record_quadruple(const Quadruple& quadruple, const SimpleSphere&, NeighborsGraphBuilder& neighbors_graph_builder)
+	{
+		neighbors_graph_builder.add_quadruple(quadruple);
+		return std::make_pair(true, false);
+	}
+
+	template<typename QuadruplesStorage>
+	static QuadruplesSearchLog find_valid_quadruples(const BoundingSpheresHierarchy& bsh, const std::vector<int>& admittance, QuadruplesStorage& quadruples_storage, const bool validate_d_in_batches=false)
 	{
-		typedef std::tr1::unordered_map<Triple, std::size_t, Triple::HashFunctor> TriplesMap;
+		typedef OpenAddressingHashMap<Triple, std::size_t, Triple::HashFunctor> TriplesMap;
 
 		QuadruplesSearchLog log=QuadruplesSearchLog();
 
-		std::vector<Face> stack=find_first_valid_faces(bsh, admittance, select_starting_sphere_for_finding_first_valid_faces(bsh, admittance), log.performed_iterations_for_finding_first_faces, false, true);
-		std::tr1::unordered_set<Triple, Triple::HashFunctor> processed_triples_set;
+		std::vector<Preface> stack=find_first_valid_faces(bsh, admittance, select_starting_sphere_for_finding_first_valid_faces(bsh, admittance), log.performed_iterations_for_finding_first_faces, false, true);
+		OpenAddressingHashSet<Triple, Triple::HashFunctor> processed_triples_set;
 		std::vector<int> spheres_usage_mapping(bsh.leaves_spheres().size(), 0);
 		std::set<std::size_t> ignorable_spheres_ids;
+		Face::CandidatesBuffer candidates_buffer;
 
 		do
 		{
 			TriplesMap stack_map;
 			for(std::size_t i=0;i<stack.size();i++)
 			{
-				stack_map[stack[i].abc_ids()]=i;
+				stack_map[stack[i].abc_ids]=i;
 			}
 			while(!stack.empty())
 			{
-				Face face=stack.back();
+				Face face=stack.back().construct_face(bsh);
 				stack.pop_back();
 				stack_map.erase(face.abc_ids());
 				processed_triples_set.insert(face.abc_ids());
@@ -939,16 +1295,18 @@ private:
 				{
 					log.encountered_difficult_faces++;
 				}
-				const bool found_d0=face.can_have_d() && !face.has_d(0) && SearchForAnyDOfFace::find_any_d(bsh, face, 0) && SearchForValidDOfFace::find_valid_d(bsh, face, 0);
-				const bool found_d1=face.can_have_d() && !face.has_d(1) && SearchForAnyDOfFace::find_any_d(bsh, face, 1) && SearchForValidDOfFace::find_valid_d(bsh, face, 1);
-				const bool found_e=face.can_have_e() && SearchForValidEOfFace::find_valid_e(bsh, face);
+				const bool found_d0=face.can_have_d() && !face.has_d(0) && SearchForAnyDOfFace::find_any_d(bsh, face, 0)
+						&& (validate_d_in_batches ? SearchForValidDOfFace::find_valid_d_in_batches(bsh, face, 0, candidates_buffer) : SearchForValidDOfFace::find_valid_d(bsh, face, 0));
+				const bool found_d1=face.can_have_d() && !face.has_d(1) && SearchForAnyDOfFace::find_any_d(bsh, face, 1)
+						&& (validate_d_in_batches ? SearchForValidDOfFace::find_valid_d_in_batches(bsh, face, 1, candidates_buffer) : SearchForValidDOfFace::find_valid_d(bsh, face, 1));
+				const bool found_e=face.can_have_e() && SearchForValidEOfFace::find_valid_e(bsh, face, candidates_buffer);
 				if(found_d0 || found_d1 || found_e)
 				{
 					{
 						const std::vector< std::pair<Quadruple, SimpleSphere> > additional_quadruples=face.produce_quadruples(found_d0, found_d1, found_e);
 						for(std::size_t i=0;i<additional_quadruples.size();i++)
 						{
-							const std::pair<bool, bool> augmention_status=augment_quadruples_map(additional_quadruples[i].first, additional_quadruples[i].second, quadruples_map);
+							const std::pair<bool, bool> augmention_status=record_quadruple(additional_quadruples[i].first, additional_quadruples[i].second, quadruples_storage);
 							log.added_quadruples+=(augmention_status.first ? 1 : 0);
 							log.added_tangent_spheres+=(augmention_status.second ? 1 : 0);
 						}
@@ -966,13 +1324,13 @@ private:
 									if(sm_it==stack_map.end())
 									{
 										stack_map[produced_preface.first]=stack.size();
-										stack.push_back(Face(bsh.leaves_spheres(), produced_preface.first, bsh.min_input_radius()));
-										stack.back().set_d_with_d_number_selection(produced_preface.second.first, produced_preface.second.second);
+										stack.push_back(Preface(produced_preface.first));
+										stack.back().d_ids_and_tangent_spheres.push_back(produced_preface.second);
 										log.produced_faces++;
 									}
 									else
 									{
-										stack.at(sm_it->second).set_d_with_d_number_selection(produced_preface.second.first, produced_preface.second.second);
+										stack.at(sm_it->second).d_ids_and_tangent_spheres.push_back(produced_preface.second);
 										log.updated_faces++;
 									}
 								}
@@ -1009,58 +1367,99 @@ private:
 		return log;
 	}
 
-	static SurplusQuadruplesSearchLog find_surplus_valid_quadruples(const BoundingSpheresHierarchy& bsh, QuadruplesMap& quadruples_map)
+	static SurplusQuadruplesSearchLog find_surplus_valid_quadruples(const BoundingSpheresHierarchy& bsh, QuadruplesMap& quadruples_map, const std::size_t number_of_threads=1)
 	{
 		SurplusQuadruplesSearchLog log=SurplusQuadruplesSearchLog();
+		std::vector<SimpleSphere> tangent_spheres;
+		tangent_spheres.reserve(quadruples_map.size());
+		const std::vector<std::size_t> order=calc_legacy_order_of_quadruples_map(quadruples_map);
+		for(std::size_t i=0;i<order.size();i++)
+		{
+			const TangentSpheres& quadruple_tangent_spheres=(quadruples_map.begin()+order[i])->second;
+			tangent_spheres.insert(tangent_spheres.end(), quadruple_tangent_spheres.begin(), quadruple_tangent_spheres.end());
+		}
 		std::vector< std::pair<Quadruple, SimpleSphere> > surplus_candidates;
-		for(QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
+		if(number_of_threads<2)
 		{
-			const std::vector<SimpleSphere>& tangent_spheres=it->second;
-			for(std::size_t i=0;i<tangent_spheres.size();i++)
+			collect_surplus_candidates_in_range(bsh, tangent_spheres, 0, tangent_spheres.size(), surplus_candidates);
+		}
+		else
+		{
+			const std::size_t block_size=256;
+			const int blocks_count=static_cast<int>((tangent_spheres.size()+block_size-1)/block_size);
+			std::vector< std::vector< std::pair<Quadruple, SimpleSphere> > > blocks_surplus_candidates(blocks_count);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+			for(int i=0;i<blocks_count;i++)
 			{
-				const SimpleSphere& tangent_sphere=tangent_spheres[i];
-				const SimpleSphere expanded_tangent_sphere(tangent_sphere, tangent_sphere.r+tangent_spheres_equality_epsilon());
-				const std::vector<std::size_t> expanded_collisions=SearchForSphericalCollisions::find_all_collisions(bsh, expanded_tangent_sphere);
-				std::vector<std::size_t> refined_collisions;
-				for(std::size_t j=0;j<expanded_collisions.size();j++)
+				const std::size_t begin=static_cast<std::size_t>(i)*block_size;
+				collect_surplus_candidates_in_range(bsh, tangent_spheres, begin, std::min(begin+block_size, tangent_spheres.size()), blocks_surplus_candidates[i]);
+			}
+			for(std::size_t i=0;i<blocks_surplus_candidates.size();i++)
+			{
+				surplus_candidates.insert(surplus_candidates.end(), blocks_surplus_candidates[i].begin(), blocks_surplus_candidates[i].end());
+			}
+		}
+		for(std::size_t i=0;i<surplus_candidates.size();i++)
+		{
+			const std::pair<bool, bool> augmention_status=augment_quadruples_map(surplus_candidates[i].first, surplus_candidates[i].second, quadruples_map);
+			log.surplus_quadruples+=(augmention_status.first ? 1 : 0);
+			log.surplus_tangent_spheres+=(augmention_status.second ? 1 : 0);
+		}
+		return log;
+	}
+
+	static void collect_surplus_candidates_in_range(
+			const BoundingSpheresHierarchy& bsh,
+			const std::vector<SimpleSphere>& tangent_spheres,
+			const std::size_t begin,
+			const std::size_t end,
+			std::vector< std::pair<Quadruple, SimpleSphere> >& surplus_candidates)
+	{
+		std::vector<std::size_t> refined_collisions;
+		for(std::size_t i=begin;i<end;i++)
+		{
+			const SimpleSphere& tangent_sphere=tangent_spheres[i];
+			const SimpleSphere expanded_tangent_sphere(tangent_sphere, tangent_sphere.r+tangent_spheres_equality_epsilon());
+			const std::vector<std::size_t> expanded_collisions=SearchForSphericalCollisions::find_all_collisions(bsh, expanded_tangent_sphere);
+			refined_collisions.clear();
+			for(std::size_t j=0;j<expanded_collisions.size();j++)
+			{
+				if(sphere_touches_sphere(tangent_sphere, bsh.leaves_spheres().at(expanded_collisions[j])))
 				{
-					if(sphere_touches_sphere(tangent_sphere, bsh.leaves_spheres().at(expanded_collisions[j])))
-					{
-						refined_collisions.push_back(expanded_collisions[j]);
-					}
+					refined_collisions.push_back(expanded_collisions[j]);
 				}
-				if(refined_collisions.size()>4)
+			}
+			if(refined_collisions.size()>4)
+			{
+				for(std::size_t a=0;a<refined_collisions.size();a++)
 				{
-					for(std::size_t a=0;a<refined_collisions.size();a++)
+					for(std::size_t b=a+1;b<refined_collisions.size();b++)
 					{
-						for(std::size_t b=a+1;b<refined_collisions.size();b++)
+						for(std::size_t c=b+1;c<refined_collisions.size();c++)
 						{
-							for(std::size_t c=b+1;c<refined_collisions.size();c++)
+							for(std::size_t d=c+1;d<refined_collisions.size();d++)
 							{
-								for(std::size_t d=c+1;d<refined_collisions.size();d++)
-								{
-									surplus_candidates.push_back(std::make_pair(Quadruple(refined_collisions[a], refined_collisions[b], refined_collisions[c], refined_collisions[d]), tangent_sphere));
-								}
+								surplus_candidates.push_back(std::make_pair(Quadruple(refined_collisions[a], refined_collisions[b], refined_collisions[c], refined_collisions[d]), tangent_sphere));
 							}
 						}
 					}
 				}
 			}
 		}
-		for(std::size_t i=0;i<surplus_candidates.size();i++)
-		{
-			const std::pair<bool, bool> augmention_status=augment_quadruples_map(surplus_candidates[i].first, surplus_candidates[i].second, quadruples_map);
-			log.surplus_quadruples+=(augmention_status.first ? 1 : 0);
-			log.surplus_tangent_spheres+=(augmention_status.second ? 1 : 0);
-		}
-		return log;
 	}
 
+	// The quadruples are taken in the order in which the earlier versions iterated them,
+	// so the renumbered map keeps the same order of insertion as in the earlier versions
 	static QuadruplesMap renumber_quadruples_map(const QuadruplesMap& quadruples_map, const std::vector<std::size_t>& mapping)
 	{
 		QuadruplesMap renumbered_quadruples_map;
-		for(QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
+		renumbered_quadruples_map.reserve(quadruples_map.size());
+		const std::vector<std::size_t> order=calc_legacy_order_of_quadruples_map(quadruples_map);
+		for(std::size_t i=0;i<order.size();i++)
 		{
+			const QuadruplesMap::const_iterator it=quadruples_map.begin()+order[i];
 			const Quadruple& q=it->first;
 			if(q.get(3)<mapping.size())
 			{
@@ -1074,6 +1473,68 @@ private:
 		return renumbered_quadruples_map;
 	}
 
+	static CompressedNeighborsGraph renumber_neighbors_graph(const CompressedNeighborsGraph& graph, const std::vector<std::size_t>& mapping)
+	{
+		CompressedNeighborsGraph renumbered_graph;
+		renumbered_graph.offsets.assign(graph.size()+1, 0);
+		for(std::size_t i=0;i<graph.size();i++)
+		{
+			renumbered_graph.offsets[mapping.at(i)+1]=graph.count_neighbors(i);
+		}
+		for(std::size_t i=0;i<graph.size();i++)
+		{
+			renumbered_graph.offsets[i+1]+=renumbered_graph.offsets[i];
+		}
+		renumbered_graph.ids.resize(renumbered_graph.offsets.back());
+		for(std::size_t i=0;i<graph.size();i++)
+		{
+			const NeighborsRange neighbors=graph.neighbors(i);
+			std::vector<std::size_t>::iterator output=renumbered_graph.ids.begin()+renumbered_graph.offsets[mapping[i]];
+			for(NeighborsRange::const_iterator it=neighbors.begin();it!=neighbors.end();++it)
+			{
+				*(output++)=mapping.at(*it);
+			}
+		}
+		renumbered_graph.sort_and_remove_duplicates_in_rows(1);
+		return renumbered_graph;
+	}
+
+	static std::set<std::size_t> renumber_ids(const std::set<std::size_t>& ids, const std::vector<std::size_t>& mapping)
+	{
+		std::set<std::size_t> renumbered_ids;
+		for(std::set<std::size_t>::const_iterator it=ids.begin();it!=ids.end();++it)
+		{
+			renumbered_ids.insert(mapping.at(*it));
+		}
+		return renumbered_ids;
+	}
+
+	static std::set<std::size_t> exclude_hidden_spheres_from_hierarchy(
+			const double initial_radius_for_spheres_bucketing,
+			const std::size_t number_of_threads,
+			BoundingSpheresHierarchy& bsh,
+			std::vector<std::size_t>& refined_spheres_backward_mapping)
+	{
+		const std::set<std::size_t> hidden_spheres_ids=SearchForSphericalCollisions::find_all_hidden_spheres(bsh, number_of_threads);
+		if(!hidden_spheres_ids.empty())
+		{
+			std::vector<SimpleSphere> refined_spheres;
+			const std::size_t refined_spheres_count=bsh.leaves_spheres().size()-hidden_spheres_ids.size();
+			refined_spheres.reserve(refined_spheres_count);
+			refined_spheres_backward_mapping.reserve(refined_spheres_count);
+			for(std::size_t i=0;i<bsh.leaves_spheres().size();i++)
+			{
+				if(hidden_spheres_ids.count(i)==0)
+				{
+					refined_spheres.push_back(bsh.leaves_spheres()[i]);
+					refined_spheres_backward_mapping.push_back(i);
+				}
+			}
+			bsh=BoundingSpheresHierarchy(refined_spheres, initial_radius_for_spheres_bucketing, 1);
+		}
+		return hidden_spheres_ids;
+	}
+
 	static std::set<std::size_t> collect_ignored_spheres_ids(const std::vector<int>& admittance, const QuadruplesMap& quadruples_map)
 	{
 		std::set<std::size_t> ignored_spheres_ids;
@@ -1099,6 +1560,11 @@ private:
 		return ignored_spheres_ids;
 	}
 
+	inline static std::size_t expected_number_of_quadruples_per_sphere()
+	{
+		return 7;
+	}
+
 	inline static double tangent_spheres_equality_epsilon()
 	{
 		return std::max(default_comparison_epsilon(), 0.001);
@@ -1110,7 +1576,7 @@ private:
 		for(QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
 		{
 			const Quadruple& q=it->first;
-			const std::vector<SimpleSphere>& valid_tangent_spheres=it->second;
+			const TangentSpheres& valid_tangent_spheres=it->second;
 			if(valid_tangent_spheres.size()==1 && q.get(0)<spheres.size() && q.get(1)<spheres.size() && q.get(2)<spheres.size() && q.get(3)<spheres.size())
 			{
 				const std::vector<SimpleSphere> all_tangent_spheres=TangentSphereOfFourSpheres::calculate(spheres[q.get(0)], spheres[q.get(1)], spheres[q.get(2)], spheres[q.get(3)]);
@@ -2,6 +2,8 @@
 #define APOLLOTA_UTILITIES_FOR_TRIANGULATION_H_
 
 #include "triangulation.h"
+#include "compressed_neighbors_graph.h"
+#include "legacy_hash_order.h"
 
 namespace apollota
 {
@@ -9,10 +11,6 @@ namespace apollota
 class UtilitiesForTriangulation
 {
 public:
-	typedef std::tr1::unordered_map<std::size_t, std::tr1::unordered_set<std::size_t> > NeighborsMap;
-	typedef std::vector< std::vector<std::size_t> > NeighborsGraph;
-	typedef std::tr1::unordered_map<Pair, std::tr1::unordered_set<std::size_t>, Pair::HashFunctor> PairsNeighborsMap;
-
 	template<typename T>
 	static std::vector<SimpleSphere> collect_simple_spheres(const T& spheres)
 	{
@@ -25,59 +23,208 @@ public:
 		return result;
 	}
 
-	static NeighborsMap collect_neighbors_map_from_quadruples_map(const Triangulation::QuadruplesMap& quadruples_map)
+	static CompressedNeighborsGraph collect_neighbors_graph_from_quadruples_map(const Triangulation::QuadruplesMap& quadruples_map, const std::size_t number_of_vertices, const std::size_t number_of_threads=1)
 	{
-		NeighborsMap neighbors_map;
-		for(Triangulation::QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
+		const CompressedNeighborsGraph incidences=collect_quadruples_incidences(quadruples_map, number_of_vertices, number_of_threads);
+		const int blocks_count=static_cast<int>((number_of_vertices+block_size()-1)/block_size());
+		std::vector< std::vector<std::size_t> > blocks_ids(blocks_count);
+		std::vector<std::size_t> sizes(number_of_vertices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+		for(int i=0;i<blocks_count;i++)
 		{
-			const Quadruple& quadruple=it->first;
-			for(int a=0;a<4;a++)
+			std::vector<std::size_t> row;
+			const std::size_t end=std::min(number_of_vertices, static_cast<std::size_t>(i+1)*block_size());
+			for(std::size_t v=static_cast<std::size_t>(i)*block_size();v<end;v++)
 			{
-				for(int b=a+1;b<4;b++)
+				row.clear();
+				const NeighborsRange quadruples_ids=incidences.neighbors(v);
+				for(NeighborsRange::const_iterator it=quadruples_ids.begin();it!=quadruples_ids.end();++it)
 				{
-					neighbors_map[quadruple.get(a)].insert(quadruple.get(b));
-					neighbors_map[quadruple.get(b)].insert(quadruple.get(a));
+					const Quadruple& quadruple=(quadruples_map.begin()+(*it))->first;
+					for(int k=0;k<4;k++)
+					{
+						if(quadruple.get(k)!=v)
+						{
+							row.push_back(quadruple.get(k));
+						}
+					}
 				}
+				std::sort(row.begin(), row.end());
+				row.erase(std::unique(row.begin(), row.end()), row.end());
+				sizes[v]=row.size();
+				blocks_ids[i].insert(blocks_ids[i].end(), row.begin(), row.end());
 			}
 		}
-		return neighbors_map;
+		CompressedNeighborsGraph result;
+		result.offsets.assign(number_of_vertices+1, 0);
+		for(std::size_t v=0;v<number_of_vertices;v++)
+		{
+			result.offsets[v+1]=result.offsets[v]+sizes[v];
+		}
+		result.ids.reserve(result.offsets.back());
+		for(std::size_t i=0;i<blocks_ids.size();i++)
+		{
+			result.ids.insert(result.ids.end(), blocks_ids[i].begin(), blocks_ids[i].end());
+		}
+		return result;
 	}
 
-	static NeighborsGraph collect_neighbors_graph_from_neighbors_map(const NeighborsMap& neighbors_map, const std::size_t number_of_vertices)
+	// The neighbors of every pair are arranged as the earlier versions arranged them (in hash sets filled while iterating a hash map of quadruples),
+	// because the areas of some faces depend on the order in which the faces are cut by the neighbors
+	static CompressedPairsNeighbors collect_pairs_neighbors_from_quadruples_map(const Triangulation::QuadruplesMap& quadruples_map, const std::size_t number_of_vertices, const std::size_t number_of_threads=1)
 	{
-		NeighborsGraph neighbors_graph(number_of_vertices);
-		for(NeighborsMap::const_iterator it=neighbors_map.begin();it!=neighbors_map.end();++it)
+		const CompressedNeighborsGraph incidences=collect_quadruples_incidences(quadruples_map, number_of_vertices, number_of_threads);
+		const std::vector<std::size_t> quadruples_order=Triangulation::calc_legacy_order_of_quadruples_map(quadruples_map);
+		std::vector<std::size_t> quadruples_ranks(quadruples_order.size(), 0);
+		for(std::size_t i=0;i<quadruples_order.size();i++)
 		{
-			if((it->first)<neighbors_graph.size())
+			quadruples_ranks[quadruples_order[i]]=i;
+		}
+		const int blocks_count=static_cast<int>((number_of_vertices+block_size()-1)/block_size());
+		std::vector< std::vector<Pair> > blocks_pairs(blocks_count);
+		std::vector< std::vector<std::size_t> > blocks_sizes(blocks_count);
+		std::vector< std::vector<std::size_t> > blocks_ids(blocks_count);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+		for(int i=0;i<blocks_count;i++)
+		{
+			std::vector<std::size_t> quadruples_ranks_buffer;
+			std::vector< std::pair<std::size_t, std::size_t> > bc_ids;
+			std::vector<std::size_t> c_ids;
+			const std::size_t end=std::min(number_of_vertices, static_cast<std::size_t>(i+1)*block_size());
+			for(std::size_t a=static_cast<std::size_t>(i)*block_size();a<end;a++)
 			{
-				neighbors_graph[it->first].insert(neighbors_graph[it->first].end(), it->second.begin(), it->second.end());
+				const NeighborsRange incident_quadruples_ids=incidences.neighbors(a);
+				quadruples_ranks_buffer.clear();
+				for(NeighborsRange::const_iterator it=incident_quadruples_ids.begin();it!=incident_quadruples_ids.end();++it)
+				{
+					quadruples_ranks_buffer.push_back(quadruples_ranks[*it]);
+				}
+				std::sort(quadruples_ranks_buffer.begin(), quadruples_ranks_buffer.end());
+				bc_ids.clear();
+				for(std::size_t j=0;j<quadruples_ranks_buffer.size();j++)
+				{
+					const Quadruple& quadruple=(quadruples_map.begin()+quadruples_order[quadruples_ranks_buffer[j]])->first;
+					for(int k=0;k<4;k++)
+					{
+						if(quadruple.get(k)>a)
+						{
+							for(int l=0;l<4;l++)
+							{
+								if(l!=k && quadruple.get(l)!=a)
+								{
+									bc_ids.push_back(std::make_pair(quadruple.get(k), quadruple.get(l)));
+								}
+							}
+						}
+					}
+				}
+				std::stable_sort(bc_ids.begin(), bc_ids.end(), compare_first_ids);
+				for(std::size_t j=0;j<bc_ids.size();)
+				{
+					const std::size_t b=bc_ids[j].first;
+					c_ids.clear();
+					for(;j<bc_ids.size() && bc_ids[j].first==b;j++)
+					{
+						c_ids.push_back(bc_ids[j].second);
+					}
+					LegacyHashOrder::arrange_ids_as_in_set(c_ids);
+					blocks_pairs[i].push_back(Pair(a, b));
+					blocks_sizes[i].push_back(c_ids.size());
+					blocks_ids[i].insert(blocks_ids[i].end(), c_ids.begin(), c_ids.end());
+				}
 			}
 		}
-		return neighbors_graph;
+		CompressedPairsNeighbors result;
+		for(std::size_t i=0;i<blocks_pairs.size();i++)
+		{
+			result.pairs.insert(result.pairs.end(), blocks_pairs[i].begin(), blocks_pairs[i].end());
+		}
+		result.pairs_neighbors.offsets.assign(1, 0);
+		result.pairs_neighbors.offsets.reserve(result.pairs.size()+1);
+		for(std::size_t i=0;i<blocks_sizes.size();i++)
+		{
+			for(std::size_t j=0;j<blocks_sizes[i].size();j++)
+			{
+				result.pairs_neighbors.offsets.push_back(result.pairs_neighbors.offsets.back()+blocks_sizes[i][j]);
+			}
+		}
+		result.pairs_neighbors.ids.reserve(result.pairs_neighbors.offsets.back());
+		for(std::size_t i=0;i<blocks_ids.size();i++)
+		{
+			result.pairs_neighbors.ids.insert(result.pairs_neighbors.ids.end(), blocks_ids[i].begin(), blocks_ids[i].end());
+		}
+		return result;
+	}
+
+private:
+	static std::size_t block_size()
+	{
+		return 256;
+	}
+
+	static bool compare_first_ids(const std::pair<std::size_t, std::size_t>& a, const std::pair<std::size_t, std::size_t>& b)
+	{
+		return (a.first<b.first);
 	}
 
-	static PairsNeighborsMap collect_pairs_neighbors_map_from_quadruples_map(const Triangulation::QuadruplesMap& quadruples_map)
+	// Counting sort of the quadruples (their positions in the map) by the ids of their spheres
+	static CompressedNeighborsGraph collect_quadruples_incidences(const Triangulation::QuadruplesMap& quadruples_map, const std::size_t number_of_vertices, const std::size_t number_of_threads)
 	{
-		PairsNeighborsMap pairs_neighbors_map;
-		for(Triangulation::QuadruplesMap::const_iterator it=quadruples_map.begin();it!=quadruples_map.end();++it)
+		const int quadruples_count=static_cast<int>(quadruples_map.size());
+		const Triangulation::QuadruplesMap::const_iterator quadruples_begin=quadruples_map.begin();
+		std::vector<std::size_t> counts(number_of_vertices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(static)
+#else
+		static_cast<void>(number_of_threads);
+#endif
+		for(int i=0;i<quadruples_count;i++)
 		{
-			const Quadruple& quadruple=it->first;
-			for(int a=0;a<4;a++)
+			const Quadruple& quadruple=(quadruples_begin+i)->first;
+			if(quadruple.get(3)<number_of_vertices)
 			{
-				for(int b=a+1;b<4;b++)
+				for(int k=0;k<4;k++)
 				{
-					const Pair pair(quadruple.get(a), quadruple.get(b));
-					for(int c=0;c<4;c++)
-					{
-						if(c!=a && c!=b)
-						{
-							pairs_neighbors_map[pair].insert(quadruple.get(c));
-						}
-					}
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+					counts[quadruple.get(k)]++;
+				}
+			}
+		}
+		CompressedNeighborsGraph incidences;
+		incidences.offsets.assign(number_of_vertices+1, 0);
+		for(std::size_t v=0;v<number_of_vertices;v++)
+		{
+			incidences.offsets[v+1]=incidences.offsets[v]+counts[v];
+		}
+		incidences.ids.resize(incidences.offsets.back());
+		std::vector<std::size_t>& positions=counts;
+		std::copy(incidences.offsets.begin(), incidences.offsets.end()-1, positions.begin());
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(static)
+#endif
+		for(int i=0;i<quadruples_count;i++)
+		{
+			const Quadruple& quadruple=(quadruples_begin+i)->first;
+			if(quadruple.get(3)<number_of_vertices)
+			{
+				for(int k=0;k<4;k++)
+				{
+					std::size_t position=0;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+					position=positions[quadruple.get(k)]++;
+					incidences.ids[position]=static_cast<std::size_t>(i);
 				}
 			}
 		}
-		return pairs_neighbors_map;
+		return incidences;
 	}
 };
 
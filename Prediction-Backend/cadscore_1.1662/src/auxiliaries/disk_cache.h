@@ -0,0 +1,319 @@
+#ifndef AUXILIARIES_DISK_CACHE_H_
+#define AUXILIARIES_DISK_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#define AUXILIARIES_DISK_CACHE_WITH_POSIX
+#endif
+
+namespace auxiliaries
+{
+
+/*
+ * Directory of values stored in files named by the hashes of their keys.
+ * Every file starts with the full key, which is compared on reading, so a collision of the hashes is just a cache miss.
+ * A value is written to a temporary file that is then renamed, so concurrent processes never see partially written values.
+ * Reading a value updates its modification time, and after every write the least recently used values
+ * are removed until the total size of the values does not exceed the limit.
+ * A cache with an empty directory name is disabled: it finds nothing and stores nothing.
+ * The file system operations need POSIX, in other builds only the disabled cache can be created.
+ */
+class DiskCache
+{
+public:
+	class Key
+	{
+	public:
+		Key() : first_(14695981039346656037ULL), second_(0x9E3779B97F4A7C15ULL)
+		{
+		}
+
+		const std::string& data() const
+		{
+			return data_;
+		}
+
+		Key& add(const std::string& value)
+		{
+			add(static_cast<unsigned long long>(value.size()));
+			add_bytes(value.data(), value.size());
+			return (*this);
+		}
+
+		Key& add(const double value)
+		{
+			unsigned long long bits=0;
+			std::memcpy(&bits, &value, sizeof(double));
+			return add(bits);
+		}
+
+		Key& add(const unsigned long long value)
+		{
+			char bytes[8];
+			for(int i=0;i<8;i++)
+			{
+				bytes[i]=static_cast<char>((value >> (8*i)) & 0xFF);
+			}
+			add_bytes(bytes, 8);
+			return (*this);
+		}
+
+		std::string str() const
+		{
+			std::ostringstream output;
+			output << std::hex;
+			output.fill('0');
+			output.width(16);
+			output << first_;
+			output.width(16);
+			output << second_;
+			return output.str();
+		}
+
+	private:
+		void add_bytes(const char* bytes, const std::size_t n)
+		{
+			data_.append(bytes, n);
+			for(std::size_t i=0;i<n;i++)
+			{
+				const unsigned long long byte=static_cast<unsigned long long>(static_cast<unsigned char>(bytes[i]));
+				first_=(first_^byte)*1099511628211ULL;
+				second_=(second_+byte)*0xC2B2AE3D27D4EB4FULL;
+				second_^=(second_ >> 29);
+			}
+		}
+
+		unsigned long long first_;
+		unsigned long long second_;
+		std::string data_;
+	};
+
+	DiskCache(const std::string& directory, const std::size_t max_size_in_bytes) : directory_(directory), max_size_in_bytes_(max_size_in_bytes)
+	{
+		if(enabled() && !make_directory(directory_))
+		{
+			throw std::runtime_error(std::string("Failed to create cache directory '")+directory_+"'");
+		}
+	}
+
+	bool enabled() const
+	{
+		return !directory_.empty();
+	}
+
+	bool read(const Key& key, std::string& value) const
+	{
+		if(!enabled())
+		{
+			return false;
+		}
+		const std::string path=value_path(key);
+		std::ifstream input(path.c_str(), std::ios::binary);
+		if(!input.good())
+		{
+			return false;
+		}
+		std::size_t key_size=0;
+		if(!(input >> key_size) || input.get()!='\n' || key_size!=key.data().size())
+		{
+			return false;
+		}
+		std::string key_data(key_size, '\0');
+		if(key_size>0 && (!input.read(&key_data[0], static_cast<std::streamsize>(key_size)) || key_data!=key.data()))
+		{
+			return false;
+		}
+		std::ostringstream buffer;
+		buffer << input.rdbuf();
+		if(input.bad())
+		{
+			return false;
+		}
+		value=buffer.str();
+		touch_file(path);
+		return true;
+	}
+
+	void write(const Key& key, const std::string& value) const
+	{
+		if(!enabled())
+		{
+			return;
+		}
+		const std::string path=value_path(key);
+		std::ostringstream temporary_path_output;
+		temporary_path_output << path << temporary_suffix() << process_id() << "." << static_cast<const void*>(&value);
+		const std::string temporary_path=temporary_path_output.str();
+		{
+			std::ofstream output(temporary_path.c_str(), std::ios::binary);
+			output << key.data().size() << "\n";
+			output.write(key.data().data(), static_cast<std::streamsize>(key.data().size()));
+			output.write(value.data(), static_cast<std::streamsize>(value.size()));
+			output.close();
+			if(output.fail())
+			{
+				std::remove(temporary_path.c_str());
+				return;
+			}
+		}
+		if(std::rename(temporary_path.c_str(), path.c_str())!=0)
+		{
+			std::remove(temporary_path.c_str());
+			return;
+		}
+		remove_least_recently_used_values();
+	}
+
+private:
+	struct FileInfo
+	{
+		time_t modification_time;
+		std::size_t size;
+		std::string name;
+		std::string path;
+
+		bool operator<(const FileInfo& f) const
+		{
+			return (modification_time<f.modification_time || (modification_time==f.modification_time && path<f.path));
+		}
+	};
+
+	static const char* value_suffix()
+	{
+		return ".cache";
+	}
+
+	static const char* temporary_suffix()
+	{
+		return ".tmp.";
+	}
+
+	// Temporary files older than this are left by interrupted processes
+	static time_t temporary_file_lifetime()
+	{
+		return 3600;
+	}
+
+	std::string value_path(const Key& key) const
+	{
+		return (directory_+"/"+key.str()+value_suffix());
+	}
+
+	void remove_least_recently_used_values() const
+	{
+		const time_t now=time(0);
+		const std::string suffix(value_suffix());
+		const std::vector<FileInfo> all_files=list_files(directory_);
+		std::vector<FileInfo> files;
+		std::size_t total_size=0;
+		for(std::size_t i=0;i<all_files.size();i++)
+		{
+			const FileInfo& file=all_files[i];
+			if(file.name.find(temporary_suffix())!=std::string::npos)
+			{
+				if(file.modification_time+temporary_file_lifetime()<now)
+				{
+					std::remove(file.path.c_str());
+				}
+			}
+			else if(file.name.size()>suffix.size() && file.name.compare(file.name.size()-suffix.size(), suffix.size(), suffix)==0)
+			{
+				files.push_back(file);
+				total_size+=file.size;
+			}
+		}
+		if(total_size>max_size_in_bytes_)
+		{
+			std::sort(files.begin(), files.end());
+			for(std::size_t i=0;i<files.size() && total_size>max_size_in_bytes_;i++)
+			{
+				std::remove(files[i].path.c_str());
+				total_size-=files[i].size;
+			}
+		}
+	}
+
+#ifdef AUXILIARIES_DISK_CACHE_WITH_POSIX
+	static bool make_directory(const std::string& directory)
+	{
+		return (mkdir(directory.c_str(), 0777)==0 || errno==EEXIST);
+	}
+
+	static void touch_file(const std::string& path)
+	{
+		utime(path.c_str(), 0);
+	}
+
+	static long process_id()
+	{
+		return static_cast<long>(getpid());
+	}
+
+	// Regular files of the directory
+	static std::vector<FileInfo> list_files(const std::string& directory)
+	{
+		std::vector<FileInfo> files;
+		DIR* dir=opendir(directory.c_str());
+		if(dir==0)
+		{
+			return files;
+		}
+		for(struct dirent* entry=readdir(dir);entry!=0;entry=readdir(dir))
+		{
+			FileInfo file;
+			file.name=entry->d_name;
+			file.path=directory+"/"+file.name;
+			struct stat info;
+			if(stat(file.path.c_str(), &info)==0 && S_ISREG(info.st_mode))
+			{
+				file.modification_time=info.st_mtime;
+				file.size=static_cast<std::size_t>(info.st_size);
+				files.push_back(file);
+			}
+		}
+		closedir(dir);
+		return files;
+	}
+#else
+	static bool make_directory(const std::string& directory)
+	{
+		throw std::runtime_error(std::string("Cache directory '")+directory+"' can not be used, because this build does not support the on-disk cache");
+	}
+
+	static void touch_file(const std::string&)
+	{
+	}
+
+	static long process_id()
+	{
+		return 0;
+	}
+
+	static std::vector<FileInfo> list_files(const std::string&)
+	{
+		return std::vector<FileInfo>();
+	}
+#endif
+
+	std::string directory_;
+	std::size_t max_size_in_bytes_;
+};
+
+}
+
+#endif /* AUXILIARIES_DISK_CACHE_H_ */
@@ -0,0 +1,479 @@
+#ifndef AUXILIARIES_STD_CONTAINERS_BINARY_IO_H_
+#define AUXILIARIES_STD_CONTAINERS_BINARY_IO_H_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstring>
+
+#include "std_containers_io.h"
+
+namespace auxiliaries
+{
+
+/*
+ * Binary layout (all numbers are little-endian):
+ *   magic "\x7fCAD", format version (u32),
+ *   header (u32 length + chars),
+ *   string table (u32 count, then u32 length + chars for every string),
+ *   records count (u64), records size in bytes (u64), packed records,
+ *   FNV-1a checksum (u64) of everything between the magic and the checksum.
+ * Strings inside records are stored as u32 indices into the string table.
+ * Element types provide write_binary(writer) and read_binary(reader) member templates.
+ */
+class STDContainersBinaryIO
+{
+public:
+	class RecordsWriter
+	{
+	public:
+		void write_int(const int value)
+		{
+			write_u32(static_cast<unsigned int>(value));
+		}
+
+		void write_double(const double value)
+		{
+			unsigned long long bits=0;
+			std::memcpy(&bits, &value, sizeof(double));
+			write_u64(bits);
+		}
+
+		void write_size(const std::size_t value)
+		{
+			write_u32(static_cast<unsigned int>(value));
+		}
+
+		void write_string(const std::string& value)
+		{
+			std::map<std::string, unsigned int>::const_iterator it=strings_ids_.find(value);
+			if(it==strings_ids_.end())
+			{
+				it=strings_ids_.insert(std::make_pair(value, static_cast<unsigned int>(strings_.size()))).first;
+				strings_.push_back(value);
+			}
+			write_u32(it->second);
+		}
+
+		const std::vector<std::string>& strings() const
+		{
+			return strings_;
+		}
+
+		const std::string& data() const
+		{
+			return data_;
+		}
+
+	private:
+		void write_u32(const unsigned int value)
+		{
+			for(int i=0;i<4;i++)
+			{
+				data_.push_back(static_cast<char>((value >> (8*i)) & 0xFF));
+			}
+		}
+
+		void write_u64(const unsigned long long value)
+		{
+			for(int i=0;i<8;i++)
+			{
+				data_.push_back(static_cast<char>((value >> (8*i)) & 0xFF));
+			}
+		}
+
+		std::vector<std::string> strings_;
+		std::map<std::string, unsigned int> strings_ids_;
+		std::string data_;
+	};
+
+	class RecordsReader
+	{
+	public:
+		RecordsReader(const std::vector<std::string>& strings, const std::string& data) : strings_(strings), data_(data), pos_(0)
+		{
+		}
+
+		int read_int()
+		{
+			return static_cast<int>(read_u32());
+		}
+
+		double read_double()
+		{
+			const unsigned long long bits=read_u64();
+			double value=0.0;
+			std::memcpy(&value, &bits, sizeof(double));
+			return value;
+		}
+
+		std::size_t read_size()
+		{
+			return static_cast<std::size_t>(read_u32());
+		}
+
+		const std::string& read_string()
+		{
+			const unsigned int id=read_u32();
+			if(id>=strings_.size())
+			{
+				throw std::runtime_error("Invalid string index in binary data");
+			}
+			return strings_[id];
+		}
+
+		bool finished() const
+		{
+			return (pos_==data_.size());
+		}
+
+	private:
+		unsigned int read_u32()
+		{
+			if(pos_+4>data_.size())
+			{
+				throw std::runtime_error("Unexpected end of binary data");
+			}
+			unsigned int value=0;
+			for(int i=0;i<4;i++)
+			{
+				value|=(static_cast<unsigned int>(static_cast<unsigned char>(data_[pos_+i])) << (8*i));
+			}
+			pos_+=4;
+			return value;
+		}
+
+		unsigned long long read_u64()
+		{
+			if(pos_+8>data_.size())
+			{
+				throw std::runtime_error("Unexpected end of binary data");
+			}
+			unsigned long long value=0;
+			for(int i=0;i<8;i++)
+			{
+				value|=(static_cast<unsigned long long>(static_cast<unsigned char>(data_[pos_+i])) << (8*i));
+			}
+			pos_+=8;
+			return value;
+		}
+
+		const std::vector<std::string>& strings_;
+		const std::string& data_;
+		std::size_t pos_;
+	};
+
+	static unsigned int format_version()
+	{
+		return 1;
+	}
+
+	static bool check_binary_format(std::istream& in)
+	{
+		in >> std::ws;
+		return (in.good() && in.peek()==magic()[0]);
+	}
+
+	template<typename T>
+	static void print_vector(std::ostream& out, const std::string& header, const std::vector<T>& v)
+	{
+		RecordsWriter writer;
+		for(std::size_t i=0;i<v.size();i++)
+		{
+			v[i].write_binary(writer);
+		}
+		print_records(out, header, v.size(), writer);
+	}
+
+	template<typename T>
+	static std::vector<T> read_vector(std::istream& in, const std::string& name, const std::string& header, const bool allow_empty_result)
+	{
+		std::vector<std::string> strings;
+		std::string data;
+		const std::size_t n=read_records(in, std::string("Error reading vector '")+name+"': ", header, allow_empty_result, strings, data);
+		RecordsReader reader(strings, data);
+		std::vector<T> v;
+		v.reserve(n);
+		for(std::size_t i=0;i<n;i++)
+		{
+			v.push_back(T());
+			v.back().read_binary(reader);
+		}
+		check_reader_finished(reader, name);
+		return v;
+	}
+
+	// Reads vectors written one after another (for example, by concatenating files), each in any format
+	template<typename T>
+	static std::vector<T> read_concatenated_vectors_in_any_format(std::istream& in, const std::string& name, const std::string& header)
+	{
+		std::vector<T> v=read_vector_in_any_format<T>(in, name, header, true);
+		while(true)
+		{
+			std::vector<T> more;
+			if(check_binary_format(in))
+			{
+				more=read_vector<T>(in, std::string("more ")+name, header, true);
+			}
+			else if(STDContainersIO::check_file_header(in, header))
+			{
+				more=STDContainersIO::read_vector<T>(in, std::string("more ")+name, "", true);
+			}
+			else
+			{
+				break;
+			}
+			v.insert(v.end(), more.begin(), more.end());
+		}
+		return v;
+	}
+
+	template<typename A, typename B>
+	static void print_map(std::ostream& out, const std::string& header, const std::map<A, B>& map)
+	{
+		RecordsWriter writer;
+		for(typename std::map<A, B>::const_iterator it=map.begin();it!=map.end();++it)
+		{
+			it->first.write_binary(writer);
+			it->second.write_binary(writer);
+		}
+		print_records(out, header, map.size(), writer);
+	}
+
+	template<typename A, typename B>
+	static std::map<A, B> read_map(std::istream& in, const std::string& name, const std::string& header, const bool allow_empty_result)
+	{
+		std::vector<std::string> strings;
+		std::string data;
+		const std::size_t n=read_records(in, std::string("Error reading map '")+name+"': ", header, allow_empty_result, strings, data);
+		RecordsReader reader(strings, data);
+		std::map<A, B> map;
+		typename std::map<A, B>::iterator prev=map.begin();
+		for(std::size_t i=0;i<n;i++)
+		{
+			A key;
+			key.read_binary(reader);
+			B value;
+			value.read_binary(reader);
+			prev=map.insert(prev, std::make_pair(key, value));
+		}
+		check_reader_finished(reader, name);
+		return map;
+	}
+
+	template<typename T>
+	static void print_vector_in_chosen_format(std::ostream& out, const std::string& header, const std::vector<T>& v, const bool binary)
+	{
+		if(binary)
+		{
+			print_vector(out, header, v);
+		}
+		else
+		{
+			STDContainersIO::print_vector(out, header, v);
+		}
+	}
+
+	template<typename T>
+	static std::vector<T> read_vector_in_any_format(std::istream& in, const std::string& name, const std::string& header, const bool allow_empty_result)
+	{
+		if(check_binary_format(in))
+		{
+			return read_vector<T>(in, name, header, allow_empty_result);
+		}
+		return STDContainersIO::read_vector<T>(in, name, header, allow_empty_result);
+	}
+
+	template<typename A, typename B>
+	static void print_map_in_chosen_format(std::ostream& out, const std::string& header, const std::map<A, B>& map, const bool separate_with_new_line, const bool binary)
+	{
+		if(binary)
+		{
+			print_map(out, header, map);
+		}
+		else
+		{
+			STDContainersIO::print_map(out, header, map, separate_with_new_line);
+		}
+	}
+
+	template<typename A, typename B>
+	static std::map<A, B> read_map_in_any_format(std::istream& in, const std::string& name, const std::string& header, const bool allow_empty_result)
+	{
+		if(check_binary_format(in))
+		{
+			return read_map<A, B>(in, name, header, allow_empty_result);
+		}
+		return STDContainersIO::read_map<A, B>(in, name, header, allow_empty_result);
+	}
+
+private:
+	class ChecksumCalculator
+	{
+	public:
+		ChecksumCalculator() : value_(14695981039346656037ULL)
+		{
+		}
+
+		void update(const std::string& data)
+		{
+			for(std::size_t i=0;i<data.size();i++)
+			{
+				value_^=static_cast<unsigned long long>(static_cast<unsigned char>(data[i]));
+				value_*=1099511628211ULL;
+			}
+		}
+
+		unsigned long long value() const
+		{
+			return value_;
+		}
+
+	private:
+		unsigned long long value_;
+	};
+
+	static const char* magic()
+	{
+		return "\x7f" "CAD";
+	}
+
+	static std::string encode_u32(const unsigned int value)
+	{
+		std::string s(4, '\0');
+		for(int i=0;i<4;i++)
+		{
+			s[i]=static_cast<char>((value >> (8*i)) & 0xFF);
+		}
+		return s;
+	}
+
+	static std::string encode_u64(const unsigned long long value)
+	{
+		std::string s(8, '\0');
+		for(int i=0;i<8;i++)
+		{
+			s[i]=static_cast<char>((value >> (8*i)) & 0xFF);
+		}
+		return s;
+	}
+
+	static std::string encode_string(const std::string& value)
+	{
+		return (encode_u32(static_cast<unsigned int>(value.size()))+value);
+	}
+
+	static void print_records(std::ostream& out, const std::string& header, const std::size_t count, const RecordsWriter& writer)
+	{
+		std::string contents=encode_u32(format_version())+encode_string(header)+encode_u32(static_cast<unsigned int>(writer.strings().size()));
+		for(std::size_t i=0;i<writer.strings().size();i++)
+		{
+			contents+=encode_string(writer.strings()[i]);
+		}
+		contents+=encode_u64(count);
+		contents+=encode_u64(writer.data().size());
+		ChecksumCalculator checksum;
+		checksum.update(contents);
+		checksum.update(writer.data());
+		out.write(magic(), 4);
+		out << contents << writer.data() << encode_u64(checksum.value());
+	}
+
+	// The lengths are read from the input before the checksum is checked, so the memory is taken in blocks as the bytes arrive
+	static std::string read_bytes(std::istream& in, const std::size_t n, const std::string& error_prefix, ChecksumCalculator& checksum)
+	{
+		std::string s;
+		char buffer[65536];
+		while(s.size()<n)
+		{
+			const std::size_t block_size=std::min(n-s.size(), sizeof(buffer));
+			in.read(buffer, static_cast<std::streamsize>(block_size));
+			if(in.fail() || static_cast<std::size_t>(in.gcount())!=block_size)
+			{
+				throw std::runtime_error(error_prefix+"unexpected end of binary input stream");
+			}
+			s.append(buffer, block_size);
+		}
+		checksum.update(s);
+		return s;
+	}
+
+	static unsigned long long decode_u64(const std::string& s)
+	{
+		unsigned long long value=0;
+		for(std::size_t i=0;i<s.size() && i<8;i++)
+		{
+			value|=(static_cast<unsigned long long>(static_cast<unsigned char>(s[i])) << (8*i));
+		}
+		return value;
+	}
+
+	static std::size_t read_records(std::istream& in, const std::string& error_prefix, const std::string& header, const bool allow_empty_result, std::vector<std::string>& strings, std::string& data)
+	{
+		ChecksumCalculator checksum;
+		if(!check_binary_format(in))
+		{
+			throw std::runtime_error(error_prefix+"non-binary input stream");
+		}
+		{
+			ChecksumCalculator unused_checksum;
+			if(read_bytes(in, 4, error_prefix, unused_checksum)!=std::string(magic(), 4))
+			{
+				throw std::runtime_error(error_prefix+"invalid binary format signature");
+			}
+		}
+		const unsigned long long version=decode_u64(read_bytes(in, 4, error_prefix, checksum));
+		if(version!=format_version())
+		{
+			std::ostringstream error_output;
+			error_output << error_prefix << "unsupported binary format version " << version;
+			throw std::runtime_error(error_output.str());
+		}
+		const std::string stored_header=read_bytes(in, static_cast<std::size_t>(decode_u64(read_bytes(in, 4, error_prefix, checksum))), error_prefix, checksum);
+		if(!header.empty() && stored_header!=header)
+		{
+			throw std::runtime_error(error_prefix+"missing file header '"+header+"'");
+		}
+		const std::size_t strings_count=static_cast<std::size_t>(decode_u64(read_bytes(in, 4, error_prefix, checksum)));
+		strings.clear();
+		for(std::size_t i=0;i<strings_count;i++)
+		{
+			strings.push_back(read_bytes(in, static_cast<std::size_t>(decode_u64(read_bytes(in, 4, error_prefix, checksum))), error_prefix, checksum));
+		}
+		const std::size_t n=static_cast<std::size_t>(decode_u64(read_bytes(in, 8, error_prefix, checksum)));
+		const std::size_t data_size=static_cast<std::size_t>(decode_u64(read_bytes(in, 8, error_prefix, checksum)));
+		data=read_bytes(in, data_size, error_prefix, checksum);
+		{
+			ChecksumCalculator unused_checksum;
+			if(decode_u64(read_bytes(in, 8, error_prefix, unused_checksum))!=checksum.value())
+			{
+				throw std::runtime_error(error_prefix+"checksum mismatch");
+			}
+		}
+		if(n==0 && !allow_empty_result)
+		{
+			throw std::runtime_error(error_prefix+"no data in input stream");
+		}
+		if(n>data.size())
+		{
+			throw std::runtime_error(error_prefix+"more records than bytes of records data");
+		}
+		return n;
+	}
+
+	static void check_reader_finished(const RecordsReader& reader, const std::string& name)
+	{
+		if(!reader.finished())
+		{
+			throw std::runtime_error(std::string("Error reading '")+name+"': unused bytes in binary records");
+		}
+	}
+};
+
+}
+
+#endif /* AUXILIARIES_STD_CONTAINERS_BINARY_IO_H_ */
@@ -0,0 +1,242 @@
+#ifndef AUXILIARIES_TRIANGULATION_DISK_CACHE_H_
+#define AUXILIARIES_TRIANGULATION_DISK_CACHE_H_
+
+#include <string>
+#include <vector>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "../apollota/triangulation.h"
+
+#include "command_line_options.h"
+#include "std_containers_binary_io.h"
+#include "disk_cache.h"
+
+namespace auxiliaries
+{
+
+class TriangulationDiskCache
+{
+public:
+	// Uses the "--cache-dir" and "--cache-size" (in megabytes) options, without a directory the cache is disabled
+	static DiskCache create_disk_cache(const CommandLineOptions& clo)
+	{
+		const std::string directory=clo.isopt("--cache-dir") ? clo.arg<std::string>("--cache-dir") : std::string("");
+		const std::size_t size_in_megabytes=clo.isopt("--cache-size") ? clo.arg_with_min_value<std::size_t>("--cache-size", 1) : 1024;
+		return DiskCache(directory, size_in_megabytes*1024*1024);
+	}
+
+	static DiskCache::Key calc_spheres_cache_key(const std::string& kind, const std::vector<apollota::SimpleSphere>& spheres)
+	{
+		DiskCache::Key key;
+		key.add(kind);
+		key.add(static_cast<unsigned long long>(spheres.size()));
+		for(std::size_t i=0;i<spheres.size();i++)
+		{
+			key.add(spheres[i].x).add(spheres[i].y).add(spheres[i].z).add(spheres[i].r);
+		}
+		return key;
+	}
+
+	static apollota::Triangulation::Result construct_triangulation_result(
+			const std::vector<apollota::SimpleSphere>& spheres,
+			const double initial_radius_for_spheres_bucketing,
+			const bool exclude_hidden_spheres,
+			const bool include_surplus_valid_quadruples,
+			const std::size_t number_of_threads,
+			const DiskCache& cache)
+	{
+		if(!cache.enabled())
+		{
+			return apollota::Triangulation::construct_result(spheres, initial_radius_for_spheres_bucketing, exclude_hidden_spheres, include_surplus_valid_quadruples, number_of_threads);
+		}
+		DiskCache::Key key=calc_spheres_cache_key("triangulation 2", spheres);
+		key.add(initial_radius_for_spheres_bucketing);
+		key.add(static_cast<unsigned long long>(exclude_hidden_spheres)).add(static_cast<unsigned long long>(include_surplus_valid_quadruples));
+		std::string value;
+		if(cache.read(key, value))
+		{
+			try
+			{
+				return decode_triangulation_result(value);
+			}
+			catch(const std::exception&)
+			{
+			}
+		}
+		const apollota::Triangulation::Result result=apollota::Triangulation::construct_result(spheres, initial_radius_for_spheres_bucketing, exclude_hidden_spheres, include_surplus_valid_quadruples, number_of_threads);
+		cache.write(key, encode_triangulation_result(result));
+		return result;
+	}
+
+private:
+	struct CachedQuadruple
+	{
+		apollota::Quadruple quadruple;
+		apollota::Triangulation::TangentSpheres tangent_spheres;
+
+		template<typename Writer>
+		void write_binary(Writer& writer) const
+		{
+			for(unsigned int i=0;i<4;i++)
+			{
+				writer.write_size(quadruple.get(i));
+			}
+			writer.write_size(tangent_spheres.size());
+			for(std::size_t i=0;i<tangent_spheres.size();i++)
+			{
+				const apollota::SimpleSphere& s=tangent_spheres[i];
+				writer.write_double(s.x);
+				writer.write_double(s.y);
+				writer.write_double(s.z);
+				writer.write_double(s.r);
+			}
+		}
+
+		template<typename Reader>
+		void read_binary(Reader& reader)
+		{
+			std::vector<std::size_t> ids(4);
+			for(std::size_t i=0;i<4;i++)
+			{
+				ids[i]=reader.read_size();
+			}
+			quadruple=apollota::Quadruple(ids);
+			const std::size_t n=reader.read_size();
+			if(n>apollota::Triangulation::TangentSpheres::capacity())
+			{
+				throw std::runtime_error("Invalid number of tangent spheres in cached quadruple");
+			}
+			tangent_spheres=apollota::Triangulation::TangentSpheres();
+			for(std::size_t i=0;i<n;i++)
+			{
+				apollota::SimpleSphere s;
+				s.x=reader.read_double();
+				s.y=reader.read_double();
+				s.z=reader.read_double();
+				s.r=reader.read_double();
+				tangent_spheres.push_back(s);
+			}
+		}
+	};
+
+	struct CachedNumber
+	{
+		std::size_t value;
+
+		CachedNumber() : value(0)
+		{
+		}
+
+		explicit CachedNumber(const std::size_t value) : value(value)
+		{
+		}
+
+		template<typename Writer>
+		void write_binary(Writer& writer) const
+		{
+			writer.write_size(value);
+		}
+
+		template<typename Reader>
+		void read_binary(Reader& reader)
+		{
+			value=reader.read_size();
+		}
+	};
+
+	TriangulationDiskCache()
+	{
+	}
+
+	static std::vector<CachedNumber> collect_cached_numbers(const std::set<std::size_t>& ids)
+	{
+		std::vector<CachedNumber> numbers;
+		for(std::set<std::size_t>::const_iterator it=ids.begin();it!=ids.end();++it)
+		{
+			numbers.push_back(CachedNumber(*it));
+		}
+		return numbers;
+	}
+
+	static std::set<std::size_t> collect_ids(const std::vector<CachedNumber>& numbers)
+	{
+		std::set<std::size_t> ids;
+		for(std::size_t i=0;i<numbers.size();i++)
+		{
+			ids.insert(numbers[i].value);
+		}
+		return ids;
+	}
+
+	static std::string encode_triangulation_result(const apollota::Triangulation::Result& result)
+	{
+		std::vector<CachedQuadruple> quadruples;
+		quadruples.reserve(result.quadruples_map.size());
+		for(apollota::Triangulation::QuadruplesMap::const_iterator it=result.quadruples_map.begin();it!=result.quadruples_map.end();++it)
+		{
+			CachedQuadruple cq;
+			cq.quadruple=it->first;
+			cq.tangent_spheres=it->second;
+			quadruples.push_back(cq);
+		}
+		const apollota::Triangulation::QuadruplesSearchLog& qsl=result.quadruples_search_log;
+		const apollota::Triangulation::SurplusQuadruplesSearchLog& sqsl=result.surplus_quadruples_search_log;
+		std::vector<CachedNumber> logs;
+		logs.push_back(CachedNumber(qsl.added_quadruples));
+		logs.push_back(CachedNumber(qsl.added_tangent_spheres));
+		logs.push_back(CachedNumber(qsl.processed_faces));
+		logs.push_back(CachedNumber(qsl.encountered_difficult_faces));
+		logs.push_back(CachedNumber(qsl.produced_faces));
+		logs.push_back(CachedNumber(qsl.updated_faces));
+		logs.push_back(CachedNumber(qsl.encountered_triples_repetitions));
+		logs.push_back(CachedNumber(qsl.performed_iterations_for_finding_first_faces));
+		logs.push_back(CachedNumber(sqsl.surplus_quadruples));
+		logs.push_back(CachedNumber(sqsl.surplus_tangent_spheres));
+		std::ostringstream output;
+		STDContainersBinaryIO::print_vector(output, "quadruples", quadruples);
+		STDContainersBinaryIO::print_vector(output, "excluded_hidden_spheres", collect_cached_numbers(result.excluded_hidden_spheres_ids));
+		STDContainersBinaryIO::print_vector(output, "ignored_spheres", collect_cached_numbers(result.ignored_spheres_ids));
+		STDContainersBinaryIO::print_vector(output, "search_logs", logs);
+		return output.str();
+	}
+
+	static apollota::Triangulation::Result decode_triangulation_result(const std::string& value)
+	{
+		std::istringstream input(value);
+		const std::vector<CachedQuadruple> quadruples=STDContainersBinaryIO::read_vector<CachedQuadruple>(input, "quadruples", "quadruples", true);
+		const std::vector<CachedNumber> excluded_hidden_spheres=STDContainersBinaryIO::read_vector<CachedNumber>(input, "excluded hidden spheres", "excluded_hidden_spheres", true);
+		const std::vector<CachedNumber> ignored_spheres=STDContainersBinaryIO::read_vector<CachedNumber>(input, "ignored spheres", "ignored_spheres", true);
+		const std::vector<CachedNumber> logs=STDContainersBinaryIO::read_vector<CachedNumber>(input, "search logs", "search_logs", false);
+		if(logs.size()!=10)
+		{
+			throw std::runtime_error("Invalid cached search logs");
+		}
+		apollota::Triangulation::Result result;
+		result.quadruples_map.reserve(quadruples.size());
+		for(std::size_t i=0;i<quadruples.size();i++)
+		{
+			result.quadruples_map.insert(std::make_pair(quadruples[i].quadruple, quadruples[i].tangent_spheres));
+		}
+		result.excluded_hidden_spheres_ids=collect_ids(excluded_hidden_spheres);
+		result.ignored_spheres_ids=collect_ids(ignored_spheres);
+		apollota::Triangulation::QuadruplesSearchLog& qsl=result.quadruples_search_log;
+		apollota::Triangulation::SurplusQuadruplesSearchLog& sqsl=result.surplus_quadruples_search_log;
+		qsl.added_quadruples=logs[0].value;
+		qsl.added_tangent_spheres=logs[1].value;
+		qsl.processed_faces=logs[2].value;
+		qsl.encountered_difficult_faces=logs[3].value;
+		qsl.produced_faces=logs[4].value;
+		qsl.updated_faces=logs[5].value;
+		qsl.encountered_triples_repetitions=logs[6].value;
+		qsl.performed_iterations_for_finding_first_faces=logs[7].value;
+		sqsl.surplus_quadruples=logs[8].value;
+		sqsl.surplus_tangent_spheres=logs[9].value;
+		return result;
+	}
+};
+
+}
+
+#endif /* AUXILIARIES_TRIANGULATION_DISK_CACHE_H_ */
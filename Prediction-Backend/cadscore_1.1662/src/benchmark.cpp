@@ -0,0 +1,680 @@
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <new>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define BENCHMARK_WITH_GETRUSAGE
+#endif
+
+#include "protein/atom.h"
+#include "protein/atoms_reading.h"
+#include "protein/atoms_classification.h"
+#include "protein/residue_id.h"
+#include "protein/residue_summary.h"
+#include "protein/residue_ids_collection.h"
+
+#include "apollota/triangulation.h"
+#include "apollota/utilities_for_triangulation.h"
+#include "apollota/inter_sphere_contact_surface_on_sphere.h"
+#include "apollota/search_for_spherical_collisions.h"
+#include "apollota/spatial_ordering_of_spheres.h"
+
+#include "contacto/inter_atom_contact.h"
+#include "contacto/inter_residue_contacts_combination.h"
+#include "contacto/residue_contact_area_difference_profile.h"
+#include "contacto/residue_contact_area_difference_basic_scoring_functors.h"
+
+#include "auxiliaries/command_line_options.h"
+
+#include "resources/version.h"
+
+#include "shared_mode_functions.h"
+
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+
+// The global allocation functions are replaced only in builds made for benchmarking (with -DBENCHMARK_COUNT_ALLOCATIONS),
+// because the replacement affects every mode of the executable
+namespace
+{
+
+bool allocations_counting_enabled=false;
+unsigned long counted_allocations=0;
+unsigned long counted_allocated_bytes=0;
+
+}
+
+#if __cplusplus>=201103L
+void* operator new(std::size_t size)
+#else
+void* operator new(std::size_t size) throw(std::bad_alloc)
+#endif
+{
+	if(allocations_counting_enabled)
+	{
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+		counted_allocations++;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+		counted_allocated_bytes+=size;
+	}
+	void* p=std::malloc(size>0 ? size : 1);
+	if(p==0)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+// Not inlined, otherwise GCC reports the release of the memory allocated by the operator new above as mismatched
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+#if __cplusplus>=201103L
+void operator delete(void* p) noexcept
+#else
+void operator delete(void* p) throw()
+#endif
+{
+	std::free(p);
+}
+
+#if __cplusplus>=201402L
+void operator delete(void* p, std::size_t) noexcept
+{
+	::operator delete(p);
+}
+#endif
+
+#endif
+
+namespace
+{
+
+struct StageMeasurement
+{
+	std::string name;
+	double seconds;
+	std::size_t items;
+	unsigned long allocations;
+	unsigned long allocated_bytes;
+};
+
+class StageTimer
+{
+public:
+	explicit StageTimer(std::vector<StageMeasurement>& measurements) : measurements_(measurements), start_time_(0)
+	{
+	}
+
+	void start()
+	{
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+		counted_allocations=0;
+		counted_allocated_bytes=0;
+		allocations_counting_enabled=true;
+#endif
+		start_time_=wall_time();
+	}
+
+	void finish(const std::string& name, const std::size_t items)
+	{
+		const double seconds=wall_time()-start_time_;
+		StageMeasurement m;
+		m.name=name;
+		m.seconds=seconds;
+		m.items=items;
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+		allocations_counting_enabled=false;
+		m.allocations=counted_allocations;
+		m.allocated_bytes=counted_allocated_bytes;
+#else
+		m.allocations=0;
+		m.allocated_bytes=0;
+#endif
+		measurements_.push_back(m);
+	}
+
+private:
+	static double wall_time()
+	{
+#ifdef _OPENMP
+		return omp_get_wtime();
+#else
+		return static_cast<double>(std::clock())/static_cast<double>(CLOCKS_PER_SEC);
+#endif
+	}
+
+	std::vector<StageMeasurement>& measurements_;
+	double start_time_;
+};
+
+struct BenchmarkInput
+{
+	std::string name;
+	std::vector<protein::Atom> target_atoms;
+	std::vector<protein::Atom> model_atoms;
+};
+
+class PseudoRandomGenerator
+{
+public:
+	explicit PseudoRandomGenerator(const unsigned long seed) : state_(seed)
+	{
+	}
+
+	double next_in_interval(const double a, const double b)
+	{
+		state_=(state_*1103515245UL+12345UL)%2147483648UL;
+		return (a+(b-a)*(static_cast<double>(state_)/2147483648.0));
+	}
+
+private:
+	unsigned long state_;
+};
+
+std::vector<protein::Atom> generate_synthetic_atoms(const std::size_t number_of_atoms)
+{
+	static const char* atom_names[8]={"N", "CA", "C", "O", "CB", "CG", "CD", "CE"};
+	static const double atom_radii[8]={1.7, 1.9, 1.75, 1.49, 1.9, 1.9, 1.9, 1.9};
+	const double spacing=2.7;
+	const std::size_t side=static_cast<std::size_t>(std::ceil(std::pow(static_cast<double>(number_of_atoms), 1.0/3.0)));
+	PseudoRandomGenerator generator(number_of_atoms);
+	std::vector<protein::Atom> atoms;
+	atoms.reserve(number_of_atoms);
+	for(std::size_t i=0;i<number_of_atoms;i++)
+	{
+		protein::Atom atom;
+		atom.chain_id="A";
+		atom.atom_number=static_cast<int>(i+1);
+		atom.residue_number=static_cast<int>(i/8+1);
+		atom.residue_name="LYS";
+		atom.atom_name=atom_names[i%8];
+		atom.x=spacing*static_cast<double>(i%side)+generator.next_in_interval(-0.5, 0.5);
+		atom.y=spacing*static_cast<double>((i/side)%side)+generator.next_in_interval(-0.5, 0.5);
+		atom.z=spacing*static_cast<double>(i/(side*side))+generator.next_in_interval(-0.5, 0.5);
+		atom.r=atom_radii[i%8];
+		atoms.push_back(atom);
+	}
+	protein::AtomsClassification::classify_atoms(atoms);
+	return atoms;
+}
+
+std::vector<protein::Atom> generate_perturbed_atoms(const std::vector<protein::Atom>& atoms)
+{
+	PseudoRandomGenerator generator(atoms.size()+7);
+	std::vector<protein::Atom> result=atoms;
+	for(std::size_t i=0;i<result.size();i++)
+	{
+		result[i].x+=generator.next_in_interval(-0.3, 0.3);
+		result[i].y+=generator.next_in_interval(-0.3, 0.3);
+		result[i].z+=generator.next_in_interval(-0.3, 0.3);
+	}
+	return result;
+}
+
+std::vector<protein::Atom> remove_hidden_atoms(const std::vector<protein::Atom>& atoms)
+{
+	const apollota::BoundingSpheresHierarchy bsh(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, 1);
+	const std::set<std::size_t> hidden_ids=apollota::SearchForSphericalCollisions::find_all_hidden_spheres(bsh);
+	std::vector<protein::Atom> result;
+	result.reserve(atoms.size()-hidden_ids.size());
+	for(std::size_t i=0;i<atoms.size();i++)
+	{
+		if(hidden_ids.count(i)==0)
+		{
+			result.push_back(atoms[i]);
+		}
+	}
+	return result;
+}
+
+bool quadruples_maps_equal(const apollota::Triangulation::QuadruplesMap& a, const apollota::Triangulation::QuadruplesMap& b)
+{
+	if(a.size()!=b.size())
+	{
+		return false;
+	}
+	for(apollota::Triangulation::QuadruplesMap::const_iterator it=a.begin();it!=a.end();++it)
+	{
+		apollota::Triangulation::QuadruplesMap::const_iterator jt=b.find(it->first);
+		if(jt==b.end() || jt->second.size()!=it->second.size())
+		{
+			return false;
+		}
+		for(std::size_t i=0;i<it->second.size();i++)
+		{
+			const apollota::SimpleSphere& s1=it->second[i];
+			const apollota::SimpleSphere& s2=jt->second[i];
+			if(s1.x!=s2.x || s1.y!=s2.y || s1.z!=s2.z || s1.r!=s2.r)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+std::vector<StageMeasurement> run_benchmark_stages(const BenchmarkInput& input, const std::size_t number_of_threads, const bool spatial_ordering, const bool compare_d_validation)
+{
+	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > InterResidueContacts;
+
+	std::vector<StageMeasurement> measurements;
+	StageTimer timer(measurements);
+
+	std::vector<protein::Atom> target_atoms=input.target_atoms;
+	if(spatial_ordering)
+	{
+		timer.start();
+		target_atoms=apollota::SpatialOrderingOfSpheres::apply_order(input.target_atoms, apollota::SpatialOrderingOfSpheres::calc_morton_order(input.target_atoms));
+		timer.finish("spatial_ordering", target_atoms.size());
+	}
+
+	const std::vector<apollota::SimpleSphere> spheres=apollota::UtilitiesForTriangulation::collect_simple_spheres(target_atoms);
+
+	timer.start();
+	const apollota::BoundingSpheresHierarchy bsh(spheres, 3.5, 1);
+	timer.finish("bounding_spheres_hierarchy", spheres.size());
+
+	apollota::Triangulation::QuadruplesMap quadruples_map;
+	timer.start();
+	apollota::Triangulation::search_for_valid_quadruples(bsh, quadruples_map);
+	timer.finish("find_valid_quadruples", quadruples_map.size());
+
+	if(compare_d_validation)
+	{
+		apollota::Triangulation::QuadruplesMap quadruples_map_from_batches;
+		timer.start();
+		apollota::Triangulation::search_for_valid_quadruples(bsh, quadruples_map_from_batches, true);
+		timer.finish("find_valid_quadruples_validating_d_in_batches", quadruples_map_from_batches.size());
+		if(!quadruples_maps_equal(quadruples_map, quadruples_map_from_batches))
+		{
+			throw std::runtime_error(std::string("Validating d in batches produced different quadruples for input '")+input.name+"'");
+		}
+	}
+
+	{
+		apollota::Triangulation::QuadruplesMap quadruples_map_with_surplus=quadruples_map;
+		timer.start();
+		const apollota::Triangulation::SurplusQuadruplesSearchLog log=apollota::Triangulation::search_for_surplus_valid_quadruples(bsh, number_of_threads, quadruples_map_with_surplus);
+		timer.finish("find_surplus_valid_quadruples", log.surplus_quadruples);
+	}
+
+	timer.start();
+	const apollota::CompressedNeighborsGraph graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_quadruples_map(quadruples_map, spheres.size(), number_of_threads);
+	timer.finish("neighbors_graph", graph.ids.size());
+
+	timer.start();
+	const std::vector<apollota::InterSphereContactSurfaceOnSphere::SurfaceArea> surface_areas=apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas(target_atoms, graph, 3, 1.4, number_of_threads);
+	timer.finish("calc_surface_areas", surface_areas.size());
+
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=apollota::InterSphereContactSurfaceOnSphere::construct_inter_sphere_contacts_from_surface_areas<contacto::InterAtomContact>(surface_areas);
+
+	timer.start();
+	const InterResidueContacts target_inter_residue_contacts=construct_filtered_inter_residue_contacts(target_atoms, inter_atom_contacts, false, false, false, "", false);
+	timer.finish("inter_residue_contacts", target_inter_residue_contacts.size());
+
+	std::ostringstream log_output;
+	const InterResidueContacts model_inter_residue_contacts=construct_filtered_inter_residue_contacts(input.model_atoms, construct_inter_atom_contacts(input.model_atoms, "icosahedron", 3, 1.4, number_of_threads, spatial_ordering, log_output), false, false, false, "", false);
+	const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids=protein::collect_residue_ids_from_atoms(target_atoms);
+
+	timer.start();
+	const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> profile=contacto::construct_residue_contact_area_difference_profile<protein::ResidueID, protein::ResidueSummary, contacto::BoundedDifferenceProducer, contacto::SimpleReferenceProducer>(
+			contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(target_inter_residue_contacts, model_inter_residue_contacts, false), residue_ids);
+	timer.finish("cad_profile", profile.size());
+
+	return measurements;
+}
+
+struct EnginesComparison
+{
+	std::size_t depth;
+	std::size_t contacts;
+	std::size_t mismatches;
+	double max_area_difference;
+};
+
+// The adaptive engine should produce the same areas as the uniform tessellation of the same depth
+EnginesComparison compare_adaptive_and_uniform_engines(const std::vector<protein::Atom>& atoms, const std::size_t depth, const std::size_t number_of_threads)
+{
+	typedef std::map< std::pair<int, int>, double > AreasMap;
+	std::ostringstream log_output;
+	AreasMap uniform_areas;
+	{
+		const std::vector<contacto::InterAtomContact> contacts=construct_inter_atom_contacts(atoms, "icosahedron", depth, 1.4, number_of_threads, false, log_output);
+		for(std::size_t i=0;i<contacts.size();i++)
+		{
+			uniform_areas[std::make_pair(contacts[i].a, contacts[i].b)]=contacts[i].area;
+		}
+	}
+	EnginesComparison comparison;
+	comparison.depth=depth;
+	comparison.contacts=uniform_areas.size();
+	comparison.mismatches=0;
+	comparison.max_area_difference=0.0;
+	const std::vector<contacto::InterAtomContact> adaptive_contacts=construct_inter_atom_contacts(atoms, "adaptive", depth, 1.4, number_of_threads, false, log_output);
+	for(std::size_t i=0;i<adaptive_contacts.size();i++)
+	{
+		AreasMap::iterator it=uniform_areas.find(std::make_pair(adaptive_contacts[i].a, adaptive_contacts[i].b));
+		const double difference=fabs(adaptive_contacts[i].area-(it!=uniform_areas.end() ? it->second : 0.0));
+		if(it==uniform_areas.end() || difference>1e-6)
+		{
+			comparison.mismatches++;
+		}
+		comparison.max_area_difference=std::max(comparison.max_area_difference, difference);
+		if(it!=uniform_areas.end())
+		{
+			uniform_areas.erase(it);
+		}
+	}
+	for(AreasMap::const_iterator it=uniform_areas.begin();it!=uniform_areas.end();++it)
+	{
+		comparison.mismatches++;
+		comparison.max_area_difference=std::max(comparison.max_area_difference, it->second);
+	}
+	return comparison;
+}
+
+struct ReferenceStage
+{
+	std::size_t items;
+	double seconds;
+};
+
+typedef std::map< std::pair<std::string, std::string>, ReferenceStage > ReferenceStagesMap;
+
+std::string read_json_string_value(const std::string& line, const std::string& key)
+{
+	const std::string prefix=std::string("\"")+key+"\": \"";
+	const std::size_t begin=line.find(prefix);
+	if(begin==std::string::npos)
+	{
+		return std::string();
+	}
+	std::string value;
+	for(std::size_t i=begin+prefix.size();i<line.size() && line[i]!='"';i++)
+	{
+		if(line[i]=='\\' && i+1<line.size())
+		{
+			i++;
+		}
+		value.push_back(line[i]);
+	}
+	return value;
+}
+
+double read_json_number_value(const std::string& line, const std::string& key)
+{
+	const std::string prefix=std::string("\"")+key+"\": ";
+	const std::size_t begin=line.find(prefix);
+	if(begin==std::string::npos)
+	{
+		throw std::runtime_error(std::string("Missing value '")+key+"' in benchmark reference line '"+line+"'");
+	}
+	std::istringstream input(line.substr(begin+prefix.size()));
+	double value=0.0;
+	input >> value;
+	if(input.fail())
+	{
+		throw std::runtime_error(std::string("Invalid value '")+key+"' in benchmark reference line '"+line+"'");
+	}
+	return value;
+}
+
+// Reads the stages of the inputs from the output of an earlier benchmark run
+ReferenceStagesMap read_reference_stages(const std::string& file_name)
+{
+	std::ifstream input(file_name.c_str());
+	if(!input.good())
+	{
+		throw std::runtime_error(std::string("Failed to open benchmark reference file '")+file_name+"'");
+	}
+	ReferenceStagesMap reference_stages;
+	std::string input_name;
+	std::string line;
+	while(std::getline(input, line))
+	{
+		if(line.find("{\"name\": \"")!=std::string::npos)
+		{
+			ReferenceStage stage;
+			stage.items=static_cast<std::size_t>(read_json_number_value(line, "items"));
+			stage.seconds=read_json_number_value(line, "seconds");
+			reference_stages[std::make_pair(input_name, read_json_string_value(line, "name"))]=stage;
+		}
+		else if(line.find("\"name\": \"")!=std::string::npos)
+		{
+			input_name=read_json_string_value(line, "name");
+		}
+	}
+	if(reference_stages.empty())
+	{
+		throw std::runtime_error(std::string("No stages in benchmark reference file '")+file_name+"'");
+	}
+	return reference_stages;
+}
+
+// A hundredth of a second is added to the allowed time of every stage, because the times of the fastest stages are mostly noise
+std::vector<std::string> compare_with_reference_stages(const BenchmarkInput& input, const std::vector<StageMeasurement>& measurements, const ReferenceStagesMap& reference_stages, const double max_slowdown)
+{
+	std::vector<std::string> failures;
+	for(std::size_t i=0;i<measurements.size();i++)
+	{
+		const StageMeasurement& m=measurements[i];
+		ReferenceStagesMap::const_iterator it=reference_stages.find(std::make_pair(input.name, m.name));
+		if(it!=reference_stages.end())
+		{
+			std::ostringstream failure;
+			if(m.items!=it->second.items)
+			{
+				failure << "stage '" << m.name << "' of input '" << input.name << "' produced " << m.items << " items instead of " << it->second.items;
+			}
+			else if(m.seconds>it->second.seconds*max_slowdown+0.01)
+			{
+				failure << "stage '" << m.name << "' of input '" << input.name << "' took " << m.seconds << " seconds instead of " << it->second.seconds;
+			}
+			if(!failure.str().empty())
+			{
+				failures.push_back(failure.str());
+			}
+		}
+	}
+	return failures;
+}
+
+long peak_resident_set_size_in_kilobytes()
+{
+#ifdef BENCHMARK_WITH_GETRUSAGE
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage)==0)
+	{
+#ifdef __APPLE__
+		return static_cast<long>(usage.ru_maxrss/1024);
+#else
+		return static_cast<long>(usage.ru_maxrss);
+#endif
+	}
+#endif
+	return -1;
+}
+
+std::string json_escaped(const std::string& str)
+{
+	std::string result;
+	for(std::size_t i=0;i<str.size();i++)
+	{
+		if(str[i]=='"' || str[i]=='\\')
+		{
+			result.push_back('\\');
+		}
+		result.push_back(str[i]);
+	}
+	return result;
+}
+
+void print_benchmark_result(const BenchmarkInput& input, const std::vector<StageMeasurement>& measurements, const std::vector<EnginesComparison>& engines_comparisons, const ReferenceStagesMap& reference_stages, const bool last, std::ostream& output)
+{
+	output << "    {\n";
+	output << "      \"name\": \"" << json_escaped(input.name) << "\",\n";
+	output << "      \"atoms\": " << input.target_atoms.size() << ",\n";
+	output << "      \"residues\": " << protein::collect_residue_ids_from_atoms(input.target_atoms).size() << ",\n";
+	output << "      \"peak_rss_kb\": " << peak_resident_set_size_in_kilobytes() << ",\n";
+	if(!engines_comparisons.empty())
+	{
+		output << "      \"adaptive_engine_check\": [\n";
+		for(std::size_t i=0;i<engines_comparisons.size();i++)
+		{
+			const EnginesComparison& c=engines_comparisons[i];
+			output << "        {\"depth\": " << c.depth;
+			output << ", \"contacts\": " << c.contacts;
+			output << ", \"mismatches\": " << c.mismatches;
+			output << ", \"max_area_difference\": " << c.max_area_difference;
+			output << "}" << (i+1<engines_comparisons.size() ? "," : "") << "\n";
+		}
+		output << "      ],\n";
+	}
+	output << "      \"stages\": [\n";
+	for(std::size_t i=0;i<measurements.size();i++)
+	{
+		const StageMeasurement& m=measurements[i];
+		output << "        {\"name\": \"" << m.name << "\"";
+		output << ", \"seconds\": " << m.seconds;
+		output << ", \"items\": " << m.items;
+		output << ", \"items_per_second\": " << (m.seconds>0.0 ? static_cast<double>(m.items)/m.seconds : 0.0);
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+		output << ", \"allocations\": " << m.allocations;
+		output << ", \"allocated_bytes\": " << m.allocated_bytes;
+#endif
+		ReferenceStagesMap::const_iterator it=reference_stages.find(std::make_pair(input.name, m.name));
+		if(it!=reference_stages.end())
+		{
+			output << ", \"reference_seconds\": " << it->second.seconds;
+			output << ", \"slowdown\": " << (it->second.seconds>0.0 ? m.seconds/it->second.seconds : 0.0);
+		}
+		output << "}" << (i+1<measurements.size() ? "," : "") << "\n";
+	}
+	output << "      ]\n";
+	output << "    }" << (last ? "" : ",") << "\n";
+}
+
+}
+
+void benchmark(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--sizes: --pdb: --threads: --repeats: --spatial-ordering --check-adaptive-engine --compare-d-validation --reference: --max-slowdown:");
+
+	const std::vector<std::size_t> sizes=clo.isopt("--sizes") ? clo.arg_vector<std::size_t>("--sizes", ',') : std::vector<std::size_t>(1, 10000);
+	const std::vector<std::string> pdb_file_names=clo.isopt("--pdb") ? clo.arg_vector<std::string>("--pdb", ',') : std::vector<std::string>();
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
+	const std::size_t repeats=clo.isopt("--repeats") ? clo.arg_with_min_value<std::size_t>("--repeats", 1) : 1;
+	const bool spatial_ordering=clo.isopt("--spatial-ordering");
+	const bool check_adaptive_engine=clo.isopt("--check-adaptive-engine");
+	const bool compare_d_validation=clo.isopt("--compare-d-validation");
+	const ReferenceStagesMap reference_stages=clo.isopt("--reference") ? read_reference_stages(clo.arg<std::string>("--reference")) : ReferenceStagesMap();
+	const double max_slowdown=clo.isopt("--max-slowdown") ? clo.arg_with_min_value<double>("--max-slowdown", 1.0) : 1.5;
+
+	std::vector<BenchmarkInput> inputs;
+	for(std::size_t i=0;i<sizes.size();i++)
+	{
+		if(sizes[i]<4)
+		{
+			throw std::runtime_error("Synthetic input size should be at least 4");
+		}
+		BenchmarkInput input;
+		std::ostringstream name_output;
+		name_output << "synthetic_" << sizes[i];
+		input.name=name_output.str();
+		input.target_atoms=generate_synthetic_atoms(sizes[i]);
+		input.model_atoms=generate_perturbed_atoms(input.target_atoms);
+		inputs.push_back(input);
+	}
+	if(!pdb_file_names.empty())
+	{
+		const protein::VanDerWaalsRadiusAssigner radius_assigner=construct_radius_assigner("", "");
+		for(std::size_t i=0;i<pdb_file_names.size();i++)
+		{
+			std::ifstream pdb_input(pdb_file_names[i].c_str());
+			if(!pdb_input.good())
+			{
+				throw std::runtime_error(std::string("Failed to open file '")+pdb_file_names[i]+"'");
+			}
+			BenchmarkInput input;
+			input.name=pdb_file_names[i];
+			input.target_atoms=remove_hidden_atoms(collect_atoms_from_PDB_file_stream(pdb_input, radius_assigner, false, false, false, "", false));
+			if(input.target_atoms.size()<4)
+			{
+				throw std::runtime_error(std::string("Less than 4 atoms in file '")+pdb_file_names[i]+"'");
+			}
+			input.model_atoms=generate_perturbed_atoms(input.target_atoms);
+			inputs.push_back(input);
+		}
+	}
+
+	std::cout << "{\n";
+	std::cout << "  \"version\": \"" << json_escaped(resources::get_version_string()) << "\",\n";
+	std::cout << "  \"threads\": " << number_of_threads << ",\n";
+	std::cout << "  \"repeats\": " << repeats << ",\n";
+	std::cout << "  \"spatial_ordering\": " << (spatial_ordering ? "true" : "false") << ",\n";
+	std::cout << "  \"inputs\": [\n";
+	bool engines_check_failed=false;
+	std::vector<std::string> reference_check_failures;
+	for(std::size_t i=0;i<inputs.size();i++)
+	{
+		std::vector<StageMeasurement> best_measurements=run_benchmark_stages(inputs[i], number_of_threads, spatial_ordering, compare_d_validation);
+		for(std::size_t r=1;r<repeats;r++)
+		{
+			const std::vector<StageMeasurement> measurements=run_benchmark_stages(inputs[i], number_of_threads, spatial_ordering, compare_d_validation);
+			for(std::size_t j=0;j<measurements.size() && j<best_measurements.size();j++)
+			{
+				if(measurements[j].seconds<best_measurements[j].seconds)
+				{
+					best_measurements[j]=measurements[j];
+				}
+			}
+		}
+		std::vector<EnginesComparison> engines_comparisons;
+		if(check_adaptive_engine)
+		{
+			for(std::size_t depth=3;depth<=4;depth++)
+			{
+				engines_comparisons.push_back(compare_adaptive_and_uniform_engines(inputs[i].target_atoms, depth, number_of_threads));
+				engines_check_failed=(engines_check_failed || engines_comparisons.back().mismatches>0);
+			}
+		}
+		const std::vector<std::string> failures=compare_with_reference_stages(inputs[i], best_measurements, reference_stages, max_slowdown);
+		reference_check_failures.insert(reference_check_failures.end(), failures.begin(), failures.end());
+		print_benchmark_result(inputs[i], best_measurements, engines_comparisons, reference_stages, (i+1==inputs.size()), std::cout);
+		std::cout.flush();
+	}
+	std::cout << "  ]\n";
+	std::cout << "}\n";
+
+	if(engines_check_failed)
+	{
+		throw std::runtime_error("Adaptive engine areas differ from the areas of the uniform tessellation");
+	}
+
+	if(!reference_check_failures.empty())
+	{
+		std::ostringstream message;
+		message << "Benchmark results differ from the reference:";
+		for(std::size_t i=0;i<reference_check_failures.size();i++)
+		{
+			message << (i>0 ? ";" : "") << " " << reference_check_failures[i];
+		}
+		throw std::runtime_error(message.str());
+	}
+}
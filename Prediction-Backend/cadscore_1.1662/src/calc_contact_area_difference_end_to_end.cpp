@@ -0,0 +1,417 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "protein/atom.h"
+#include "protein/atoms_reading.h"
+#include "protein/residue_id.h"
+#include "protein/residue_summary.h"
+#include "protein/residue_ids_collection.h"
+
+#include "contacto/inter_atom_contact.h"
+#include "contacto/inter_residue_contacts_combination.h"
+#include "contacto/residue_contact_area_difference_profile.h"
+#include "contacto/residue_contact_area_difference_basic_scoring_functors.h"
+#include "contacto/contact_classification.h"
+
+#include "auxiliaries/command_line_options.h"
+#include "auxiliaries/std_containers_io.h"
+
+#include "shared_mode_functions.h"
+
+namespace
+{
+
+struct EndToEndParameters
+{
+	std::string radius_classes_file_name;
+	std::string radius_members_file_name;
+	bool include_heteroatoms;
+	bool auto_rename_chains;
+	bool inter_chain;
+	bool interface_zone;
+	std::string inter_interval;
+	bool nucleic_acids;
+	bool optimally_rename_chains;
+	bool disable_filtering;
+	bool allow_unmatched_residue_names;
+	std::string engine;
+	std::size_t subdivision_depth;
+	double probe_radius;
+	std::size_t number_of_threads;
+};
+
+struct StructureContacts
+{
+	std::vector<protein::Atom> atoms;
+	std::map<protein::ResidueID, protein::ResidueSummary> residue_ids;
+	std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts;
+};
+
+std::vector<protein::Atom> collect_atoms_from_PDB_file(const std::string& file_name, const protein::VanDerWaalsRadiusAssigner& radius_assigner, const EndToEndParameters& parameters)
+{
+	std::ifstream input(file_name.c_str());
+	if(!input.good())
+	{
+		throw std::runtime_error(std::string("Failed to open file '")+file_name+"'");
+	}
+	const std::vector<protein::Atom> atoms=collect_atoms_from_PDB_file_stream(input, radius_assigner, parameters.include_heteroatoms, false, false, "", parameters.auto_rename_chains);
+	if(atoms.empty())
+	{
+		throw std::runtime_error(std::string("No atoms in file '")+file_name+"'");
+	}
+	return atoms;
+}
+
+std::vector<protein::Atom> filter_model_atoms(const std::vector<protein::Atom>& model_atoms, const StructureContacts& target, const EndToEndParameters& parameters)
+{
+	if(parameters.disable_filtering)
+	{
+		return model_atoms;
+	}
+	const std::vector<protein::Atom> filtered_model_atoms=filter_atoms_by_target_atoms(model_atoms, target.atoms, parameters.allow_unmatched_residue_names);
+	if(filtered_model_atoms.empty())
+	{
+		throw std::runtime_error("No atoms left in the model after filtering by target");
+	}
+	return filtered_model_atoms;
+}
+
+StructureContacts construct_structure_contacts(const std::vector<protein::Atom>& atoms, const EndToEndParameters& parameters, const std::size_t number_of_threads, std::ostream& log_output)
+{
+	StructureContacts result;
+	result.atoms=atoms;
+
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=construct_inter_atom_contacts(result.atoms, parameters.engine, parameters.subdivision_depth, parameters.probe_radius, number_of_threads, false, log_output);
+
+	result.residue_ids=protein::collect_residue_ids_from_atoms(result.atoms);
+	if(result.residue_ids.empty())
+	{
+		throw std::runtime_error("No residue identifiers were collected");
+	}
+
+	result.inter_residue_contacts=construct_filtered_inter_residue_contacts(result.atoms, inter_atom_contacts, false, parameters.interface_zone, parameters.inter_chain, parameters.inter_interval, false);
+	if(parameters.nucleic_acids)
+	{
+		add_inter_nucleotide_side_chain_contact_categories(result.atoms, false, result.inter_residue_contacts);
+	}
+	if(result.inter_residue_contacts.empty())
+	{
+		throw std::runtime_error("No inter-residue contacts constructed");
+	}
+
+	return result;
+}
+
+std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> construct_profile_for_model(const StructureContacts& target, const StructureContacts& model, const EndToEndParameters& parameters, std::ostream& log_output)
+{
+	std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combined_inter_residue_contacts;
+	if(parameters.optimally_rename_chains)
+	{
+		std::string renaming_comment;
+		combined_inter_residue_contacts=combine_inter_residue_contacts_with_optimal_chains_renaming(target.inter_residue_contacts, model.inter_residue_contacts, target.residue_ids, false, renaming_comment, log_output);
+	}
+	else
+	{
+		combined_inter_residue_contacts=contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(target.inter_residue_contacts, model.inter_residue_contacts, false);
+	}
+	if(combined_inter_residue_contacts.empty())
+	{
+		throw std::runtime_error("No combined inter-residue contacts constructed");
+	}
+
+	const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> profile=
+			contacto::construct_residue_contact_area_difference_profile<protein::ResidueID, protein::ResidueSummary, contacto::BoundedDifferenceProducer, contacto::SimpleReferenceProducer>(combined_inter_residue_contacts, target.residue_ids);
+	if(profile.empty())
+	{
+		throw std::runtime_error("No profile constructed");
+	}
+
+	return profile;
+}
+
+EndToEndParameters read_end_to_end_parameters(const auxiliaries::CommandLineOptions& clo)
+{
+	EndToEndParameters parameters;
+	if(clo.isopt("--radius-classes") || clo.isopt("--radius-members"))
+	{
+		parameters.radius_classes_file_name=clo.arg<std::string>("--radius-classes");
+		parameters.radius_members_file_name=clo.arg<std::string>("--radius-members");
+	}
+	parameters.include_heteroatoms=clo.isopt("--HETATM");
+	parameters.auto_rename_chains=clo.isopt("--auto-rename-chains");
+	parameters.inter_chain=clo.isopt("--inter-chain");
+	parameters.interface_zone=clo.isopt("--interface-zone");
+	parameters.inter_interval=clo.isopt("--inter-interval") ? clo.arg<std::string>("--inter-interval") : std::string("");
+	parameters.nucleic_acids=clo.isopt("--nucleic-acids");
+	parameters.optimally_rename_chains=clo.isopt("--optimally-rename-chains");
+	parameters.disable_filtering=clo.isopt("--disable-filtering");
+	parameters.allow_unmatched_residue_names=clo.isopt("--allow-unmatched-residue-names");
+	parameters.engine=read_engine_option(clo);
+	parameters.subdivision_depth=read_depth_option(clo, parameters.engine);
+	parameters.probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
+	parameters.number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
+	return parameters;
+}
+
+std::vector<std::string> read_global_scores_categories(const auxiliaries::CommandLineOptions& clo, const EndToEndParameters& parameters)
+{
+	if(clo.isopt("--categories"))
+	{
+		return clo.arg_vector<std::string>("--categories", ',');
+	}
+	std::vector<std::string> categories;
+	const std::vector<std::string> all_classes=contacto::ContactClassification::get_all_classes_list();
+	categories.insert(categories.end(), all_classes.begin(), all_classes.end());
+	if(parameters.nucleic_acids)
+	{
+		categories.push_back("na_stacking");
+		categories.push_back("na_stacking_down");
+		categories.push_back("na_stacking_up");
+		categories.push_back("na_siding");
+	}
+	return categories;
+}
+
+std::string get_base_name(const std::string& file_name)
+{
+	const std::size_t pos=file_name.find_last_of('/');
+	return (pos==std::string::npos ? file_name : file_name.substr(pos+1));
+}
+
+void append_summary_values(const std::string& summary, const bool full_global_scores, std::vector< std::pair<std::string, std::string> >& values)
+{
+	std::istringstream input(summary);
+	while(input.good())
+	{
+		std::string name;
+		std::string value;
+		input >> name >> value;
+		if(!name.empty() && !value.empty())
+		{
+			if(full_global_scores || (name.find("_diff")==std::string::npos && name.find("_ref")==std::string::npos && name.find('W')==std::string::npos))
+			{
+				values.push_back(std::make_pair(name, value));
+			}
+		}
+	}
+}
+
+void write_file(const std::string& file_name, const std::string& contents)
+{
+	std::ofstream output(file_name.c_str());
+	if(!output.good())
+	{
+		throw std::runtime_error(std::string("Failed to write file '")+file_name+"'");
+	}
+	output << contents;
+}
+
+// Checked before the calculations, so that a wrong directory is reported before any scores are printed
+void check_output_directory(const std::string& output_dir)
+{
+	const std::string probe_file_name=output_dir+"/.cad_write_check";
+	bool writable=false;
+	{
+		std::ofstream output(probe_file_name.c_str());
+		writable=output.good();
+	}
+	if(!writable)
+	{
+		throw std::runtime_error(std::string("Output directory '")+output_dir+"' does not exist or is not writable");
+	}
+	std::remove(probe_file_name.c_str());
+}
+
+}
+
+void calc_contact_area_difference_end_to_end(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--target: --model: --output-dir: --local-category: --local-window: --local-absolute --HETATM --radius-classes: --radius-members: --auto-rename-chains --inter-chain --interface-zone --inter-interval: --nucleic-acids --optimally-rename-chains --disable-filtering --allow-unmatched-residue-names --categories: --engine: --depth: --probe: --threads:");
+
+	const std::string target_file_name=clo.arg<std::string>("--target");
+	const std::string model_file_name=clo.arg<std::string>("--model");
+	const std::string output_dir=clo.isopt("--output-dir") ? clo.arg<std::string>("--output-dir") : std::string("");
+	const std::string local_category=clo.isopt("--local-category") ? clo.arg<std::string>("--local-category") : std::string("");
+	const int local_window=clo.isopt("--local-window") ? clo.arg_in_interval<int>("--local-window", 0, 1000) : 0;
+	const bool local_absolute=clo.isopt("--local-absolute");
+
+	const EndToEndParameters parameters=read_end_to_end_parameters(clo);
+	const std::vector<std::string> categories=read_global_scores_categories(clo, parameters);
+
+	if(!output_dir.empty())
+	{
+		check_output_directory(output_dir);
+	}
+
+	const protein::VanDerWaalsRadiusAssigner radius_assigner=construct_radius_assigner(parameters.radius_classes_file_name, parameters.radius_members_file_name);
+
+	const StructureContacts target=construct_structure_contacts(collect_atoms_from_PDB_file(target_file_name, radius_assigner, parameters), parameters, parameters.number_of_threads, std::clog);
+
+	const StructureContacts model=construct_structure_contacts(filter_model_atoms(collect_atoms_from_PDB_file(model_file_name, radius_assigner, parameters), target, parameters), parameters, parameters.number_of_threads, std::clog);
+
+	const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> profile=construct_profile_for_model(target, model, parameters, std::clog);
+
+	std::ostringstream global_scores_output;
+	print_contact_area_difference_global_scores(profile, categories, false, global_scores_output);
+
+	std::ostringstream size_scores_output;
+	print_contact_area_difference_size_scores(profile, target.residue_ids, model.residue_ids, size_scores_output);
+
+	std::cout << size_scores_output.str() << global_scores_output.str();
+
+	if(!output_dir.empty())
+	{
+		std::ostringstream profile_output;
+		auxiliaries::STDContainersIO::print_map(profile_output, "cad_profile", profile, true);
+		write_file(output_dir+"/cad_profile", profile_output.str());
+		write_file(output_dir+"/cad_global_scores", global_scores_output.str());
+		write_file(output_dir+"/cad_size_scores", size_scores_output.str());
+	}
+
+	if(!local_category.empty())
+	{
+		std::ostringstream local_scores_output;
+		print_contact_area_difference_local_scores(profile, local_category, local_window, local_absolute, local_scores_output);
+		if(output_dir.empty())
+		{
+			std::cout << "\n" << local_scores_output.str();
+		}
+		else
+		{
+			write_file(output_dir+"/cad_local_scores", local_scores_output.str());
+		}
+	}
+}
+
+void calc_contact_area_difference_batch(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--target: --full-global-scores --HETATM --radius-classes: --radius-members: --auto-rename-chains --inter-chain --interface-zone --inter-interval: --nucleic-acids --optimally-rename-chains --disable-filtering --allow-unmatched-residue-names --categories: --engine: --depth: --probe: --threads:");
+
+	const std::string target_file_name=clo.arg<std::string>("--target");
+	const bool full_global_scores=clo.isopt("--full-global-scores");
+
+	const EndToEndParameters parameters=read_end_to_end_parameters(clo);
+	const std::vector<std::string> categories=read_global_scores_categories(clo, parameters);
+
+	std::vector<std::string> model_file_names;
+	while(std::cin.good())
+	{
+		std::string model_file_name;
+		std::cin >> model_file_name;
+		if(!model_file_name.empty())
+		{
+			model_file_names.push_back(model_file_name);
+		}
+	}
+	if(model_file_names.empty())
+	{
+		throw std::runtime_error("No model file names provided");
+	}
+
+	const protein::VanDerWaalsRadiusAssigner radius_assigner=construct_radius_assigner(parameters.radius_classes_file_name, parameters.radius_members_file_name);
+
+	const StructureContacts target=construct_structure_contacts(collect_atoms_from_PDB_file(target_file_name, radius_assigner, parameters), parameters, parameters.number_of_threads, std::clog);
+
+	std::vector< std::vector< std::pair<std::string, std::string> > > rows(model_file_names.size());
+	std::vector<std::string> logs(model_file_names.size());
+	std::vector<std::string> errors(model_file_names.size());
+
+	// When there are fewer models than threads, the threads left over are shared by the contacts constructions of the models
+#ifdef _OPENMP
+	const std::size_t number_of_models_threads=std::min(parameters.number_of_threads, model_file_names.size());
+	const int max_active_levels=omp_get_max_active_levels();
+	if(number_of_models_threads<parameters.number_of_threads)
+	{
+		omp_set_max_active_levels(2);
+	}
+	#pragma omp parallel for num_threads(static_cast<int>(number_of_models_threads)) schedule(dynamic)
+#endif
+	for(int i=0;i<static_cast<int>(model_file_names.size());i++)
+	{
+		std::size_t number_of_model_threads=1;
+#ifdef _OPENMP
+		{
+			const std::size_t thread_id=static_cast<std::size_t>(omp_get_thread_num());
+			number_of_model_threads=parameters.number_of_threads/number_of_models_threads+(thread_id<parameters.number_of_threads%number_of_models_threads ? 1 : 0);
+		}
+#endif
+		std::ostringstream log_output;
+		try
+		{
+			std::vector<protein::Atom> model_atoms;
+#ifdef _OPENMP
+			#pragma omp critical(calc_contact_area_difference_batch_reading)
+#endif
+			{
+				try
+				{
+					model_atoms=collect_atoms_from_PDB_file(model_file_names[i], radius_assigner, parameters);
+				}
+				catch(const std::exception& e)
+				{
+					errors[i]=e.what();
+				}
+			}
+			if(errors[i].empty())
+			{
+				const StructureContacts model=construct_structure_contacts(filter_model_atoms(model_atoms, target, parameters), parameters, number_of_model_threads, log_output);
+				const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> profile=construct_profile_for_model(target, model, parameters, log_output);
+				std::ostringstream summary_output;
+				summary_output << "target " << get_base_name(target_file_name) << "\n";
+				summary_output << "model " << get_base_name(model_file_names[i]) << "\n";
+				print_contact_area_difference_size_scores(profile, target.residue_ids, model.residue_ids, summary_output);
+				print_contact_area_difference_global_scores(profile, categories, false, summary_output);
+				append_summary_values(summary_output.str(), full_global_scores, rows[i]);
+			}
+		}
+		catch(const std::exception& e)
+		{
+			errors[i]=e.what();
+		}
+		logs[i]=log_output.str();
+	}
+#ifdef _OPENMP
+	omp_set_max_active_levels(max_active_levels);
+#endif
+
+	bool header_printed=false;
+	for(std::size_t i=0;i<model_file_names.size();i++)
+	{
+		std::clog << logs[i];
+		if(!errors[i].empty())
+		{
+			std::clog << "Failed to score model '" << model_file_names[i] << "': " << errors[i] << "\n";
+		}
+		else
+		{
+			const std::vector< std::pair<std::string, std::string> >& row=rows[i];
+			if(!header_printed)
+			{
+				for(std::size_t j=0;j<row.size();j++)
+				{
+					std::cout << (j>0 ? "\t" : "") << row[j].first;
+				}
+				std::cout << "\n";
+				header_printed=true;
+			}
+			for(std::size_t j=0;j<row.size();j++)
+			{
+				std::cout << (j>0 ? "\t" : "") << row[j].second;
+			}
+			std::cout << "\n";
+		}
+	}
+
+	if(!header_printed)
+	{
+		throw std::runtime_error("No models were scored");
+	}
+}
@@ -7,17 +7,18 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
 void calc_contact_area_difference_profile(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("--type:");
+	clo.check_allowed_options("--type: --binary-io");
 
 	const int scoring_mode=clo.isopt("--type") ? clo.arg_in_interval<int>("--type", 0, 3) : 0;
 
 	const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combined_inter_residue_contacts=
-			auxiliaries::STDContainersIO::read_map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas >(std::cin, "combined inter-residue contacts", "combined_residue_contacts", false);
+			auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas >(std::cin, "combined inter-residue contacts", "combined_residue_contacts", false);
 
-	const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_1=auxiliaries::STDContainersIO::read_map<protein::ResidueID, protein::ResidueSummary>(std::cin, "target residue identifiers", "residue_ids", false);
+	const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_1=auxiliaries::STDContainersBinaryIO::read_map_in_any_format<protein::ResidueID, protein::ResidueSummary>(std::cin, "target residue identifiers", "residue_ids", false);
 
 	std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> residue_contact_area_difference_profile;
 	if(scoring_mode==0)
@@ -51,6 +52,6 @@ void calc_contact_area_difference_profile(const auxiliaries::CommandLineOptions&
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_map(std::cout, "cad_profile", residue_contact_area_difference_profile, true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "cad_profile", residue_contact_area_difference_profile, true, clo.isopt("--binary-io"));
 	}
 }
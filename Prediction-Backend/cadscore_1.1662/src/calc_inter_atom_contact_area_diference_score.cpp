@@ -12,6 +12,7 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
 namespace
 {
@@ -80,13 +81,13 @@ void calc_inter_atom_contact_area_difference_score(const auxiliaries::CommandLin
 	const bool print_global=clo.isopt("--global") || !print_any_local;
 	const bool inter_chain=clo.isopt("--inter-chain");
 
-	const std::vector<protein::Atom> atoms_1=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "target atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms_1=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "target atoms", "atoms", false);
 
-	const std::vector<contacto::InterAtomContact> inter_atom_contacts_1=auxiliaries::STDContainersIO::read_vector<contacto::InterAtomContact>(std::cin, "target inter-atom contacts", "contacts", false);
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts_1=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<contacto::InterAtomContact>(std::cin, "target inter-atom contacts", "contacts", false);
 
-	const std::vector<protein::Atom> atoms_2=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "model atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms_2=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "model atoms", "atoms", false);
 
-	const std::vector<contacto::InterAtomContact> inter_atom_contacts_2=auxiliaries::STDContainersIO::read_vector<contacto::InterAtomContact>(std::cin, "model inter-atom contacts", "contacts", false);
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts_2=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<contacto::InterAtomContact>(std::cin, "model inter-atom contacts", "contacts", false);
 
 	typedef std::map< contacto::ContactID<protein::AtomID>, std::pair<double, double> > CombinedContactsMap;
 
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <set>
 
 #include "protein/atom.h"
 
@@ -10,41 +13,279 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+#include "auxiliaries/triangulation_disk_cache.h"
 
-void calc_inter_atom_contacts(const auxiliaries::CommandLineOptions& clo)
+#include "shared_mode_functions.h"
+
+std::string read_engine_option(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("--depth: --probe:");
+	const std::string engine=clo.isopt("--engine") ? clo.arg<std::string>("--engine") : std::string("icosahedron");
+	if(engine!="icosahedron" && engine!="adaptive")
+	{
+		throw std::runtime_error("Invalid engine name, allowed names are 'icosahedron' and 'adaptive'");
+	}
+	return engine;
+}
 
-	const std::size_t subdivision_depth=clo.isopt("--depth") ? clo.arg_in_interval<std::size_t>("--depth", 1, 4) : 3;
-	const double probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
+std::size_t read_depth_option(const auxiliaries::CommandLineOptions& clo, const std::string& engine)
+{
+	return (clo.isopt("--depth") ? clo.arg_in_interval<std::size_t>("--depth", 1, (engine=="adaptive" ? 6 : 4)) : 3);
+}
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+namespace
+{
 
+typedef apollota::InterSphereContactSurfaceOnSphere::SurfaceArea SurfaceArea;
+
+std::size_t adaptive_coarse_subdivision_depth(const std::size_t subdivision_depth)
+{
+	return std::min(subdivision_depth, static_cast<std::size_t>(2));
+}
+
+std::vector<SurfaceArea> calculate_surface_areas(const std::string& engine, const std::vector<protein::Atom>& atoms, const apollota::CompressedNeighborsGraph& graph, const std::size_t subdivision_depth, const double probe_radius, const std::size_t number_of_threads, const bool spatial_ordering)
+{
+	if(engine=="adaptive")
+	{
+		return apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas_adaptively(atoms, graph, adaptive_coarse_subdivision_depth(subdivision_depth), subdivision_depth, probe_radius, number_of_threads);
+	}
+	return apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas(atoms, graph, subdivision_depth, probe_radius, number_of_threads, spatial_ordering);
+}
+
+void update_surface_areas(const std::string& engine, const std::vector<protein::Atom>& atoms, const apollota::CompressedNeighborsGraph& graph, const std::size_t subdivision_depth, const double probe_radius, const std::vector<std::size_t>& ids_to_update, std::vector<SurfaceArea>& surface_areas)
+{
+	if(engine=="adaptive")
+	{
+		apollota::InterSphereContactSurfaceOnSphere::update_surface_areas_adaptively(atoms, graph, adaptive_coarse_subdivision_depth(subdivision_depth), subdivision_depth, probe_radius, ids_to_update, surface_areas);
+	}
+	else
+	{
+		apollota::InterSphereContactSurfaceOnSphere::update_surface_areas(atoms, graph, subdivision_depth, probe_radius, ids_to_update, surface_areas);
+	}
+}
+
+struct CachedLogText
+{
+	std::string text;
+
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_string(text);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		text=reader.read_string();
+	}
+};
+
+}
+
+std::vector<contacto::InterAtomContact> construct_inter_atom_contacts(const std::vector<protein::Atom>& atoms, const std::string& engine, const std::size_t subdivision_depth, const double probe_radius, const std::size_t number_of_threads, const bool spatial_ordering, std::ostream& log_output)
+{
 	if(atoms.size()<4)
 	{
 		throw std::runtime_error("Less than 4 atoms provided");
 	}
 
-	const std::vector< std::vector<std::size_t> > graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_neighbors_map(apollota::UtilitiesForTriangulation::collect_neighbors_map_from_quadruples_map(apollota::Triangulation::construct_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, true, false).quadruples_map), atoms.size());
+	const std::vector<apollota::SimpleSphere> spheres=apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms);
+
+	const apollota::CompressedNeighborsGraph graph=(spatial_ordering ?
+			apollota::Triangulation::construct_neighbors_graph_in_spatial_order(spheres, 3.5, true, number_of_threads) :
+			apollota::Triangulation::construct_neighbors_graph(spheres, 3.5, true, number_of_threads));
 
 	for(std::size_t i=0;i<graph.size();i++)
 	{
-		if(graph[i].empty())
+		if(graph.neighbors(i).empty())
 		{
-			std::clog << "Sphere was not included into the Voronoi diagram: " << atoms[i].string_for_human_reading() << "\n";
+			log_output << "Sphere was not included into the Voronoi diagram: " << atoms[i].string_for_human_reading() << "\n";
 		}
 	}
 
 	const std::vector<contacto::InterAtomContact> inter_atom_contacts=apollota::InterSphereContactSurfaceOnSphere::construct_inter_sphere_contacts_from_surface_areas<contacto::InterAtomContact>(
-			apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas(atoms, graph, subdivision_depth, probe_radius));
+			calculate_surface_areas(engine, atoms, graph, subdivision_depth, probe_radius, number_of_threads, spatial_ordering));
 
-	if(atoms.empty() || inter_atom_contacts.empty())
+	if(inter_atom_contacts.empty())
 	{
 		throw std::runtime_error("No inter-atom contacts constructed");
 	}
-	else
+
+	return inter_atom_contacts;
+}
+
+namespace
+{
+
+std::vector<contacto::InterAtomContact> construct_inter_atom_contacts_using_cache(const std::vector<protein::Atom>& atoms, const std::string& engine, const std::size_t subdivision_depth, const double probe_radius, const std::size_t number_of_threads, const bool spatial_ordering, std::ostream& log_output, const auxiliaries::DiskCache& cache)
+{
+	if(!cache.enabled() || atoms.size()<4)
+	{
+		return construct_inter_atom_contacts(atoms, engine, subdivision_depth, probe_radius, number_of_threads, spatial_ordering, log_output);
+	}
+	auxiliaries::DiskCache::Key key=auxiliaries::TriangulationDiskCache::calc_spheres_cache_key("inter-atom contacts 2", apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms));
+	key.add(engine).add(static_cast<unsigned long long>(subdivision_depth)).add(probe_radius);
+	key.add(static_cast<unsigned long long>(spatial_ordering));
+	std::string value;
+	if(cache.read(key, value))
+	{
+		try
+		{
+			std::istringstream input(value);
+			const std::vector<CachedLogText> log=auxiliaries::STDContainersBinaryIO::read_vector<CachedLogText>(input, "log", "log", false);
+			const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersBinaryIO::read_vector<contacto::InterAtomContact>(input, "contacts", "contacts", false);
+			log_output << log.front().text;
+			return inter_atom_contacts;
+		}
+		catch(const std::exception&)
+		{
+		}
+	}
+	std::ostringstream log_buffer;
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=construct_inter_atom_contacts(atoms, engine, subdivision_depth, probe_radius, number_of_threads, spatial_ordering, log_buffer);
+	log_output << log_buffer.str();
+	std::vector<CachedLogText> log(1);
+	log.front().text=log_buffer.str();
+	std::ostringstream output;
+	auxiliaries::STDContainersBinaryIO::print_vector(output, "log", log);
+	auxiliaries::STDContainersBinaryIO::print_vector(output, "contacts", inter_atom_contacts);
+	cache.write(key, output.str());
+	return inter_atom_contacts;
+}
+
+}
+
+void calc_inter_atom_contacts(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--engine: --depth: --probe: --threads: --spatial-ordering --binary-io --cache-dir: --cache-size:");
+
+	const std::string engine=read_engine_option(clo);
+	const std::size_t subdivision_depth=read_depth_option(clo, engine);
+	const double probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
+	const bool spatial_ordering=clo.isopt("--spatial-ordering");
+	const bool binary_io=clo.isopt("--binary-io");
+	const auxiliaries::DiskCache cache=auxiliaries::TriangulationDiskCache::create_disk_cache(clo);
+
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
+
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=construct_inter_atom_contacts_using_cache(atoms, engine, subdivision_depth, probe_radius, number_of_threads, spatial_ordering, std::clog, cache);
+
+	auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", atoms, binary_io);
+	auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "contacts", inter_atom_contacts, binary_io);
+}
+
+void calc_inter_atom_contacts_series(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--output-dir: --engine: --depth: --probe: --binary-io --cache-dir: --cache-size:");
+
+	const std::string output_dir=clo.arg<std::string>("--output-dir");
+	const std::string engine=read_engine_option(clo);
+	const std::size_t subdivision_depth=read_depth_option(clo, engine);
+	const double probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
+	const bool binary_io=clo.isopt("--binary-io");
+	const auxiliaries::DiskCache cache=auxiliaries::TriangulationDiskCache::create_disk_cache(clo);
+
+	std::vector<protein::Atom> previous_atoms;
+	apollota::Triangulation::Result previous_triangulation_result;
+	apollota::CompressedNeighborsGraph previous_graph;
+	std::vector<SurfaceArea> previous_surface_areas;
+
+	while(std::cin.good())
 	{
-		auxiliaries::STDContainersIO::print_vector(std::cout, "atoms", atoms);
-		auxiliaries::STDContainersIO::print_vector(std::cout, "contacts", inter_atom_contacts);
+		std::string atoms_file_name;
+		std::cin >> atoms_file_name;
+		if(!atoms_file_name.empty())
+		{
+			std::ifstream input(atoms_file_name.c_str(), std::ios::binary);
+			if(!input.good())
+			{
+				throw std::runtime_error(std::string("Failed to read file '")+atoms_file_name+"'");
+			}
+			const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(input, "atoms", "atoms", false);
+			if(atoms.size()<4)
+			{
+				throw std::runtime_error(std::string("Less than 4 atoms provided in file '")+atoms_file_name+"'");
+			}
+			const std::vector<apollota::SimpleSphere> spheres=apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms);
+
+			std::set<std::size_t> moved_atoms_ids;
+			if(previous_atoms.size()==atoms.size())
+			{
+				for(std::size_t i=0;i<atoms.size();i++)
+				{
+					const protein::Atom& a=atoms[i];
+					const protein::Atom& b=previous_atoms[i];
+					if(a.x!=b.x || a.y!=b.y || a.z!=b.z || a.r!=b.r)
+					{
+						moved_atoms_ids.insert(i);
+					}
+				}
+			}
+			const bool incremental=(previous_atoms.size()==atoms.size() && moved_atoms_ids.size()*4<=atoms.size());
+
+			const apollota::Triangulation::Result triangulation_result=(incremental ?
+					apollota::Triangulation::update_result(spheres, previous_triangulation_result, moved_atoms_ids, 3.5, true, false) :
+					auxiliaries::TriangulationDiskCache::construct_triangulation_result(spheres, 3.5, true, false, 1, cache));
+
+			const apollota::CompressedNeighborsGraph graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_quadruples_map(triangulation_result.quadruples_map, atoms.size());
+
+			for(std::size_t i=0;i<graph.size();i++)
+			{
+				if(graph.neighbors(i).empty())
+				{
+					std::clog << "Sphere was not included into the Voronoi diagram: " << atoms[i].string_for_human_reading() << "\n";
+				}
+			}
+
+			std::vector<SurfaceArea> surface_areas;
+			if(incremental)
+			{
+				std::vector<std::size_t> ids_to_update;
+				for(std::size_t i=0;i<graph.size();i++)
+				{
+					const apollota::NeighborsRange neighbors=graph.neighbors(i);
+					bool affected=(moved_atoms_ids.count(i)>0 || neighbors!=previous_graph.neighbors(i));
+					for(std::size_t j=0;j<neighbors.size() && !affected;j++)
+					{
+						affected=(moved_atoms_ids.count(neighbors[j])>0);
+					}
+					if(affected)
+					{
+						ids_to_update.push_back(i);
+					}
+				}
+				surface_areas=previous_surface_areas;
+				update_surface_areas(engine, atoms, graph, subdivision_depth, probe_radius, ids_to_update, surface_areas);
+				std::clog << atoms_file_name << ": " << moved_atoms_ids.size() << " moved atoms, " << ids_to_update.size() << " updated atom surfaces\n";
+			}
+			else
+			{
+				surface_areas=calculate_surface_areas(engine, atoms, graph, subdivision_depth, probe_radius, 1, false);
+				std::clog << atoms_file_name << ": full calculation\n";
+			}
+
+			const std::vector<contacto::InterAtomContact> inter_atom_contacts=apollota::InterSphereContactSurfaceOnSphere::construct_inter_sphere_contacts_from_surface_areas<contacto::InterAtomContact>(surface_areas);
+			if(inter_atom_contacts.empty())
+			{
+				throw std::runtime_error(std::string("No inter-atom contacts constructed for file '")+atoms_file_name+"'");
+			}
+
+			const std::size_t base_name_pos=atoms_file_name.find_last_of('/');
+			const std::string output_file_name=output_dir+"/"+(base_name_pos==std::string::npos ? atoms_file_name : atoms_file_name.substr(base_name_pos+1));
+			std::ofstream output(output_file_name.c_str(), std::ios::binary);
+			if(!output.good())
+			{
+				throw std::runtime_error(std::string("Failed to write file '")+output_file_name+"'");
+			}
+			auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(output, "atoms", atoms, binary_io);
+			auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(output, "contacts", inter_atom_contacts, binary_io);
+
+			previous_atoms=atoms;
+			previous_triangulation_result=triangulation_result;
+			previous_graph=graph;
+			previous_surface_areas.swap(surface_areas);
+		}
 	}
 }
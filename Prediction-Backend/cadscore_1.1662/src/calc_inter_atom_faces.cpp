@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 
 #include "protein/atom.h"
 
@@ -11,63 +12,83 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+#include "auxiliaries/triangulation_disk_cache.h"
 
 void calc_inter_atom_faces(const auxiliaries::CommandLineOptions& clo)
 {
 	typedef apollota::InterSphereContactFaceOnHyperboloid CellFace;
 
-	clo.check_allowed_options("--probe: --step: --projections: --add-sas");
+	clo.check_allowed_options("--probe: --step: --projections: --add-sas --threads: --cache-dir: --cache-size:");
 
 	const double probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
 	const double step_length=clo.isopt("--step") ? clo.arg_with_min_value<double>("--step", 0.1) : 0.7;
 	const int projections_count=clo.isopt("--projections") ? clo.arg_with_min_value<int>("--projections", 5) : 5;
 	const bool add_sas=clo.isopt("--add-sas");
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
+	const auxiliaries::DiskCache cache=auxiliaries::TriangulationDiskCache::create_disk_cache(clo);
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
 	if(atoms.size()<4)
 	{
 		throw std::runtime_error("Less than 4 atoms provided");
 	}
 
-	const apollota::Triangulation::Result triangulation_result=apollota::Triangulation::construct_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, true, false);
+	const apollota::Triangulation::Result triangulation_result=auxiliaries::TriangulationDiskCache::construct_triangulation_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, true, false, number_of_threads, cache);
 
-	const apollota::UtilitiesForTriangulation::PairsNeighborsMap pairs_neighbours_map=apollota::UtilitiesForTriangulation::collect_pairs_neighbors_map_from_quadruples_map(triangulation_result.quadruples_map);
+	const apollota::CompressedPairsNeighbors pairs_neighbours=apollota::UtilitiesForTriangulation::collect_pairs_neighbors_from_quadruples_map(triangulation_result.quadruples_map, atoms.size(), number_of_threads);
 
-	std::set<contacto::InterAtomContact> inter_atom_contacts;
+	std::vector<double> faces_areas(pairs_neighbours.pairs.size(), 0.0);
 
-	for(apollota::UtilitiesForTriangulation::PairsNeighborsMap::const_iterator it=pairs_neighbours_map.begin();it!=pairs_neighbours_map.end();++it)
 	{
-		const std::size_t a_id=it->first.get(0);
-		const std::size_t b_id=it->first.get(1);
-
-		const protein::Atom& a=atoms[a_id];
-		const protein::Atom& b=atoms[b_id];
-
-		std::vector<const protein::Atom*> cs;
-		cs.reserve(it->second.size());
-		for(apollota::UtilitiesForTriangulation::PairsNeighborsMap::mapped_type::const_iterator jt=it->second.begin();jt!=it->second.end();++jt)
+		const std::size_t block_size=256;
+		const int blocks_count=static_cast<int>((pairs_neighbours.pairs.size()+block_size-1)/block_size);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+		for(int block=0;block<blocks_count;block++)
 		{
-			cs.push_back(&(atoms[*jt]));
+			CellFace::ConstructionBuffers buffers;
+			std::vector<const protein::Atom*> cs;
+			const std::size_t begin=static_cast<std::size_t>(block)*block_size;
+			const std::size_t end=std::min(begin+block_size, pairs_neighbours.pairs.size());
+			for(std::size_t i=begin;i<end;i++)
+			{
+				const apollota::NeighborsRange c_ids=pairs_neighbours.pairs_neighbors.neighbors(i);
+				cs.clear();
+				for(apollota::NeighborsRange::const_iterator jt=c_ids.begin();jt!=c_ids.end();++jt)
+				{
+					cs.push_back(&(atoms[*jt]));
+				}
+				faces_areas[i]=CellFace::construct(atoms[pairs_neighbours.pairs[i].get(0)], atoms[pairs_neighbours.pairs[i].get(1)], cs, probe_radius, step_length, projections_count, buffers).area();
+			}
 		}
+	}
+
+	std::vector<contacto::InterAtomContact> inter_atom_contacts;
+	inter_atom_contacts.reserve(faces_areas.size()*2+(add_sas ? atoms.size() : 0));
 
-		const double face_area=CellFace::construct(a, b, cs, probe_radius, step_length, projections_count).area();
-		if(apollota::greater(face_area, 0.0))
+	for(std::size_t i=0;i<faces_areas.size();i++)
+	{
+		if(apollota::greater(faces_areas[i], 0.0))
 		{
-			inter_atom_contacts.insert(contacto::InterAtomContact(a_id, b_id, face_area));
-			inter_atom_contacts.insert(contacto::InterAtomContact(b_id, a_id, face_area));
+			const std::size_t a_id=pairs_neighbours.pairs[i].get(0);
+			const std::size_t b_id=pairs_neighbours.pairs[i].get(1);
+			inter_atom_contacts.push_back(contacto::InterAtomContact(a_id, b_id, faces_areas[i]));
+			inter_atom_contacts.push_back(contacto::InterAtomContact(b_id, a_id, faces_areas[i]));
 		}
 	}
 
 	if(add_sas)
 	{
-		const std::vector< std::vector<std::size_t> > graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_neighbors_map(apollota::UtilitiesForTriangulation::collect_neighbors_map_from_quadruples_map(triangulation_result.quadruples_map), atoms.size());
-		const std::vector<contacto::InterAtomContact> inter_atom_spherical_contacts=apollota::InterSphereContactSurfaceOnSphere::construct_inter_sphere_contacts_from_surface_areas<contacto::InterAtomContact>(apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas(atoms, graph, 3, probe_radius));
+		const apollota::CompressedNeighborsGraph graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_quadruples_map(triangulation_result.quadruples_map, atoms.size(), number_of_threads);
+		const std::vector<contacto::InterAtomContact> inter_atom_spherical_contacts=apollota::InterSphereContactSurfaceOnSphere::construct_inter_sphere_contacts_from_surface_areas<contacto::InterAtomContact>(apollota::InterSphereContactSurfaceOnSphere::calculate_surface_areas(atoms, graph, 3, probe_radius, number_of_threads));
 		for(std::size_t i=0;i<inter_atom_spherical_contacts.size();i++)
 		{
 			if(inter_atom_spherical_contacts[i].a==inter_atom_spherical_contacts[i].b)
 			{
-				inter_atom_contacts.insert(inter_atom_spherical_contacts[i]);
+				inter_atom_contacts.push_back(inter_atom_spherical_contacts[i]);
 			}
 		}
 	}
@@ -79,6 +100,7 @@ void calc_inter_atom_faces(const auxiliaries::CommandLineOptions& clo)
 	else
 	{
 		auxiliaries::STDContainersIO::print_vector(std::cout, "atoms", atoms);
-		auxiliaries::STDContainersIO::print_set(std::cout, "contacts", inter_atom_contacts);
+		std::sort(inter_atom_contacts.begin(), inter_atom_contacts.end());
+		auxiliaries::STDContainersIO::print_vector(std::cout, "contacts", inter_atom_contacts);
 	}
 }
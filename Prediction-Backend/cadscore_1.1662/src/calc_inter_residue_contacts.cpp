@@ -11,6 +11,9 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+
+#include "shared_mode_functions.h"
 
 namespace
 {
@@ -29,22 +32,188 @@ std::vector<std::string> collect_chain_names_from_contacts_map(const ContactsMap
 	return vector_of_names;
 }
 
-}
-
-void calc_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo)
+// Searches for the renaming of model chains that gives the best global AA score.
+// The AA score equals 1-(T-G)/T, where T is the total area of target contacts that does not depend on renaming,
+// and G is the sum of gains of target contacts, the gain being the target area minus the bounded difference from the model area.
+// Gains are precomputed for every pair of model chains renamed to every pair of target chains,
+// so a renaming is evaluated without rebuilding contacts maps. Renamings are enumerated in the lexicographic order
+// (as by std::next_permutation), and branches that cannot improve the best sum of gains are cut.
+class OptimalChainsRenamingSearch
 {
-	clo.check_allowed_options("--inter-interval: --inter-chain --core --interface-zone --preserve-reflexive");
+public:
+	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > InterResidueContacts;
+
+	OptimalChainsRenamingSearch(
+			const InterResidueContacts& inter_residue_contacts_1,
+			const InterResidueContacts& inter_residue_contacts_2,
+			const std::map<protein::ResidueID, protein::ResidueSummary>& residue_ids_1,
+			const std::vector<std::string>& chain_names,
+			const bool binarize) :
+				n_(chain_names.size()),
+				total_area_(0.0),
+				gains_(n_*n_*n_*n_, 0.0),
+				best_gain_(0.0),
+				visited_nodes_(0)
+	{
+		std::map<std::string, std::size_t> chain_numbers;
+		for(std::size_t i=0;i<n_;i++)
+		{
+			chain_numbers[chain_names[i]]=i;
+		}
+
+		typedef std::pair<std::size_t, std::size_t> ChainsPair;
+		typedef std::map< std::pair<int, int>, std::vector< std::pair<ChainsPair, double> > > ModelAreas;
+		ModelAreas model_areas;
+		for(InterResidueContacts::const_iterator it=inter_residue_contacts_2.begin();it!=inter_residue_contacts_2.end();++it)
+		{
+			model_areas[std::make_pair(it->first.a.residue_number, it->first.b.residue_number)].push_back(
+					std::make_pair(ChainsPair(chain_numbers[it->first.a.chain_id], chain_numbers[it->first.b.chain_id]), area(it->second, binarize)));
+		}
+
+		const contacto::BoundedDifferenceProducer difference_producer;
+		for(InterResidueContacts::const_iterator it=inter_residue_contacts_1.begin();it!=inter_residue_contacts_1.end();++it)
+		{
+			const double target_area=area(it->second, binarize);
+			if(target_area>0.0 && residue_ids_1.count(it->first.a)>0)
+			{
+				total_area_+=target_area;
+				const std::size_t x=chain_numbers[it->first.a.chain_id];
+				const std::size_t y=chain_numbers[it->first.b.chain_id];
+				ModelAreas::const_iterator jt=model_areas.find(std::make_pair(it->first.a.residue_number, it->first.b.residue_number));
+				if(jt!=model_areas.end())
+				{
+					for(std::size_t i=0;i<jt->second.size();i++)
+					{
+						const ChainsPair& model_chains=jt->second[i].first;
+						gains_[index(model_chains.first, model_chains.second, x, y)]+=target_area-difference_producer(target_area, jt->second[i].second);
+					}
+				}
+			}
+		}
+	}
+
+	// Returns the target chain number for every model chain number
+	std::vector<std::size_t> find_best_renaming()
+	{
+		std::vector<std::size_t> renaming(n_, 0);
+		std::vector<bool> used(n_, false);
+		best_renaming_.clear();
+		best_gain_=0.0;
+		visited_nodes_=0;
+		search(0, 0.0, renaming, used);
+		return best_renaming_;
+	}
+
+	double best_score() const
+	{
+		return (total_area_>0.0 ? (1.0-(total_area_-best_gain_)/total_area_) : 0.0);
+	}
+
+	std::size_t visited_nodes() const
+	{
+		return visited_nodes_;
+	}
+
+private:
+	static double area(const contacto::InterResidueContactAreas& contact, const bool binarize)
+	{
+		const double value=contact.areas.value(contacto::ContactCategory::AA);
+		return (binarize ? (value>0.0 ? 1.0 : 0.0) : value);
+	}
+
+	std::size_t index(const std::size_t model_chain_a, const std::size_t model_chain_b, const std::size_t target_chain_a, const std::size_t target_chain_b) const
+	{
+		return (((model_chain_a*n_+model_chain_b)*n_+target_chain_a)*n_+target_chain_b);
+	}
+
+	// Gains that are equal up to rounding errors are treated as equal, so the earliest of such renamings is kept
+	double tolerance() const
+	{
+		return (total_area_*1e-9);
+	}
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	double calc_upper_bound_of_remaining_gain(const std::size_t depth, const std::vector<std::size_t>& renaming, const std::vector<bool>& used) const
+	{
+		double bound=0.0;
+		for(std::size_t j=0;j<n_;j++)
+		{
+			for(std::size_t k=std::max(j, depth);k<n_;k++)
+			{
+				for(int direction=0;direction<(j==k ? 1 : 2);direction++)
+				{
+					const std::size_t a=(direction==0 ? j : k);
+					const std::size_t b=(direction==0 ? k : j);
+					double max_gain=0.0;
+					for(std::size_t x=0;x<n_;x++)
+					{
+						if((a<depth && x==renaming[a]) || (a>=depth && !used[x]))
+						{
+							for(std::size_t y=0;y<n_;y++)
+							{
+								if(((b<depth && y==renaming[b]) || (b>=depth && !used[y])) && ((a==b)==(x==y)))
+								{
+									max_gain=std::max(max_gain, gains_[index(a, b, x, y)]);
+								}
+							}
+						}
+					}
+					bound+=max_gain;
+				}
+			}
+		}
+		return bound;
+	}
 
-	const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersIO::read_vector<contacto::InterAtomContact>(std::cin, "inter-atom contacts", "contacts", false);
+	void search(const std::size_t depth, const double gain, std::vector<std::size_t>& renaming, std::vector<bool>& used)
+	{
+		visited_nodes_++;
+		if(depth==n_)
+		{
+			if(best_renaming_.empty() || gain>best_gain_+tolerance())
+			{
+				best_renaming_=renaming;
+				best_gain_=gain;
+			}
+			return;
+		}
+		for(std::size_t x=0;x<n_;x++)
+		{
+			if(!used[x])
+			{
+				renaming[depth]=x;
+				used[x]=true;
+				double next_gain=gain+gains_[index(depth, depth, x, x)];
+				for(std::size_t k=0;k<depth;k++)
+				{
+					next_gain+=gains_[index(depth, k, x, renaming[k])]+gains_[index(k, depth, renaming[k], x)];
+				}
+				if(best_renaming_.empty() || next_gain+calc_upper_bound_of_remaining_gain(depth+1, renaming, used)>best_gain_+tolerance())
+				{
+					search(depth+1, next_gain, renaming, used);
+				}
+				used[x]=false;
+			}
+		}
+	}
+
+	std::size_t n_;
+	double total_area_;
+	std::vector<double> gains_;
+	std::vector<std::size_t> best_renaming_;
+	double best_gain_;
+	std::size_t visited_nodes_;
+};
 
+}
+
+std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > construct_filtered_inter_residue_contacts(const std::vector<protein::Atom>& atoms, const std::vector<contacto::InterAtomContact>& inter_atom_contacts, const bool core, const bool interface_zone, const bool inter_chain, const std::string& inter_interval, const bool preserve_reflexive)
+{
 	const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > unfiltered_inter_residue_contacts=contacto::construct_inter_residue_contacts<protein::Atom, protein::ResidueID>(atoms, inter_atom_contacts);
 
 	std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts=unfiltered_inter_residue_contacts;
-	contacto::filter_custom_contacts<protein::ResidueID, contacto::InterResidueContactAreas, protein::ResidueIDsIntervalsReader>(inter_residue_contacts, clo.isopt("--core"), clo.isopt("--interface-zone"), clo.isopt("--inter-chain"), (clo.isopt("--inter-interval") ? clo.arg<std::string>("--inter-interval") : std::string("")));
+	contacto::filter_custom_contacts<protein::ResidueID, contacto::InterResidueContactAreas, protein::ResidueIDsIntervalsReader>(inter_residue_contacts, core, interface_zone, inter_chain, inter_interval);
 
-	if(clo.isopt("--preserve-reflexive"))
+	if(preserve_reflexive)
 	{
 		std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > reflexive_contacts;
 		for(std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >::const_iterator it=inter_residue_contacts.begin();it!=inter_residue_contacts.end();++it)
@@ -67,130 +236,148 @@ void calc_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo)
 		inter_residue_contacts.insert(reflexive_contacts.begin(), reflexive_contacts.end());
 	}
 
+	return inter_residue_contacts;
+}
+
+void calc_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--inter-interval: --inter-chain --core --interface-zone --preserve-reflexive --binary-io");
+
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
+
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<contacto::InterAtomContact>(std::cin, "inter-atom contacts", "contacts", false);
+
+	const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts=construct_filtered_inter_residue_contacts(atoms, inter_atom_contacts, clo.isopt("--core"), clo.isopt("--interface-zone"), clo.isopt("--inter-chain"), (clo.isopt("--inter-interval") ? clo.arg<std::string>("--inter-interval") : std::string("")), clo.isopt("--preserve-reflexive"));
+
 	if(inter_residue_contacts.empty())
 	{
 		throw std::runtime_error("No inter-residue contacts constructed");
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_map(std::cout, "residue_contacts", inter_residue_contacts, true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "residue_contacts", inter_residue_contacts, true, clo.isopt("--binary-io"));
 	}
 }
 
-void calc_combined_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo)
+std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combine_inter_residue_contacts_with_optimal_chains_renaming(
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts_1,
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts_2,
+		const std::map<protein::ResidueID, protein::ResidueSummary>& residue_ids_1,
+		const bool binarize,
+		std::string& renaming_comment,
+		std::ostream& log_output)
 {
 	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > InterResidueContacts;
 	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > CombinedInterResidueContacts;
 
-	clo.check_allowed_options("--optimally-rename-chains --binarize");
-
-	const bool binarize=clo.isopt("--binarize");
-
-	InterResidueContacts inter_residue_contacts_1=auxiliaries::STDContainersIO::read_map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "target inter-residue contacts", "residue_contacts", false);
-	InterResidueContacts inter_residue_contacts_2=auxiliaries::STDContainersIO::read_map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "model inter-residue contacts", "residue_contacts", false);
+	const std::vector<std::string> chain_names_1=collect_chain_names_from_contacts_map(inter_residue_contacts_1);
+	const std::vector<std::string> chain_names_2=collect_chain_names_from_contacts_map(inter_residue_contacts_2);
 
-	CombinedInterResidueContacts resulting_combined_inter_residue_contacts;
+	bool renaming_allowed=(chain_names_1.size()>1 && chain_names_1.size()==chain_names_2.size());
+	for(std::size_t j=0;j<chain_names_1.size() && renaming_allowed;j++)
+	{
+		renaming_allowed=(chain_names_1[j]==chain_names_2[j]);
+	}
 
-	bool renaming_performed=false;
-	std::string renaming_comment="";
-	if(clo.isopt("--optimally-rename-chains"))
+	if(!renaming_allowed)
 	{
-		const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_1=auxiliaries::STDContainersIO::read_map<protein::ResidueID, protein::ResidueSummary>(std::cin, "target residue identifiers", "residue_ids", false);;
-		const std::vector<std::string> chain_names_1=collect_chain_names_from_contacts_map(inter_residue_contacts_1);
-		const std::vector<std::string> chain_names_2=collect_chain_names_from_contacts_map(inter_residue_contacts_2);
+		log_output << "Chains renaming was not possible\n";
+		return contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(inter_residue_contacts_1, inter_residue_contacts_2, binarize);
+	}
 
-		bool renaming_allowed=(chain_names_1.size()>1 && chain_names_1.size()==chain_names_2.size());
-		for(std::size_t j=0;j<chain_names_1.size() && renaming_allowed;j++)
-		{
-			renaming_allowed=(chain_names_1[j]==chain_names_2[j]);
-		}
+	OptimalChainsRenamingSearch search(inter_residue_contacts_1, inter_residue_contacts_2, residue_ids_1, chain_names_1, binarize);
+	const std::vector<std::size_t> best_renaming=search.find_best_renaming();
+	std::vector<std::string> chain_names_permutation(chain_names_2.size());
+	for(std::size_t j=0;j<chain_names_2.size();j++)
+	{
+		chain_names_permutation[j]=chain_names_1[best_renaming[j]];
+	}
 
-		if(renaming_allowed)
+	InterResidueContacts inter_residue_contacts_2_with_renamed_chains;
+	for(InterResidueContacts::const_iterator it=inter_residue_contacts_2.begin();it!=inter_residue_contacts_2.end();++it)
+	{
+		contacto::ContactID<protein::ResidueID> cid=it->first;
+		bool a_renamed=false;
+		bool b_renamed=false;
+		for(std::size_t j=0;j<chain_names_2.size() && !(a_renamed && b_renamed);j++)
 		{
-			std::pair<double, CombinedInterResidueContacts> best_variation(-1.0, CombinedInterResidueContacts());
-			std::vector<std::string> chain_names_permutation=chain_names_1;
-			do
+			if(!a_renamed && cid.a.chain_id==chain_names_2[j])
 			{
-				InterResidueContacts inter_residue_contacts_2_with_renamed_chains;
-				for(InterResidueContacts::const_iterator it=inter_residue_contacts_2.begin();it!=inter_residue_contacts_2.end();++it)
-				{
-					contacto::ContactID<protein::ResidueID> cid=it->first;
-					bool a_renamed=false;
-					bool b_renamed=false;
-					for(std::size_t j=0;j<chain_names_2.size() && !(a_renamed && b_renamed);j++)
-					{
-						if(!a_renamed && cid.a.chain_id==chain_names_2[j])
-						{
-							cid.a.chain_id=chain_names_permutation[j];
-							a_renamed=true;
-						}
-						if(!b_renamed && cid.b.chain_id==chain_names_2[j])
-						{
-							cid.b.chain_id=chain_names_permutation[j];
-							b_renamed=true;
-						}
-					}
-					inter_residue_contacts_2_with_renamed_chains[cid]=it->second;
-				}
+				cid.a.chain_id=chain_names_permutation[j];
+				a_renamed=true;
+			}
+			if(!b_renamed && cid.b.chain_id==chain_names_2[j])
+			{
+				cid.b.chain_id=chain_names_permutation[j];
+				b_renamed=true;
+			}
+		}
+		inter_residue_contacts_2_with_renamed_chains[cid]=it->second;
+	}
 
-				CombinedInterResidueContacts combined_inter_residue_contacts=contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(inter_residue_contacts_1, inter_residue_contacts_2_with_renamed_chains, binarize);
+	const CombinedInterResidueContacts combined_inter_residue_contacts=contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(inter_residue_contacts_1, inter_residue_contacts_2_with_renamed_chains, binarize);
 
-				const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> residue_contact_area_difference_profile=contacto::construct_residue_contact_area_difference_profile<protein::ResidueID, protein::ResidueSummary, contacto::BoundedDifferenceProducer, contacto::SimpleReferenceProducer>(combined_inter_residue_contacts, residue_ids_1);
-				const contacto::ResidueContactAreaDifferenceScore global_score=contacto::calculate_global_contact_area_difference_score_from_profile(residue_contact_area_difference_profile, false);
-				const contacto::Ratio ratio=global_score.ratio("AA");
-				if(ratio.reference>0.0)
-				{
-					const double score_from_ratio=(1-(ratio.difference/ratio.reference));
-					if(score_from_ratio>best_variation.first)
-					{
-						best_variation.first=score_from_ratio;
-						best_variation.second=combined_inter_residue_contacts;
-						{
-							std::ostringstream renaming_comment_stream;
-							renaming_comment_stream << "Renamed chains from ( ";
-							for(std::size_t j=0;j<chain_names_2.size();j++)
-							{
-								renaming_comment_stream << chain_names_2[j] << " ";
-							}
-							renaming_comment_stream << ") to ( ";
-							for(std::size_t j=0;j<chain_names_2.size();j++)
-							{
-								renaming_comment_stream << chain_names_permutation[j] << " ";
-							}
-							renaming_comment_stream << ")";
-							renaming_comment=renaming_comment_stream.str();
-						}
-					}
-				}
+	const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> residue_contact_area_difference_profile=contacto::construct_residue_contact_area_difference_profile<protein::ResidueID, protein::ResidueSummary, contacto::BoundedDifferenceProducer, contacto::SimpleReferenceProducer>(combined_inter_residue_contacts, residue_ids_1);
+	const contacto::ResidueContactAreaDifferenceScore global_score=contacto::calculate_global_contact_area_difference_score_from_profile(residue_contact_area_difference_profile, false);
+	const contacto::Ratio ratio=global_score.ratio("AA");
 
-				std::clog << "Tried renaming chains: ( ";
-				for(std::size_t j=0;j<chain_names_2.size();j++)
-				{
-					std::clog << chain_names_2[j] << " ";
-				}
-				std::clog << ") -> ( ";
-				for(std::size_t j=0;j<chain_names_2.size();j++)
-				{
-					std::clog << chain_names_permutation[j] << " ";
-				}
-				std::clog << "), got AA-score == " << (ratio.reference>0.0 ? (1-(ratio.difference/ratio.reference)) : 0.0) << "\n";
-			}
-			while(std::next_permutation(chain_names_permutation.begin(), chain_names_permutation.end()));
+	log_output << "Found best renaming of chains (" << search.visited_nodes() << " search nodes visited): ( ";
+	for(std::size_t j=0;j<chain_names_2.size();j++)
+	{
+		log_output << chain_names_2[j] << " ";
+	}
+	log_output << ") -> ( ";
+	for(std::size_t j=0;j<chain_names_2.size();j++)
+	{
+		log_output << chain_names_permutation[j] << " ";
+	}
+	log_output << "), got AA-score == " << (ratio.reference>0.0 ? (1-(ratio.difference/ratio.reference)) : 0.0) << "\n";
 
-			if(best_variation.first>=0.0)
-			{
-				resulting_combined_inter_residue_contacts=best_variation.second;
-			}
+	if(!(ratio.reference>0.0))
+	{
+		return CombinedInterResidueContacts();
+	}
 
-			renaming_performed=true;
+	{
+		std::ostringstream renaming_comment_stream;
+		renaming_comment_stream << "Renamed chains from ( ";
+		for(std::size_t j=0;j<chain_names_2.size();j++)
+		{
+			renaming_comment_stream << chain_names_2[j] << " ";
 		}
-		else
+		renaming_comment_stream << ") to ( ";
+		for(std::size_t j=0;j<chain_names_2.size();j++)
 		{
-			std::clog << "Chains renaming was not possible\n";
+			renaming_comment_stream << chain_names_permutation[j] << " ";
 		}
+		renaming_comment_stream << ")";
+		renaming_comment=renaming_comment_stream.str();
 	}
 
-	if(!renaming_performed)
+	return combined_inter_residue_contacts;
+}
+
+void calc_combined_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo)
+{
+	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > InterResidueContacts;
+	typedef std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > CombinedInterResidueContacts;
+
+	clo.check_allowed_options("--optimally-rename-chains --binarize --binary-io");
+
+	const bool binarize=clo.isopt("--binarize");
+
+	InterResidueContacts inter_residue_contacts_1=auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "target inter-residue contacts", "residue_contacts", false);
+	InterResidueContacts inter_residue_contacts_2=auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "model inter-residue contacts", "residue_contacts", false);
+
+	CombinedInterResidueContacts resulting_combined_inter_residue_contacts;
+
+	std::string renaming_comment="";
+	if(clo.isopt("--optimally-rename-chains"))
+	{
+		const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_1=auxiliaries::STDContainersBinaryIO::read_map_in_any_format<protein::ResidueID, protein::ResidueSummary>(std::cin, "target residue identifiers", "residue_ids", false);;
+		resulting_combined_inter_residue_contacts=combine_inter_residue_contacts_with_optimal_chains_renaming(inter_residue_contacts_1, inter_residue_contacts_2, residue_ids_1, binarize, renaming_comment, std::clog);
+	}
+	else
 	{
 		resulting_combined_inter_residue_contacts=contacto::combine_two_inter_residue_contact_maps<protein::ResidueID>(inter_residue_contacts_1, inter_residue_contacts_2, binarize);
 	}
@@ -199,6 +386,14 @@ void calc_combined_inter_residue_contacts(const auxiliaries::CommandLineOptions&
 	{
 		throw std::runtime_error("No combined inter-residue contacts constructed");
 	}
+	else if(clo.isopt("--binary-io"))
+	{
+		if(!renaming_comment.empty())
+		{
+			std::clog << renaming_comment << "\n";
+		}
+		auxiliaries::STDContainersBinaryIO::print_map(std::cout, "combined_residue_contacts", resulting_combined_inter_residue_contacts);
+	}
 	else
 	{
 		auxiliaries::STDContainersIO::print_file_comment(std::cout, "This file contains combined inter-residue contact areas");
@@ -8,6 +8,8 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+#include "auxiliaries/triangulation_disk_cache.h"
 
 namespace
 {
@@ -39,9 +41,11 @@ void calc_quadruples(
 		const double bsi_init_radius,
 		const bool use_one_radius,
 		const bool augment,
+		const std::size_t number_of_threads,
 		const bool skip_output,
 		const bool print_log,
-		const bool check)
+		const bool check,
+		const auxiliaries::DiskCache& cache)
 {
 	if(input_atoms.size()<4)
 	{
@@ -63,7 +67,7 @@ void calc_quadruples(
 
 	const std::vector<SphereType>& atoms=(*atoms_ptr);
 
-	const apollota::Triangulation::Result apollonius_triangulation_result=apollota::Triangulation::construct_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), bsi_init_radius, false, augment);
+	const apollota::Triangulation::Result apollonius_triangulation_result=auxiliaries::TriangulationDiskCache::construct_triangulation_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), bsi_init_radius, false, augment, number_of_threads, cache);
 
 	if(!skip_output)
 	{
@@ -86,22 +90,24 @@ void calc_quadruples(
 
 void calc_quadruples(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("--bsi-init-radius: --raw-input --use-one-radius --augment --skip-output --print-log --check");
+	clo.check_allowed_options("--bsi-init-radius: --raw-input --use-one-radius --augment --threads: --skip-output --print-log --check --cache-dir: --cache-size:");
 
 	const double bsi_init_radius=clo.isopt("--bsi-init-radius") ? clo.arg_with_min_value<double>("--bsi-radius", 1) : 3.5;
 	const bool raw_input=clo.isopt("--raw-input");
 	const bool use_one_radius=clo.isopt("--use-one-radius");
 	const bool augment=clo.isopt("--augment");
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
 	const bool skip_output=clo.isopt("--skip-output");
 	const bool print_log=clo.isopt("--print-log");
 	const bool check=clo.isopt("--check");
+	const auxiliaries::DiskCache cache=auxiliaries::TriangulationDiskCache::create_disk_cache(clo);
 
 	if(raw_input)
 	{
-		calc_quadruples(read_raw_spheres_from_stream(std::cin), bsi_init_radius, use_one_radius, augment, skip_output, print_log, check);
+		calc_quadruples(read_raw_spheres_from_stream(std::cin), bsi_init_radius, use_one_radius, augment, number_of_threads, skip_output, print_log, check, cache);
 	}
 	else
 	{
-		calc_quadruples(auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false), bsi_init_radius, use_one_radius, augment, skip_output, print_log, check);
+		calc_quadruples(auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false), bsi_init_radius, use_one_radius, augment, number_of_threads, skip_output, print_log, check, cache);
 	}
 }
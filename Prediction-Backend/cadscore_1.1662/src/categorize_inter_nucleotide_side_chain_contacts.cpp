@@ -8,6 +8,9 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+
+#include "shared_mode_functions.h"
 
 namespace
 {
@@ -74,27 +77,15 @@ struct NucleotidePlane
 
 }
 
-void categorize_inter_nucleotide_side_chain_contacts(const auxiliaries::CommandLineOptions& clo)
+void add_inter_nucleotide_side_chain_contact_categories(const std::vector<protein::Atom>& atoms, const bool use_atom_centers, std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts)
 {
-	clo.check_allowed_options("--diagnostic-output --use-atom-centers --output-normals-cos --output-rings-shift");
-
-	const bool diagnostic_output=clo.isopt("--diagnostic-output");
-	const bool use_atom_centers=clo.isopt("--use-atom-centers");
-	const bool output_normals_cos=clo.isopt("--output-normals-cos");
-	const bool output_rings_shift=clo.isopt("--output-rings-shift");
-
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
-
-	std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts=
-			auxiliaries::STDContainersIO::read_map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "inter-residue contacts", "residue_contacts", false);
-
 	const std::map< protein::ResidueID, NucleotidePlane > nucleotides_planes=NucleotidePlane::calc_nucleotides_planes(atoms);
 
 	const std::map< protein::ResidueID, std::vector<std::size_t> > residue_ids_atoms=protein::group_atoms_indices_by_residue_ids(atoms);
 
 	for(std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >::iterator it=inter_residue_contacts.begin();it!=inter_residue_contacts.end();++it)
 	{
-		const double area=it->second.area("SS");
+		const double area=it->second.areas.value(contacto::ContactCategory::SS);
 		if(area>0.0)
 		{
 			const protein::ResidueID& rid_a=it->first.a;
@@ -130,25 +121,44 @@ void categorize_inter_nucleotide_side_chain_contacts(const auxiliaries::CommandL
 					{
 						if(first_halfspace<0)
 						{
-							it->second.areas["na_stacking_down"]=area;
+							it->second.areas.insert(contacto::ContactCategory::na_stacking_down)=area;
 						}
 						else
 						{
-							it->second.areas["na_stacking_up"]=area;
+							it->second.areas.insert(contacto::ContactCategory::na_stacking_up)=area;
 						}
-						it->second.areas["na_stacking"]=area;
+						it->second.areas.insert(contacto::ContactCategory::na_stacking)=area;
 					}
 					else
 					{
-						it->second.areas["na_siding"]=area;
+						it->second.areas.insert(contacto::ContactCategory::na_siding)=area;
 					}
 				}
 			}
 		}
 	}
+}
+
+void categorize_inter_nucleotide_side_chain_contacts(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--diagnostic-output --use-atom-centers --output-normals-cos --output-rings-shift --binary-io");
+
+	const bool diagnostic_output=clo.isopt("--diagnostic-output");
+	const bool use_atom_centers=clo.isopt("--use-atom-centers");
+	const bool output_normals_cos=clo.isopt("--output-normals-cos");
+	const bool output_rings_shift=clo.isopt("--output-rings-shift");
+
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
+
+	std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts=
+			auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "inter-residue contacts", "residue_contacts", false);
+
+	add_inter_nucleotide_side_chain_contact_categories(atoms, use_atom_centers, inter_residue_contacts);
 
 	if(diagnostic_output)
 	{
+		const std::map< protein::ResidueID, NucleotidePlane > nucleotides_planes=NucleotidePlane::calc_nucleotides_planes(atoms);
+		const std::map< protein::ResidueID, std::vector<std::size_t> > residue_ids_atoms=protein::group_atoms_indices_by_residue_ids(atoms);
 		std::vector<std::string> contact_types_of_interest;
 		contact_types_of_interest.push_back("na_stacking");
 		contact_types_of_interest.push_back("na_siding");
@@ -199,6 +209,6 @@ void categorize_inter_nucleotide_side_chain_contacts(const auxiliaries::CommandL
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_map(std::cout, "residue_contacts", inter_residue_contacts, true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "residue_contacts", inter_residue_contacts, true, clo.isopt("--binary-io"));
 	}
 }
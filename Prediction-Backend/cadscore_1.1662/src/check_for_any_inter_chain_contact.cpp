@@ -8,9 +8,9 @@
 #include "apollota/search_for_spherical_collisions.h"
 
 #include "auxiliaries/command_line_options.h"
-#include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
-protein::VanDerWaalsRadiusAssigner construct_radius_assigner(const std::string& radius_classes_file_name, const std::string& radius_members_file_name);
+#include "shared_mode_functions.h"
 
 void check_for_any_inter_chain_contact(const auxiliaries::CommandLineOptions& clo)
 {
@@ -64,13 +64,7 @@ void check_for_any_inter_chain_contact(const auxiliaries::CommandLineOptions& cl
 	}
 	else
 	{
-		std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", true);
-
-		while(auxiliaries::STDContainersIO::check_file_header(std::cin, "atoms"))
-		{
-			std::vector<protein::Atom> more_atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "more atoms", "", true);
-			atoms.insert(atoms.end(), more_atoms.begin(), more_atoms.end());
-		}
+		const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_concatenated_vectors_in_any_format<protein::Atom>(std::cin, "atoms", "atoms");
 
 		for(std::size_t i=0;i<atoms.size();i++)
 		{
@@ -7,6 +7,7 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
 namespace
 {
@@ -51,7 +52,7 @@ void check_for_inter_atom_clashes(const auxiliaries::CommandLineOptions& clo)
 	const bool inter_chain=clo.isopt("--inter-chain");
 	const bool only_main_chain=clo.isopt("--only-main-chain");
 
-	std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
 	if(only_main_chain)
 	{
@@ -11,9 +11,12 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
 #include "resources/vdwr.h"
 
+#include "shared_mode_functions.h"
+
 protein::VanDerWaalsRadiusAssigner construct_radius_assigner(const std::string& radius_classes_file_name, const std::string& radius_members_file_name)
 {
 
@@ -48,27 +51,16 @@ protein::VanDerWaalsRadiusAssigner construct_radius_assigner(const std::string&
 	return radius_assigner;
 }
 
-void collect_atoms(const auxiliaries::CommandLineOptions& clo)
+std::vector<protein::Atom> collect_atoms_from_PDB_file_stream(
+		std::istream& pdb_file_stream,
+		const protein::VanDerWaalsRadiusAssigner& radius_assigner,
+		const bool include_heteroatoms,
+		const bool include_water,
+		const bool include_insertions,
+		const std::string& simple_chain_renaming,
+		const bool auto_rename_chains)
 {
-	clo.check_allowed_options("--radius-classes: --radius-members: --HETATM --HOH --rename-chain: --auto-rename-chains --include-insertions");
-
-	std::string radius_classes_file_name="";
-	std::string radius_members_file_name="";
-	if(clo.isopt("--radius-classes") || clo.isopt("--radius-members"))
-	{
-		radius_classes_file_name=clo.arg<std::string>("--radius-classes");
-		radius_members_file_name=clo.arg<std::string>("--radius-members");
-	}
-
-	const bool include_heteroatoms=clo.isopt("--HETATM");
-	const bool include_water=clo.isopt("--HOH");
-	const std::string simple_chain_renaming=clo.isopt("--rename-chain") ? clo.arg<std::string>("--rename-chain") : std::string("");
-	const bool auto_rename_chains=clo.isopt("--auto-rename-chains");
-	const bool include_insertions=clo.isopt("--include-insertions");
-
-	const protein::VanDerWaalsRadiusAssigner radius_assigner=construct_radius_assigner(radius_classes_file_name, radius_members_file_name);
-
-	std::vector<protein::Atom> atoms=protein::AtomsReading::read_atoms_from_PDB_file_stream(std::cin, radius_assigner, include_heteroatoms, include_water, include_insertions);
+	std::vector<protein::Atom> atoms=protein::AtomsReading::read_atoms_from_PDB_file_stream(pdb_file_stream, radius_assigner, include_heteroatoms, include_water, include_insertions);
 
 	protein::AtomsClassification::classify_atoms(atoms);
 
@@ -107,30 +99,51 @@ void collect_atoms(const auxiliaries::CommandLineOptions& clo)
 		}
 		for(std::size_t i=0;i<atoms.size();i++)
 		{
-			std::string& atom_chain_id=atoms[i].chain_id;
-			atom_chain_id=chain_names_map[atom_chain_id];
-			if(atom_chain_id.empty())
-			{
-				atom_chain_id="x";
-			}
+			const std::string& new_chain_id=chain_names_map[atoms[i].chain_id];
+			atoms[i].chain_id=(new_chain_id.empty() ? std::string("x") : new_chain_id);
 		}
 	}
 
+	return atoms;
+}
+
+void collect_atoms(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--radius-classes: --radius-members: --HETATM --HOH --rename-chain: --auto-rename-chains --include-insertions --binary-io");
+
+	std::string radius_classes_file_name="";
+	std::string radius_members_file_name="";
+	if(clo.isopt("--radius-classes") || clo.isopt("--radius-members"))
+	{
+		radius_classes_file_name=clo.arg<std::string>("--radius-classes");
+		radius_members_file_name=clo.arg<std::string>("--radius-members");
+	}
+
+	const bool include_heteroatoms=clo.isopt("--HETATM");
+	const bool include_water=clo.isopt("--HOH");
+	const std::string simple_chain_renaming=clo.isopt("--rename-chain") ? clo.arg<std::string>("--rename-chain") : std::string("");
+	const bool auto_rename_chains=clo.isopt("--auto-rename-chains");
+	const bool include_insertions=clo.isopt("--include-insertions");
+
+	const protein::VanDerWaalsRadiusAssigner radius_assigner=construct_radius_assigner(radius_classes_file_name, radius_members_file_name);
+
+	const std::vector<protein::Atom> atoms=collect_atoms_from_PDB_file_stream(std::cin, radius_assigner, include_heteroatoms, include_water, include_insertions, simple_chain_renaming, auto_rename_chains);
+
 	if(atoms.empty())
 	{
 		throw std::runtime_error("No atoms were collected from the provided PDB file stream");
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_vector(std::cout, "atoms", atoms);
+		auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", atoms, clo.isopt("--binary-io"));
 	}
 }
 
 void collect_residue_ids(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("");
+	clo.check_allowed_options("--binary-io");
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
 	const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids=protein::collect_residue_ids_from_atoms(atoms);
 
@@ -140,18 +153,13 @@ void collect_residue_ids(const auxiliaries::CommandLineOptions& clo)
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_map(std::cout, "residue_ids", residue_ids, false);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "residue_ids", residue_ids, false, clo.isopt("--binary-io"));
 	}
 }
 
 void merge_atoms(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("");
-	std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", true);
-	while(auxiliaries::STDContainersIO::check_file_header(std::cin, "atoms"))
-	{
-		std::vector<protein::Atom> more_atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "more atoms", "", true);
-		atoms.insert(atoms.end(), more_atoms.begin(), more_atoms.end());
-	}
-	auxiliaries::STDContainersIO::print_vector(std::cout, "atoms", atoms);
+	clo.check_allowed_options("--binary-io");
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_concatenated_vectors_in_any_format<protein::Atom>(std::cin, "atoms", "atoms");
+	auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", atoms, clo.isopt("--binary-io"));
 }
@@ -0,0 +1,277 @@
+#ifndef CONTACTO_CONTACT_CATEGORIES_H_
+#define CONTACTO_CONTACT_CATEGORIES_H_
+
+#include <map>
+#include <string>
+
+namespace contacto
+{
+
+// Contact categories known in advance, enumerated in the order of their names
+struct ContactCategory
+{
+	enum Value
+	{
+		AA, AM, AS, AW,
+		MA, MM, MS, MW,
+		SA, SM, SS, SW,
+		na_siding, na_stacking, na_stacking_down, na_stacking_up,
+		count
+	};
+
+	static const std::string& name(const int category)
+	{
+		static const std::string names[count]={
+				"AA", "AM", "AS", "AW",
+				"MA", "MM", "MS", "MW",
+				"SA", "SM", "SS", "SW",
+				"na_siding", "na_stacking", "na_stacking_down", "na_stacking_up"};
+		return names[category];
+	}
+
+	// Returns -1 if the name does not belong to a known category
+	static int find(const std::string& category_name)
+	{
+		int low=0;
+		int high=count;
+		while(low<high)
+		{
+			const int middle=(low+high)/2;
+			if(name(middle)<category_name)
+			{
+				low=middle+1;
+			}
+			else
+			{
+				high=middle;
+			}
+		}
+		return ((low<count && name(low)==category_name) ? low : -1);
+	}
+};
+
+/*
+ * Map from category names to values, with the values of known categories kept in a fixed array.
+ * Other names (produced by some auxiliary modes) are kept in a usual map.
+ * Iteration goes through all present names in the same order as in std::map<std::string, T>.
+ */
+template<typename T>
+class CategoriesMap
+{
+public:
+	typedef std::map<std::string, T> ExtraMap;
+
+	template<typename Map, typename Value, typename ExtraIterator>
+	class BasicIterator
+	{
+	public:
+		struct Entry
+		{
+			const std::string& first;
+			Value& second;
+
+			Entry(const std::string& first, Value& second) : first(first), second(second)
+			{
+			}
+		};
+
+		struct Arrow
+		{
+			Entry entry;
+
+			explicit Arrow(const Entry& entry) : entry(entry)
+			{
+			}
+
+			const Entry* operator->() const
+			{
+				return (&entry);
+			}
+		};
+
+		BasicIterator(Map* map, const int category, const ExtraIterator extra_it) : map_(map), category_(category), extra_it_(extra_it)
+		{
+			skip_absent_categories();
+		}
+
+		Entry operator*() const
+		{
+			return (at_category() ? Entry(ContactCategory::name(category_), map_->values_[category_]) : Entry(extra_it_->first, extra_it_->second));
+		}
+
+		Arrow operator->() const
+		{
+			return Arrow(**this);
+		}
+
+		BasicIterator& operator++()
+		{
+			if(at_category())
+			{
+				category_++;
+				skip_absent_categories();
+			}
+			else
+			{
+				++extra_it_;
+			}
+			return (*this);
+		}
+
+		bool operator==(const BasicIterator& it) const
+		{
+			return (category_==it.category_ && extra_it_==it.extra_it_);
+		}
+
+		bool operator!=(const BasicIterator& it) const
+		{
+			return !((*this)==it);
+		}
+
+	private:
+		void skip_absent_categories()
+		{
+			while(category_<ContactCategory::count && !map_->contains(category_))
+			{
+				category_++;
+			}
+		}
+
+		bool at_category() const
+		{
+			return (category_<ContactCategory::count && (extra_it_==map_->extra_.end() || ContactCategory::name(category_)<extra_it_->first));
+		}
+
+		Map* map_;
+		int category_;
+		ExtraIterator extra_it_;
+	};
+
+	typedef BasicIterator<CategoriesMap, T, typename ExtraMap::iterator> iterator;
+	typedef BasicIterator<const CategoriesMap, const T, typename ExtraMap::const_iterator> const_iterator;
+
+	CategoriesMap() : present_(0), values_()
+	{
+	}
+
+	bool contains(const int category) const
+	{
+		return ((present_ & (1u << category))!=0);
+	}
+
+	// Adds the category if it is absent
+	T& insert(const int category)
+	{
+		present_|=(1u << category);
+		return values_[category];
+	}
+
+	// Returns the default value if the category is absent
+	const T& value(const int category) const
+	{
+		return values_[category];
+	}
+
+	const ExtraMap& extra() const
+	{
+		return extra_;
+	}
+
+	T& operator[](const std::string& name)
+	{
+		const int category=ContactCategory::find(name);
+		return (category>=0 ? insert(category) : extra_[name]);
+	}
+
+	std::size_t count(const std::string& name) const
+	{
+		const int category=ContactCategory::find(name);
+		return (category>=0 ? (contains(category) ? 1 : 0) : extra_.count(name));
+	}
+
+	iterator find(const std::string& name)
+	{
+		const int category=ContactCategory::find(name);
+		if(category>=0)
+		{
+			return (contains(category) ? iterator(this, category, extra_.upper_bound(name)) : end());
+		}
+		typename ExtraMap::iterator extra_it=extra_.find(name);
+		return (extra_it!=extra_.end() ? iterator(this, first_category_after(name), extra_it) : end());
+	}
+
+	const_iterator find(const std::string& name) const
+	{
+		const int category=ContactCategory::find(name);
+		if(category>=0)
+		{
+			return (contains(category) ? const_iterator(this, category, extra_.upper_bound(name)) : end());
+		}
+		typename ExtraMap::const_iterator extra_it=extra_.find(name);
+		return (extra_it!=extra_.end() ? const_iterator(this, first_category_after(name), extra_it) : end());
+	}
+
+	iterator begin()
+	{
+		return iterator(this, 0, extra_.begin());
+	}
+
+	iterator end()
+	{
+		return iterator(this, ContactCategory::count, extra_.end());
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, 0, extra_.begin());
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, ContactCategory::count, extra_.end());
+	}
+
+	std::size_t size() const
+	{
+		std::size_t n=extra_.size();
+		for(unsigned int bits=present_;bits!=0;bits&=(bits-1))
+		{
+			n++;
+		}
+		return n;
+	}
+
+	bool empty() const
+	{
+		return (present_==0 && extra_.empty());
+	}
+
+	void clear()
+	{
+		present_=0;
+		for(int i=0;i<ContactCategory::count;i++)
+		{
+			values_[i]=T();
+		}
+		extra_.clear();
+	}
+
+private:
+	static int first_category_after(const std::string& name)
+	{
+		int category=0;
+		while(category<ContactCategory::count && !(name<ContactCategory::name(category)))
+		{
+			category++;
+		}
+		return category;
+	}
+
+	unsigned int present_;
+	T values_[ContactCategory::count];
+	ExtraMap extra_;
+};
+
+}
+
+#endif /* CONTACTO_CONTACT_CATEGORIES_H_ */
@@ -6,6 +6,8 @@
 #include <vector>
 #include <cstdlib>
 
+#include "contact_categories.h"
+
 namespace contacto
 {
 
@@ -34,18 +36,63 @@ public:
 		return std::vector<std::string>();
 	}
 
-	static std::vector<std::string> get_all_classes_list()
+	// Bits 0, 1 and 2 stand for the atom classes A, M and S
+	template<typename AtomType>
+	static unsigned int classify_atom(const AtomType& atom)
 	{
-		std::vector<std::string> all_classes;
-		std::string c1[3]={"A", "M", "S"};
-		std::string c2[4]={"A", "M", "S", "W"};
-		for(int i=0;i<3;i++)
+		unsigned int classes=1;
+		if(atom.location_class==static_cast<int>(AtomType::main_chain))
+		{
+			classes|=2;
+		}
+		else if(atom.location_class==static_cast<int>(AtomType::side_chain))
 		{
-			for(int j=0;j<4;j++)
+			classes|=4;
+		}
+		return classes;
+	}
+
+	// Same as classify_atoms_contact, but with precomputed atom classes and residue identifiers, the bit i is set for the ContactCategory i
+	template<typename AtomType, typename ResidueIDType>
+	static unsigned int classify_atoms_contact(const AtomType& a, const AtomType& b, const unsigned int a_classes, const unsigned int b_classes, const ResidueIDType& a_residue_id, const ResidueIDType& b_residue_id)
+	{
+		unsigned int categories=0;
+		if(a==b)
+		{
+			for(int i=0;i<3;i++)
 			{
-				all_classes.push_back(c1[i]+c2[j]);
+				if((a_classes & (1u << i))!=0)
+				{
+					categories|=(1u << (i*4+3));
+				}
 			}
 		}
+		else if(a_residue_id!=b_residue_id && !check_if_atoms_contact_is_covalent(a, b))
+		{
+			for(int i=0;i<3;i++)
+			{
+				if((a_classes & (1u << i))!=0)
+				{
+					for(int j=0;j<3;j++)
+					{
+						if((b_classes & (1u << j))!=0)
+						{
+							categories|=(1u << (i*4+j));
+						}
+					}
+				}
+			}
+		}
+		return categories;
+	}
+
+	static std::vector<std::string> get_all_classes_list()
+	{
+		std::vector<std::string> all_classes;
+		for(int i=ContactCategory::AA;i<=ContactCategory::SW;i++)
+		{
+			all_classes.push_back(ContactCategory::name(i));
+		}
 		return all_classes;
 	}
 
@@ -30,6 +30,20 @@ struct ContactID
 		return (a<cid.a || (a==cid.a && b<cid.b));
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		a.write_binary(writer);
+		b.write_binary(writer);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		a.read_binary(reader);
+		b.read_binary(reader);
+	}
+
 	friend std::ostream& operator<<(std::ostream& output, const ContactID& contact_id)
 	{
 		output << contact_id.a << " " << contact_id.b;
@@ -39,6 +39,22 @@ struct InterAtomContact
 		return false;
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_int(a);
+		writer.write_int(b);
+		writer.write_double(area);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		a=reader.read_int();
+		b=reader.read_int();
+		area=reader.read_double();
+	}
+
 	friend std::ostream& operator<<(std::ostream &output, const InterAtomContact &contact)
 	{
 		output << contact.a << " ";
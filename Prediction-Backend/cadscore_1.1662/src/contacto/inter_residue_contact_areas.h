@@ -1,16 +1,17 @@
 #ifndef CONTACTO_INTER_RESIDUE_CONTACT_AREAS_H_
 #define CONTACTO_INTER_RESIDUE_CONTACT_AREAS_H_
 
-#include <map>
 #include <string>
 #include <iostream>
 
+#include "contact_categories.h"
+
 namespace contacto
 {
 
 struct InterResidueContactAreas
 {
-	typedef std::map<std::string, double> AreasMap;
+	typedef CategoriesMap<double> AreasMap;
 
 	AreasMap areas;
 
@@ -24,6 +25,29 @@ struct InterResidueContactAreas
 		return (it!=areas.end() ? it->second : 0.0);
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_size(areas.size());
+		for(AreasMap::const_iterator it=areas.begin();it!=areas.end();++it)
+		{
+			writer.write_string(it->first);
+			writer.write_double(it->second);
+		}
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		areas.clear();
+		const std::size_t n=reader.read_size();
+		for(std::size_t i=0;i<n;i++)
+		{
+			const std::string key=reader.read_string();
+			areas[key]=reader.read_double();
+		}
+	}
+
 	friend std::ostream& operator<<(std::ostream& output, const InterResidueContactAreas& contact)
 	{
 		output << contact.areas.size() << "\n";
@@ -1,16 +1,18 @@
 #ifndef CONTACTO_INTER_RESIDUE_CONTACT_DUAL_AREAS_H_
 #define CONTACTO_INTER_RESIDUE_CONTACT_DUAL_AREAS_H_
 
-#include <map>
 #include <string>
+#include <utility>
 #include <iostream>
 
+#include "contact_categories.h"
+
 namespace contacto
 {
 
 struct InterResidueContactDualAreas
 {
-	typedef std::map<std::string, std::pair<double, double> > AreasMap;
+	typedef CategoriesMap< std::pair<double, double> > AreasMap;
 
 	AreasMap areas;
 
@@ -24,6 +26,32 @@ struct InterResidueContactDualAreas
 		return (it!=areas.end() ? it->second : std::make_pair(0.0, 0.0));
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_size(areas.size());
+		for(AreasMap::const_iterator it=areas.begin();it!=areas.end();++it)
+		{
+			writer.write_string(it->first);
+			writer.write_double(it->second.first);
+			writer.write_double(it->second.second);
+		}
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		areas.clear();
+		const std::size_t n=reader.read_size();
+		for(std::size_t i=0;i<n;i++)
+		{
+			const std::string key=reader.read_string();
+			const double value1=reader.read_double();
+			const double value2=reader.read_double();
+			areas[key]=std::make_pair(value1, value2);
+		}
+	}
+
 	friend std::ostream& operator<<(std::ostream& output, const InterResidueContactDualAreas& contact)
 	{
 		output << contact.areas.size() << "\n";
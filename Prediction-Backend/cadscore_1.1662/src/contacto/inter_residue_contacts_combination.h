@@ -14,7 +14,22 @@ namespace contacto
 inline InterResidueContactDualAreas combine_two_contacts(const InterResidueContactAreas& contact_1, const InterResidueContactAreas& contact_2, const bool binarize)
 {
 	InterResidueContactDualAreas combination;
-	combination.areas=combine_two_maps(contact_1.areas, contact_2.areas);
+	for(int category=0;category<ContactCategory::count;category++)
+	{
+		if(contact_1.areas.contains(category) || contact_2.areas.contains(category))
+		{
+			combination.areas.insert(category)=std::make_pair(contact_1.areas.value(category), contact_2.areas.value(category));
+		}
+	}
+	if(!contact_1.areas.extra().empty() || !contact_2.areas.extra().empty())
+	{
+		typedef std::map< std::string, std::pair<double, double> > ExtraCombination;
+		const ExtraCombination extra_combination=combine_two_maps(contact_1.areas.extra(), contact_2.areas.extra());
+		for(ExtraCombination::const_iterator it=extra_combination.begin();it!=extra_combination.end();++it)
+		{
+			combination.areas[it->first]=it->second;
+		}
+	}
 	if(binarize)
 	{
 		for(InterResidueContactDualAreas::AreasMap::iterator it=combination.areas.begin();it!=combination.areas.end();++it)
@@ -15,19 +15,30 @@ namespace contacto
 template<typename Atom, typename ResidueID>
 std::map< ContactID<ResidueID>, InterResidueContactAreas > construct_inter_residue_contacts(const std::vector<Atom>& atoms, const std::vector<InterAtomContact>& inter_atom_contacts)
 {
+	std::vector<unsigned int> atoms_classes(atoms.size());
+	std::vector<ResidueID> atoms_residue_ids;
+	atoms_residue_ids.reserve(atoms.size());
+	for(std::size_t i=0;i<atoms.size();i++)
+	{
+		atoms_classes[i]=ContactClassification::classify_atom(atoms[i]);
+		atoms_residue_ids.push_back(ResidueID::from_atom(atoms[i]));
+	}
 	std::map< ContactID<ResidueID>, InterResidueContactAreas > inter_residue_contacts_map;
 	for(std::size_t i=0;i<inter_atom_contacts.size();i++)
 	{
 		const InterAtomContact& inter_atom_contact=inter_atom_contacts[i];
-		const Atom& a1=atoms[inter_atom_contact.a];
-		const Atom& a2=atoms[inter_atom_contact.b];
-		const std::vector<std::string> contact_classes=ContactClassification::classify_atoms_contact<Atom, ResidueID>(a1, a2);
-		if(!contact_classes.empty())
+		const std::size_t a1=inter_atom_contact.a;
+		const std::size_t a2=inter_atom_contact.b;
+		const unsigned int contact_categories=ContactClassification::classify_atoms_contact(atoms[a1], atoms[a2], atoms_classes[a1], atoms_classes[a2], atoms_residue_ids[a1], atoms_residue_ids[a2]);
+		if(contact_categories!=0)
 		{
-			InterResidueContactAreas& inter_residue_contact_areas=inter_residue_contacts_map[ContactID<ResidueID>(ResidueID::from_atom(a1), ResidueID::from_atom(a2))];
-			for(std::size_t j=0;j<contact_classes.size();j++)
+			InterResidueContactAreas& inter_residue_contact_areas=inter_residue_contacts_map[ContactID<ResidueID>(atoms_residue_ids[a1], atoms_residue_ids[a2])];
+			for(int category=0;category<ContactCategory::count;category++)
 			{
-				inter_residue_contact_areas.areas[contact_classes[j]]+=inter_atom_contact.area;
+				if((contact_categories & (1u << category))!=0)
+				{
+					inter_residue_contact_areas.areas.insert(category)+=inter_atom_contact.area;
+				}
 			}
 		}
 	}
@@ -13,6 +13,20 @@ struct Ratio
 	{
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_double(difference);
+		writer.write_double(reference);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		difference=reader.read_double();
+		reference=reader.read_double();
+	}
+
 	friend std::ostream& operator<<(std::ostream &output, const Ratio &ratio)
 	{
 		output << ratio.difference << " ";
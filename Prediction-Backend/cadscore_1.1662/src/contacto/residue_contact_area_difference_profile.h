@@ -34,7 +34,17 @@ std::map<ResidueID, ResidueContactAreaDifferenceScore> construct_residue_contact
 		{
 			ResidueContactAreaDifferenceScore& residue_score=profile_it->second;
 			const InterResidueContactDualAreas::AreasMap& areas_map=it->second.areas;
-			for(InterResidueContactDualAreas::AreasMap::const_iterator jt=areas_map.begin();jt!=areas_map.end();++jt)
+			for(int category=0;category<ContactCategory::count;category++)
+			{
+				if(areas_map.contains(category))
+				{
+					const std::pair<double, double>& areas=areas_map.value(category);
+					Ratio& ratio=residue_score.ratios.insert(category);
+					ratio.difference+=difference_producer(areas.first, areas.second);
+					ratio.reference+=reference_producer(areas.first, areas.second);
+				}
+			}
+			for(InterResidueContactDualAreas::AreasMap::ExtraMap::const_iterator jt=areas_map.extra().begin();jt!=areas_map.extra().end();++jt)
 			{
 				Ratio& ratio=residue_score.ratios[jt->first];
 				ratio.difference+=difference_producer(jt->second.first, jt->second.second);
@@ -54,7 +64,17 @@ ResidueContactAreaDifferenceScore calculate_global_contact_area_difference_score
 	for(typename std::map<ResidueID, ResidueContactAreaDifferenceScore>::const_iterator it=profile.begin();it!=profile.end();++it)
 	{
 		const ResidueContactAreaDifferenceScore& residue_score=it->second;
-		for(ResidueContactAreaDifferenceScore::RatiosMap::const_iterator jt=residue_score.ratios.begin();jt!=residue_score.ratios.end();++jt)
+		for(int category=0;category<ContactCategory::count;category++)
+		{
+			const Ratio& residue_ratio=residue_score.ratios.value(category);
+			if(residue_score.ratios.contains(category) && residue_ratio.reference>0.0)
+			{
+				Ratio& ratio=global_score.ratios.insert(category);
+				ratio.difference+=(use_min ? std::min(residue_ratio.difference, residue_ratio.reference) : residue_ratio.difference);
+				ratio.reference+=residue_ratio.reference;
+			}
+		}
+		for(ResidueContactAreaDifferenceScore::RatiosMap::ExtraMap::const_iterator jt=residue_score.ratios.extra().begin();jt!=residue_score.ratios.extra().end();++jt)
 		{
 			if(jt->second.reference>0.0)
 			{
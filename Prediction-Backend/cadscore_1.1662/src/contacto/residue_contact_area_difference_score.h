@@ -1,10 +1,10 @@
 #ifndef CONTACTO_RESIDUE_CONTACT_AREA_DIFFERENCE_SCORE_H_
 #define CONTACTO_RESIDUE_CONTACT_AREA_DIFFERENCE_SCORE_H_
 
-#include <map>
 #include <string>
 #include <iostream>
 
+#include "contact_categories.h"
 #include "ratio.h"
 
 namespace contacto
@@ -12,7 +12,7 @@ namespace contacto
 
 struct ResidueContactAreaDifferenceScore
 {
-	typedef std::map<std::string, Ratio> RatiosMap;
+	typedef CategoriesMap<Ratio> RatiosMap;
 
 	RatiosMap ratios;
 
@@ -38,6 +38,29 @@ struct ResidueContactAreaDifferenceScore
 		return (it!=ratios.end() ? it->second : Ratio());
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_size(ratios.size());
+		for(RatiosMap::const_iterator it=ratios.begin();it!=ratios.end();++it)
+		{
+			writer.write_string(it->first);
+			it->second.write_binary(writer);
+		}
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		ratios.clear();
+		const std::size_t n=reader.read_size();
+		for(std::size_t i=0;i<n;i++)
+		{
+			const std::string key=reader.read_string();
+			ratios[key].read_binary(reader);
+		}
+	}
+
 	friend std::ostream& operator<<(std::ostream& output, const ResidueContactAreaDifferenceScore& score)
 	{
 		output << score.ratios.size() << "\n";
@@ -0,0 +1,61 @@
+#include "protein/atom.h"
+#include "protein/residue_id.h"
+#include "protein/residue_summary.h"
+
+#include "contacto/contact_id.h"
+#include "contacto/inter_atom_contact.h"
+#include "contacto/inter_residue_contact_areas.h"
+#include "contacto/inter_residue_contact_dual_areas.h"
+#include "contacto/residue_contact_area_difference_score.h"
+
+#include "auxiliaries/command_line_options.h"
+#include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+
+void convert_data_format(const auxiliaries::CommandLineOptions& clo)
+{
+	clo.check_allowed_options("--type: --binary-io");
+
+	const std::string type=clo.arg<std::string>("--type");
+	const bool binary_io=clo.isopt("--binary-io");
+
+	if(type=="atoms")
+	{
+		const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", true);
+		auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", atoms, binary_io);
+	}
+	else if(type=="inter-atom-contacts")
+	{
+		const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", true);
+		const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<contacto::InterAtomContact>(std::cin, "inter-atom contacts", "contacts", true);
+		auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", atoms, binary_io);
+		auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "contacts", inter_atom_contacts, binary_io);
+	}
+	else if(type=="residue-ids")
+	{
+		const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids=auxiliaries::STDContainersBinaryIO::read_map_in_any_format<protein::ResidueID, protein::ResidueSummary>(std::cin, "residue identifiers", "residue_ids", true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "residue_ids", residue_ids, false, binary_io);
+	}
+	else if(type=="residue-contacts")
+	{
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > inter_residue_contacts=
+				auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >(std::cin, "inter-residue contacts", "residue_contacts", true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "residue_contacts", inter_residue_contacts, true, binary_io);
+	}
+	else if(type=="combined-residue-contacts")
+	{
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combined_inter_residue_contacts=
+				auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas >(std::cin, "combined inter-residue contacts", "combined_residue_contacts", true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "combined_residue_contacts", combined_inter_residue_contacts, true, binary_io);
+	}
+	else if(type=="cad-profile")
+	{
+		const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore> profile=
+				auxiliaries::STDContainersBinaryIO::read_map_in_any_format<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore>(std::cin, "CAD profile", "cad_profile", true);
+		auxiliaries::STDContainersBinaryIO::print_map_in_chosen_format(std::cout, "cad_profile", profile, true, binary_io);
+	}
+	else
+	{
+		throw std::runtime_error("Invalid data type, expected one of: atoms, inter-atom-contacts, residue-ids, residue-contacts, combined-residue-contacts, cad-profile");
+	}
+}
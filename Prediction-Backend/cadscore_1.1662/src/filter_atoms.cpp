@@ -5,18 +5,47 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
+
+#include "shared_mode_functions.h"
+
+std::vector<protein::Atom> filter_atoms_by_target_atoms(const std::vector<protein::Atom>& atoms_of_model, const std::vector<protein::Atom>& atoms_of_target, const bool allow_unmatched_residue_names)
+{
+	std::vector<protein::Atom> result;
+	result.reserve(atoms_of_model.size());
+	const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_of_target=protein::collect_residue_ids_from_atoms(atoms_of_target);
+	for(std::size_t i=0;i<atoms_of_model.size();i++)
+	{
+		const protein::Atom& atom=atoms_of_model[i];
+		std::map<protein::ResidueID, protein::ResidueSummary>::const_iterator it=residue_ids_of_target.find(protein::ResidueID::from_atom(atom));
+		if(it!=residue_ids_of_target.end())
+		{
+			if(atom.residue_name==it->second.name || allow_unmatched_residue_names)
+			{
+				result.push_back(atom);
+			}
+			else
+			{
+				std::ostringstream output;
+				output << "Model atom chain name and residue number matched the target, but model atom residue name did not: " << atom.string_for_human_reading();
+				throw std::runtime_error(output.str());
+			}
+		}
+	}
+	return result;
+}
 
 void filter_atoms_by_target(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("--detailed --print-rejected --allow-unmatched-residue-names");
+	clo.check_allowed_options("--detailed --print-rejected --allow-unmatched-residue-names --binary-io");
 
 	const bool detailed=clo.isopt("--detailed");
 	const bool print_rejected=clo.isopt("--print-rejected");
 	const bool allow_unmatched_residue_names=clo.isopt("--allow-unmatched-residue-names");
 
-	const std::vector<protein::Atom> atoms_of_model=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "model atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms_of_model=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "model atoms", "atoms", false);
 
-	const std::vector<protein::Atom> atoms_of_target=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "target atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms_of_target=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "target atoms", "atoms", false);
 
 	std::vector<protein::Atom> result;
 	result.reserve(atoms_of_model.size());
@@ -75,25 +104,7 @@ void filter_atoms_by_target(const auxiliaries::CommandLineOptions& clo)
 	}
 	else
 	{
-		const std::map<protein::ResidueID, protein::ResidueSummary> residue_ids_of_target=protein::collect_residue_ids_from_atoms(atoms_of_target);
-		for(std::size_t i=0;i<atoms_of_model.size();i++)
-		{
-			const protein::Atom& atom=atoms_of_model[i];
-			std::map<protein::ResidueID, protein::ResidueSummary>::const_iterator it=residue_ids_of_target.find(protein::ResidueID::from_atom(atom));
-			if(it!=residue_ids_of_target.end())
-			{
-				if(atom.residue_name==it->second.name || allow_unmatched_residue_names)
-				{
-					result.push_back(atom);
-				}
-				else
-				{
-					std::ostringstream output;
-					output << "Model atom chain name and residue number matched the target, but model atom residue name did not: " << atom.string_for_human_reading();
-					throw std::runtime_error(output.str());
-				}
-			}
-		}
+		result=filter_atoms_by_target_atoms(atoms_of_model, atoms_of_target, allow_unmatched_residue_names);
 	}
 
 	if(result.empty())
@@ -102,7 +113,7 @@ void filter_atoms_by_target(const auxiliaries::CommandLineOptions& clo)
 	}
 	else
 	{
-		auxiliaries::STDContainersIO::print_vector(std::cout, "atoms", result);
+		auxiliaries::STDContainersBinaryIO::print_vector_in_chosen_format(std::cout, "atoms", result, clo.isopt("--binary-io"));
 	}
 }
 
@@ -112,7 +123,7 @@ void filter_atoms_by_name(const auxiliaries::CommandLineOptions& clo)
 
 	const std::string name=clo.arg<std::string>("--name");
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
 	std::vector<protein::Atom> result;
 	result.reserve(atoms.size());
@@ -8,13 +8,17 @@
 
 #include "resources/version.h"
 
+void benchmark(const auxiliaries::CommandLineOptions& clo);
 void calc_combined_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo);
+void calc_contact_area_difference_batch(const auxiliaries::CommandLineOptions& clo);
+void calc_contact_area_difference_end_to_end(const auxiliaries::CommandLineOptions& clo);
 void calc_contact_area_difference_global_scores(const auxiliaries::CommandLineOptions& clo);
 void calc_contact_area_difference_local_scores(const auxiliaries::CommandLineOptions& clo);
 void calc_contact_area_difference_profile(const auxiliaries::CommandLineOptions& clo);
 void calc_contact_area_difference_size_scores(const auxiliaries::CommandLineOptions& clo);
 void calc_inter_atom_contact_area_difference_score(const auxiliaries::CommandLineOptions& clo);
 void calc_inter_atom_contacts(const auxiliaries::CommandLineOptions& clo);
+void calc_inter_atom_contacts_series(const auxiliaries::CommandLineOptions& clo);
 void calc_inter_atom_faces(const auxiliaries::CommandLineOptions& clo);
 void calc_inter_residue_contacts(const auxiliaries::CommandLineOptions& clo);
 void calc_quadruples(const auxiliaries::CommandLineOptions& clo);
@@ -23,6 +27,7 @@ void check_for_any_inter_chain_contact(const auxiliaries::CommandLineOptions& cl
 void check_for_inter_atom_clashes(const auxiliaries::CommandLineOptions& clo);
 void collect_atoms(const auxiliaries::CommandLineOptions& clo);
 void collect_residue_ids(const auxiliaries::CommandLineOptions& clo);
+void convert_data_format(const auxiliaries::CommandLineOptions& clo);
 void filter_atoms_by_name(const auxiliaries::CommandLineOptions& clo);
 void filter_atoms_by_target(const auxiliaries::CommandLineOptions& clo);
 void merge_atoms(const auxiliaries::CommandLineOptions& clo);
@@ -71,6 +76,9 @@ int main(const int argc, const char** argv)
 		typedef std::pointer_to_unary_function<const auxiliaries::CommandLineOptions&, void> ModeFunctionPointer;
 		std::map< std::string, ModeFunctionPointer > modes_map;
 
+		modes_map["benchmark"]=ModeFunctionPointer(benchmark);
+		modes_map["calc-CAD-batch"]=ModeFunctionPointer(calc_contact_area_difference_batch);
+		modes_map["calc-CAD-end-to-end"]=ModeFunctionPointer(calc_contact_area_difference_end_to_end);
 		modes_map["calc-CAD-global-scores"]=ModeFunctionPointer(calc_contact_area_difference_global_scores);
 		modes_map["calc-CAD-local-scores"]=ModeFunctionPointer(calc_contact_area_difference_local_scores);
 		modes_map["calc-CAD-profile"]=ModeFunctionPointer(calc_contact_area_difference_profile);
@@ -78,6 +86,7 @@ int main(const int argc, const char** argv)
 		modes_map["calc-combined-inter-residue-contacts"]=ModeFunctionPointer(calc_combined_inter_residue_contacts);
 		modes_map["calc-inter-atom-CAD-score"]=ModeFunctionPointer(calc_inter_atom_contact_area_difference_score);
 		modes_map["calc-inter-atom-contacts"]=ModeFunctionPointer(calc_inter_atom_contacts);
+		modes_map["calc-inter-atom-contacts-series"]=ModeFunctionPointer(calc_inter_atom_contacts_series);
 		modes_map["calc-inter-atom-faces"]=ModeFunctionPointer(calc_inter_atom_faces);
 		modes_map["calc-inter-residue-contacts"]=ModeFunctionPointer(calc_inter_residue_contacts);
 		modes_map["calc-quadruples"]=ModeFunctionPointer(calc_quadruples);
@@ -86,6 +95,7 @@ int main(const int argc, const char** argv)
 		modes_map["check-for-inter-atom-clashes"]=ModeFunctionPointer(check_for_inter_atom_clashes);
 		modes_map["collect-atoms"]=ModeFunctionPointer(collect_atoms);
 		modes_map["collect-residue-ids"]=ModeFunctionPointer(collect_residue_ids);
+		modes_map["convert-data-format"]=ModeFunctionPointer(convert_data_format);
 		modes_map["filter-atoms-by-name"]=ModeFunctionPointer(filter_atoms_by_name);
 		modes_map["filter-atoms-by-target"]=ModeFunctionPointer(filter_atoms_by_target);
 		modes_map["merge-atoms"]=ModeFunctionPointer(merge_atoms);
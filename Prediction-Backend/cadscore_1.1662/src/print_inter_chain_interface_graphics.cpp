@@ -18,7 +18,9 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 #include "auxiliaries/color.h"
+#include "auxiliaries/triangulation_disk_cache.h"
 
 namespace
 {
@@ -620,7 +622,7 @@ void print_inter_chain_interface_graphics(const auxiliaries::CommandLineOptions&
 {
 	typedef apollota::InterSphereContactFaceOnHyperboloid CellFace;
 
-	clo.check_allowed_options("--probe: --step: --projections: --face-coloring: --selection-coloring: --groups: --output-names-prefix: --outline --insides --specific-contact-type: --transparent-magenta --binary-coloring");
+	clo.check_allowed_options("--probe: --step: --projections: --face-coloring: --selection-coloring: --groups: --output-names-prefix: --outline --insides --specific-contact-type: --transparent-magenta --binary-coloring --threads: --cache-dir: --cache-size:");
 
 	const double probe_radius=clo.isopt("--probe") ? clo.arg_with_min_value<double>("--probe", 0) : 1.4;
 	const double step_length=clo.isopt("--step") ? clo.arg_with_min_value<double>("--step", 0.1) : 0.5;
@@ -634,10 +636,12 @@ void print_inter_chain_interface_graphics(const auxiliaries::CommandLineOptions&
 	const std::string specific_contact_type=clo.isopt("--specific-contact-type") ? clo.arg<std::string>("--specific-contact-type") : std::string("");
 	const bool tansparent_magenta=clo.isopt("--transparent-magenta");
 	const bool binary_coloring=clo.isopt("--binary-coloring");
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
+	const auxiliaries::DiskCache cache=auxiliaries::TriangulationDiskCache::create_disk_cache(clo);
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
-	const apollota::UtilitiesForTriangulation::PairsNeighborsMap pairs_neighbours_map=apollota::UtilitiesForTriangulation::collect_pairs_neighbors_map_from_quadruples_map(apollota::Triangulation::construct_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, false, false).quadruples_map);
+	const apollota::CompressedPairsNeighbors pairs_neighbours=apollota::UtilitiesForTriangulation::collect_pairs_neighbors_from_quadruples_map(auxiliaries::TriangulationDiskCache::construct_triangulation_result(apollota::UtilitiesForTriangulation::collect_simple_spheres(atoms), 3.5, false, false, number_of_threads, cache).quadruples_map, atoms.size(), number_of_threads);
 
 #ifdef FOR_OLDER_COMPILERS
 	typedef std::auto_ptr<ContactAccepterInterface> AutoPtrToContactAccepterInterface;
@@ -670,9 +674,9 @@ void print_inter_chain_interface_graphics(const auxiliaries::CommandLineOptions&
 	else if(groups_option=="inter_chain_region")
 	{
 		std::set<protein::ResidueID> region_residue_ids;
-		for(apollota::UtilitiesForTriangulation::PairsNeighborsMap::const_iterator it=pairs_neighbours_map.begin();it!=pairs_neighbours_map.end();++it)
+		for(std::size_t i=0;i<pairs_neighbours.pairs.size();i++)
 		{
-			const std::pair<std::size_t, std::size_t> atoms_ids_pair=std::make_pair(it->first.get(0), it->first.get(1));
+			const std::pair<std::size_t, std::size_t> atoms_ids_pair=std::make_pair(pairs_neighbours.pairs[i].get(0), pairs_neighbours.pairs[i].get(1));
 			const protein::Atom& a=atoms[atoms_ids_pair.first];
 			const protein::Atom& b=atoms[atoms_ids_pair.second];
 			if(a.chain_id!=b.chain_id && a.chain_id!="?" && b.chain_id!="?" &&
@@ -693,24 +697,26 @@ void print_inter_chain_interface_graphics(const auxiliaries::CommandLineOptions&
 	std::map< std::pair<std::size_t, std::size_t>, std::size_t > faces_vector_map;
 	typedef std::map< std::pair<std::string, std::string>, std::vector< std::pair<std::size_t, std::size_t> > > InterfacesMap;
 	InterfacesMap inter_chain_interfaces;
+	CellFace::ConstructionBuffers face_construction_buffers;
 
-	for(apollota::UtilitiesForTriangulation::PairsNeighborsMap::const_iterator it=pairs_neighbours_map.begin();it!=pairs_neighbours_map.end();++it)
+	for(std::size_t i=0;i<pairs_neighbours.pairs.size();i++)
 	{
-		const std::pair<std::size_t, std::size_t> atoms_ids_pair=std::make_pair(it->first.get(0), it->first.get(1));
+		const std::pair<std::size_t, std::size_t> atoms_ids_pair=std::make_pair(pairs_neighbours.pairs[i].get(0), pairs_neighbours.pairs[i].get(1));
 
 		const protein::Atom& a=atoms[atoms_ids_pair.first];
 		const protein::Atom& b=atoms[atoms_ids_pair.second];
 
 		if(contact_accepter->accept(a,b))
 		{
+			const apollota::NeighborsRange c_ids=pairs_neighbours.pairs_neighbors.neighbors(i);
 			std::vector<const protein::Atom*> cs;
-			cs.reserve(it->second.size());
-			for(apollota::UtilitiesForTriangulation::PairsNeighborsMap::mapped_type::const_iterator jt=it->second.begin();jt!=it->second.end();++jt)
+			cs.reserve(c_ids.size());
+			for(apollota::NeighborsRange::const_iterator jt=c_ids.begin();jt!=c_ids.end();++jt)
 			{
 				cs.push_back(&(atoms[*jt]));
 			}
 
-			const CellFace cell_face=CellFace::construct(a, b, cs, probe_radius, step_length, projections_count);
+			const CellFace cell_face=CellFace::construct(a, b, cs, probe_radius, step_length, projections_count, face_construction_buffers);
 			if(!cell_face.mesh_vertices().empty())
 			{
 				const std::pair<std::size_t, std::size_t> reversed_atoms_ids_pair=std::make_pair(atoms_ids_pair.second, atoms_ids_pair.first);
@@ -750,7 +756,7 @@ void print_inter_chain_interface_graphics(const auxiliaries::CommandLineOptions&
 	else if(face_coloring_mode=="inter_residue_contact_scores")
 	{
 		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combined_inter_residue_contacts=
-				auxiliaries::STDContainersIO::read_map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas >(std::cin, "combined inter-residue contacts", "combined_residue_contacts", true);
+				auxiliaries::STDContainersBinaryIO::read_map_in_any_format< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas >(std::cin, "combined inter-residue contacts", "combined_residue_contacts", true);
 		face_colorizer.reset(new ContactColorizerByInterResidueContactScore(combined_inter_residue_contacts, specific_contact_type, binary_coloring));
 	}
 	else if(face_coloring_mode=="residue_id")
@@ -6,6 +6,7 @@
 #include <sstream>
 
 #include "basic_parsing.h"
+#include "chain_name.h"
 
 namespace protein
 {
@@ -15,7 +16,7 @@ struct Atom
 	enum MoleculeClass {unidentified_molecule_class, amino_acid, nucleotide};
 	enum LocationClass {unidentified_location_class, main_chain, side_chain};
 
-	std::string chain_id;
+	ChainName chain_id;
 	int atom_number;
 	int residue_number;
 	std::string residue_name;
@@ -88,6 +89,38 @@ struct Atom
 		return input;
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_string(chain_id);
+		writer.write_int(atom_number);
+		writer.write_int(residue_number);
+		writer.write_string(residue_name);
+		writer.write_string(atom_name);
+		writer.write_double(x);
+		writer.write_double(y);
+		writer.write_double(z);
+		writer.write_double(r);
+		writer.write_int(molecule_class);
+		writer.write_int(location_class);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		chain_id=reader.read_string();
+		atom_number=reader.read_int();
+		residue_number=reader.read_int();
+		residue_name=reader.read_string();
+		atom_name=reader.read_string();
+		x=reader.read_double();
+		y=reader.read_double();
+		z=reader.read_double();
+		r=reader.read_double();
+		molecule_class=reader.read_int();
+		location_class=reader.read_int();
+	}
+
 	std::string string_for_human_reading() const
 	{
 		std::ostringstream output;
@@ -110,7 +143,7 @@ struct Atom
 		basic_parsing::insert_string_to_columned_file_line(basic_parsing::convert_int_to_string(atom_number), 7, 11, true, line);
 		basic_parsing::insert_string_to_columned_file_line(atom_name, (atom_name.size()>3 ? 13 : 14), 16, false, line);
 		basic_parsing::insert_string_to_columned_file_line(residue_name, 18, 20, false, line);
-		basic_parsing::insert_string_to_columned_file_line((chain_id=="?" ? std::string(" ") : chain_id), 22, 22, false, line);
+		basic_parsing::insert_string_to_columned_file_line((chain_id=="?" ? std::string(" ") : chain_id.str()), 22, 22, false, line);
 		basic_parsing::insert_string_to_columned_file_line(basic_parsing::convert_int_to_string(residue_number), 23, 26, true, line);
 		basic_parsing::insert_string_to_columned_file_line(basic_parsing::convert_double_to_string(x, 3), 31, 38, true, line);
 		basic_parsing::insert_string_to_columned_file_line(basic_parsing::convert_double_to_string(y, 3), 39, 46, true, line);
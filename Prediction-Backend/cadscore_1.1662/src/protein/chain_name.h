@@ -0,0 +1,109 @@
+#ifndef PROTEIN_CHAIN_NAME_H_
+#define PROTEIN_CHAIN_NAME_H_
+
+#include <string>
+#include <set>
+#include <iostream>
+
+namespace protein
+{
+
+/*
+ * Chain name that refers to a single process-wide copy of its string.
+ * Copying and checking equality only deal with a pointer,
+ * ordering compares the strings only for different names, so it is the same as for plain strings.
+ */
+class ChainName
+{
+public:
+	ChainName() : name_(&empty_name())
+	{
+	}
+
+	ChainName(const std::string& name) : name_(intern(name))
+	{
+	}
+
+	ChainName(const char* name) : name_(intern(std::string(name)))
+	{
+	}
+
+	const std::string& str() const
+	{
+		return (*name_);
+	}
+
+	operator const std::string&() const
+	{
+		return (*name_);
+	}
+
+	bool empty() const
+	{
+		return name_->empty();
+	}
+
+	const char* c_str() const
+	{
+		return name_->c_str();
+	}
+
+	friend bool operator==(const ChainName& a, const ChainName& b)
+	{
+		return (a.name_==b.name_);
+	}
+
+	friend bool operator!=(const ChainName& a, const ChainName& b)
+	{
+		return (a.name_!=b.name_);
+	}
+
+	friend bool operator<(const ChainName& a, const ChainName& b)
+	{
+		return (a.name_!=b.name_ && (*a.name_)<(*b.name_));
+	}
+
+	friend std::ostream& operator<<(std::ostream& output, const ChainName& chain_name)
+	{
+		output << chain_name.str();
+		return output;
+	}
+
+	friend std::istream& operator>>(std::istream& input, ChainName& chain_name)
+	{
+		std::string name;
+		input >> name;
+		chain_name=ChainName(name);
+		return input;
+	}
+
+private:
+	static const std::string& empty_name()
+	{
+		static const std::string name;
+		return name;
+	}
+
+	static const std::string* intern(const std::string& name)
+	{
+		if(name.empty())
+		{
+			return (&empty_name());
+		}
+		static std::set<std::string> names;
+		const std::string* result=0;
+#ifdef _OPENMP
+		#pragma omp critical(protein_chain_names_interning)
+#endif
+		{
+			result=&(*names.insert(name).first);
+		}
+		return result;
+	}
+
+	const std::string* name_;
+};
+
+}
+
+#endif /* PROTEIN_CHAIN_NAME_H_ */
@@ -4,19 +4,21 @@
 #include <string>
 #include <iostream>
 
+#include "chain_name.h"
+
 namespace protein
 {
 
 struct ResidueID
 {
-	std::string chain_id;
+	ChainName chain_id;
 	int residue_number;
 
 	ResidueID() : residue_number(0)
 	{
 	}
 
-	ResidueID(const std::string& chain_id, int residue_number) : chain_id(chain_id), residue_number(residue_number)
+	ResidueID(const ChainName& chain_id, int residue_number) : chain_id(chain_id), residue_number(residue_number)
 	{
 	}
 
@@ -41,6 +43,20 @@ struct ResidueID
 		return (chain_id<rid.chain_id || (chain_id==rid.chain_id && residue_number<rid.residue_number));
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_string(chain_id);
+		writer.write_int(residue_number);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		chain_id=reader.read_string();
+		residue_number=reader.read_int();
+	}
+
 	friend std::ostream& operator<<(std::ostream &output, const ResidueID &rid)
 	{
 		output << rid.chain_id << " ";
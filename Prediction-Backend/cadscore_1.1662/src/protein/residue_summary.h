@@ -20,6 +20,20 @@ struct ResidueSummary
 	{
 	}
 
+	template<typename Writer>
+	void write_binary(Writer& writer) const
+	{
+		writer.write_string(name);
+		writer.write_int(atoms_count);
+	}
+
+	template<typename Reader>
+	void read_binary(Reader& reader)
+	{
+		name=reader.read_string();
+		atoms_count=reader.read_int();
+	}
+
 	friend std::ostream& operator<<(std::ostream &output, const ResidueSummary &rs)
 	{
 		output << rs.name << " ";
@@ -111,42 +111,49 @@ public:
 		}
 	};
 
+	// Only two rows of scores are kept, and for every cell one byte is stored: the direction and, for the local traceback, whether the score is positive
 	template<typename T, typename Scorer>
 	static std::vector< std::pair<int, int> > construct_sequence_alignment(const T& seq1, const T& seq2, const Scorer& scorer, const bool local=false, int* result_score=0)
 	{
 		std::vector< std::pair<int, int> > alignment;
 		if(!seq1.empty() && !seq2.empty())
 		{
-			std::vector< std::vector<int> > scores_matrix(seq1.size()+1, std::vector<int>(seq2.size()+1, 0));
-			std::vector< std::vector<int> > directions_matrix(seq1.size()+1, std::vector<int>(seq2.size()+1, 0));
-			for(std::size_t i=1;i<=seq1.size();i++)
-			{
-				scores_matrix[i][0]=((i==1) ? scorer.gap_start() : (scores_matrix[i-1][0]+scorer.gap_extension()));
-				directions_matrix[i][0]=1;
-			}
+			const std::size_t width=seq2.size()+1;
+			const int gap_start=scorer.gap_start();
+			const int gap_extension=scorer.gap_extension();
+			std::vector<unsigned char> directions_matrix((seq1.size()+1)*width, 0);
+			std::vector<int> previous_scores(width, 0);
+			std::vector<int> current_scores(width, 0);
 			for(std::size_t j=1;j<=seq2.size();j++)
 			{
-				scores_matrix[0][j]=((j==1) ? scorer.gap_start() : (scores_matrix[0][j-1]+scorer.gap_extension()));
-				directions_matrix[0][j]=2;
+				previous_scores[j]=((j==1) ? gap_start : (previous_scores[j-1]+gap_extension));
+				directions_matrix[j]=2;
 			}
 			std::pair<std::size_t, std::size_t> result_score_pos(0, 0);
+			int best_local_score=0;
 			for(std::size_t i=1;i<=seq1.size();i++)
 			{
+				const unsigned char* previous_directions=&directions_matrix[(i-1)*width];
+				unsigned char* directions=&directions_matrix[i*width];
+				current_scores[0]=((i==1) ? gap_start : (previous_scores[0]+gap_extension));
+				directions[0]=1;
+				const typename T::value_type& v1=seq1[i-1];
 				for(std::size_t j=1;j<=seq2.size();j++)
 				{
-					const typename T::value_type& v1=seq1[i-1];
-					const typename T::value_type& v2=seq2[j-1];
-					const int match_score=scores_matrix[i-1][j-1]+scorer.match(v1, v2);
-					const int deletion_score=scores_matrix[i-1][j]+(directions_matrix[i-1][j]!=1 ? scorer.gap_start() : scorer.gap_extension());
-					const int insertion_score=scores_matrix[i][j-1]+(directions_matrix[i][j-1]!=2 ? scorer.gap_start() : scorer.gap_extension());
+					const int match_score=previous_scores[j-1]+scorer.match(v1, seq2[j-1]);
+					const int deletion_score=previous_scores[j]+((previous_directions[j]&3)!=1 ? gap_start : gap_extension);
+					const int insertion_score=current_scores[j-1]+((directions[j-1]&3)!=2 ? gap_start : gap_extension);
 					const int max_score=std::max(match_score, std::max(deletion_score, insertion_score));
-					directions_matrix[i][j]=(max_score==insertion_score ? 2 : (max_score==deletion_score ? 1 : 0));
-					scores_matrix[i][j]=(local ? std::max(0, max_score) : max_score);
-					if(local && scores_matrix[i][j]>scores_matrix[result_score_pos.first][result_score_pos.second])
+					const int score=(local ? std::max(0, max_score) : max_score);
+					current_scores[j]=score;
+					directions[j]=static_cast<unsigned char>((max_score==insertion_score ? 2 : (max_score==deletion_score ? 1 : 0)) | (score>0 ? 4 : 0));
+					if(local && score>best_local_score)
 					{
+						best_local_score=score;
 						result_score_pos=std::make_pair(i, j);
 					}
 				}
+				previous_scores.swap(current_scores);
 			}
 			if(!local)
 			{
@@ -155,7 +162,7 @@ public:
 			}
 			if(result_score!=0)
 			{
-				*result_score=scores_matrix[result_score_pos.first][result_score_pos.second];
+				*result_score=(local ? best_local_score : previous_scores[seq2.size()]);
 			}
 
 			int i=static_cast<int>(seq1.size());
@@ -170,9 +177,9 @@ public:
 				j--;
 				alignment.push_back(std::make_pair(-1, j));
 			}
-			while(i>0 && j>0 && (!local || scores_matrix[i][j]>0))
+			while(i>0 && j>0 && (!local || (directions_matrix[i*width+j]&4)!=0))
 			{
-				const int dir=directions_matrix[i][j];
+				const int dir=(directions_matrix[i*width+j]&3);
 				if(dir==0)
 				{
 					i--;
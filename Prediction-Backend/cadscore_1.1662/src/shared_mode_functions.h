@@ -0,0 +1,63 @@
+#ifndef SHARED_MODE_FUNCTIONS_H_
+#define SHARED_MODE_FUNCTIONS_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+#include "protein/atom.h"
+#include "protein/residue_id.h"
+#include "protein/residue_summary.h"
+#include "protein/van_der_waals_radius_assigner.h"
+
+#include "contacto/contact_id.h"
+#include "contacto/inter_atom_contact.h"
+#include "contacto/inter_residue_contact_areas.h"
+#include "contacto/inter_residue_contact_dual_areas.h"
+#include "contacto/residue_contact_area_difference_score.h"
+
+#include "auxiliaries/command_line_options.h"
+
+/*
+ * Functions that are defined in the modes source files and are also used by other modes.
+ */
+
+protein::VanDerWaalsRadiusAssigner construct_radius_assigner(const std::string& radius_classes_file_name, const std::string& radius_members_file_name);
+
+std::vector<protein::Atom> collect_atoms_from_PDB_file_stream(
+		std::istream& pdb_file_stream,
+		const protein::VanDerWaalsRadiusAssigner& radius_assigner,
+		const bool include_heteroatoms,
+		const bool include_water,
+		const bool include_insertions,
+		const std::string& simple_chain_renaming,
+		const bool auto_rename_chains);
+
+std::vector<protein::Atom> filter_atoms_by_target_atoms(const std::vector<protein::Atom>& atoms_of_model, const std::vector<protein::Atom>& atoms_of_target, const bool allow_unmatched_residue_names);
+
+std::string read_engine_option(const auxiliaries::CommandLineOptions& clo);
+
+std::size_t read_depth_option(const auxiliaries::CommandLineOptions& clo, const std::string& engine);
+
+std::vector<contacto::InterAtomContact> construct_inter_atom_contacts(const std::vector<protein::Atom>& atoms, const std::string& engine, const std::size_t subdivision_depth, const double probe_radius, const std::size_t number_of_threads, const bool spatial_ordering, std::ostream& log_output);
+
+std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas > construct_filtered_inter_residue_contacts(const std::vector<protein::Atom>& atoms, const std::vector<contacto::InterAtomContact>& inter_atom_contacts, const bool core, const bool interface_zone, const bool inter_chain, const std::string& inter_interval, const bool preserve_reflexive);
+
+std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactDualAreas > combine_inter_residue_contacts_with_optimal_chains_renaming(
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts_1,
+		const std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts_2,
+		const std::map<protein::ResidueID, protein::ResidueSummary>& residue_ids_1,
+		const bool binarize,
+		std::string& renaming_comment,
+		std::ostream& log_output);
+
+void add_inter_nucleotide_side_chain_contact_categories(const std::vector<protein::Atom>& atoms, const bool use_atom_centers, std::map< contacto::ContactID<protein::ResidueID>, contacto::InterResidueContactAreas >& inter_residue_contacts);
+
+void print_contact_area_difference_local_scores(const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore>& profile, const std::string& category, const int window_size, const bool absolute, std::ostream& output);
+
+void print_contact_area_difference_global_scores(const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore>& profile, const std::vector<std::string>& categories, const bool use_min, std::ostream& output);
+
+void print_contact_area_difference_size_scores(const std::map<protein::ResidueID, contacto::ResidueContactAreaDifferenceScore>& profile, const std::map<protein::ResidueID, protein::ResidueSummary>& residue_ids_of_target, const std::map<protein::ResidueID, protein::ResidueSummary>& residue_ids_of_model, std::ostream& output);
+
+#endif /* SHARED_MODE_FUNCTIONS_H_ */
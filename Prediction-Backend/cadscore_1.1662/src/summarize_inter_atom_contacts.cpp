@@ -9,14 +9,15 @@
 
 #include "auxiliaries/command_line_options.h"
 #include "auxiliaries/std_containers_io.h"
+#include "auxiliaries/std_containers_binary_io.h"
 
 void summarize_inter_atom_contacts(const auxiliaries::CommandLineOptions& clo)
 {
 	clo.check_allowed_options("");
 
-	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersIO::read_vector<protein::Atom>(std::cin, "atoms", "atoms", false);
+	const std::vector<protein::Atom> atoms=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<protein::Atom>(std::cin, "atoms", "atoms", false);
 
-	const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersIO::read_vector<contacto::InterAtomContact>(std::cin, "inter atom contacts", "contacts", false);
+	const std::vector<contacto::InterAtomContact> inter_atom_contacts=auxiliaries::STDContainersBinaryIO::read_vector_in_any_format<contacto::InterAtomContact>(std::cin, "inter atom contacts", "contacts", false);
 
 	std::map<std::string, double> values;
 	for(std::size_t i=0;i<inter_atom_contacts.size();i++)
@@ -34,7 +35,7 @@ void summarize_inter_atom_contacts(const auxiliaries::CommandLineOptions& clo)
 				values[std::string("all_")+contact_class]+=contact.area;
 				if(a.chain_id!=b.chain_id)
 				{
-					values[std::string("inter_chain_")+a.chain_id+"_"+b.chain_id+"_"+contact_class]+=contact.area;
+					values[std::string("inter_chain_")+a.chain_id.str()+"_"+b.chain_id.str()+"_"+contact_class]+=contact.area;
 				}
 			}
 		}
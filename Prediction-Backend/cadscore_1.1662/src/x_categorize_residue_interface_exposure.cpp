@@ -27,7 +27,7 @@ void x_categorize_residue_interface_exposure(const auxiliaries::CommandLineOptio
 				const double area=jt->second;
 				const contacto::ContactID<protein::ResidueID> self_contact_id(a_id, a_id);
 				extended_inter_residue_contacts[self_contact_id].areas[name+"_exposed"]+=area;
-				extended_inter_residue_contacts[self_contact_id].areas[name+"_exposed_to_"+b_id.chain_id]+=area;
+				extended_inter_residue_contacts[self_contact_id].areas[name+"_exposed_to_"+b_id.chain_id.str()]+=area;
 			}
 		}
 	}
@@ -29,13 +29,6 @@ struct Overlay
 	{
 	}
 
-	static Overlay combine_overlays(const Overlay& a, const Overlay& b)
-	{
-		Overlay ab=a;
-		ab.score+=b.score;
-		ab.model_to_target.insert(b.model_to_target.begin(), b.model_to_target.end());
-		return ab;
-	}
 };
 
 ResidueVector collect_residues(const std::vector<protein::Atom>& atoms)
@@ -74,78 +67,279 @@ std::string collect_sequence_from_residues(const ResidueVector& residues)
 	return output.str();
 }
 
-Overlay produce_overlay(const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer, const ResidueVector& target_residues, const ResidueVector& model_residues, std::vector<ResidueVector>& leftovers)
+// Contiguous range of residues of a model chain
+struct Fragment
+{
+	std::size_t chain;
+	std::size_t begin;
+	std::size_t end;
+
+	Fragment(const std::size_t chain, const std::size_t begin, const std::size_t end) : chain(chain), begin(begin), end(end)
+	{
+	}
+
+	std::size_t size() const
+	{
+		return (end-begin);
+	}
+
+	bool operator<(const Fragment& f) const
+	{
+		return (chain<f.chain || (chain==f.chain && (begin<f.begin || (begin==f.begin && end<f.end))));
+	}
+};
+
+struct FragmentOverlay
+{
+	int score;
+	std::vector< std::pair<std::size_t, std::size_t> > model_to_target;
+	std::vector<Fragment> leftovers;
+
+	FragmentOverlay() : score(0)
+	{
+	}
+};
+
+FragmentOverlay produce_overlay(const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer, const std::string& target_sequence, const std::string& model_chain_sequence, const Fragment& fragment)
 {
-	const std::string target_sequence=collect_sequence_from_residues(target_residues);
-	const std::string model_sequence=collect_sequence_from_residues(model_residues);
-	Overlay overlay;
+	const std::string model_sequence=model_chain_sequence.substr(fragment.begin, fragment.size());
+	FragmentOverlay overlay;
 	const std::vector< std::pair<int, int> > alignment=protein::sequence_tools::PairwiseSequenceAlignment::construct_sequence_alignment(target_sequence, model_sequence, scorer, true, &overlay.score);
-	leftovers.clear();
 	for(std::size_t i=0;i<alignment.size();i++)
 	{
 		const std::pair<int, int>& pairing=alignment[i];
+		const std::size_t model_position=fragment.begin+static_cast<std::size_t>(pairing.second);
 		if(pairing.first>=0 && pairing.second>=0)
 		{
-			overlay.model_to_target[model_residues[pairing.second].id]=target_residues[pairing.first].id;
+			overlay.model_to_target.push_back(std::make_pair(model_position, static_cast<std::size_t>(pairing.first)));
 		}
 		if(pairing.first<0 && pairing.second>=0)
 		{
-			if(leftovers.empty() || (i>0 && alignment[i-1].first>=0))
+			if(overlay.leftovers.empty() || (i>0 && alignment[i-1].first>=0))
 			{
-				leftovers.push_back(ResidueVector());
+				overlay.leftovers.push_back(Fragment(fragment.chain, model_position, model_position));
 			}
-			leftovers.back().push_back(model_residues[pairing.second]);
+			overlay.leftovers.back().end=model_position+1;
 		}
 	}
 	return overlay;
 }
 
-void recursive_calculate_best_combined_overlay(
+// Depth-first search of the best assignment of model chain fragments to target chains.
+// For every target chain in turn, every fragment is tried (and then no fragment),
+// and the unaligned parts of the used fragment become new fragments.
+// Overlays are computed once for every pair of target chain and fragment,
+// and branches are cut when even ideal overlays of the remaining target chains could not beat the best score.
+class CombinedOverlaySearch
+{
+public:
+	typedef std::pair<std::size_t, Fragment> Choice;
+
+	struct Result
+	{
+		int score;
+		std::vector<Choice> choices;
+
+		Result() : score(0)
+		{
+		}
+	};
+
+	CombinedOverlaySearch(
+			const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer,
+			const std::vector<std::string>& target_sequences,
+			const std::vector<std::string>& model_sequences,
+			const std::vector< std::vector<FragmentOverlay> >& chains_overlays) :
+				scorer_(scorer),
+				target_sequences_(target_sequences),
+				model_sequences_(model_sequences),
+				chains_overlays_(chains_overlays),
+				max_remaining_target_scores_(target_sequences.size()+1, 0)
+	{
+		const int max_pair_score=std::max(0, std::max(scorer.match_score, scorer.mismatch_score));
+		pruning_enabled_=(scorer.gap_start_score<=0 && scorer.gap_extension_score<=0);
+		for(std::size_t i=target_sequences.size();i>0;i--)
+		{
+			max_remaining_target_scores_[i-1]=max_remaining_target_scores_[i]+max_pair_score*static_cast<int>(target_sequences[i-1].size());
+		}
+		max_pair_score_=max_pair_score;
+	}
+
+	const FragmentOverlay& get_overlay(const std::size_t i, const Fragment& fragment)
+	{
+		if(fragment.begin==0 && fragment.end==model_sequences_[fragment.chain].size())
+		{
+			return chains_overlays_[i][fragment.chain];
+		}
+		const Choice key(i, fragment);
+		std::map<Choice, FragmentOverlay>::const_iterator it=overlays_cache_.find(key);
+		if(it==overlays_cache_.end())
+		{
+			it=overlays_cache_.insert(std::make_pair(key, produce_overlay(scorer_, target_sequences_[i], model_sequences_[fragment.chain], fragment))).first;
+		}
+		return it->second;
+	}
+
+	static std::vector<Fragment> replace_fragment(const std::vector<Fragment>& fragments, const std::size_t j, const std::vector<Fragment>& leftovers)
+	{
+		std::vector<Fragment> new_fragments;
+		new_fragments.reserve(fragments.size()+leftovers.size());
+		new_fragments.insert(new_fragments.end(), fragments.begin(), fragments.begin()+j);
+		new_fragments.insert(new_fragments.end(), leftovers.begin(), leftovers.end());
+		new_fragments.insert(new_fragments.end(), fragments.begin()+j+1, fragments.end());
+		return new_fragments;
+	}
+
+	bool ideal_overlay(const std::size_t i, const Fragment& fragment, const FragmentOverlay& overlay) const
+	{
+		return (target_sequences_[i].size()==fragment.size() && overlay.score==(scorer_.match(1, 1)*static_cast<int>(target_sequences_[i].size())));
+	}
+
+	void search(const std::size_t i, const std::vector<Fragment>& fragments, const int score, std::vector<Choice>& choices, Result& best)
+	{
+		if(i>=target_sequences_.size() || fragments.empty())
+		{
+			if(score>best.score)
+			{
+				best.score=score;
+				best.choices=choices;
+			}
+			return;
+		}
+		if(pruning_enabled_)
+		{
+			std::size_t remaining_model_residues=0;
+			for(std::size_t j=0;j<fragments.size();j++)
+			{
+				remaining_model_residues+=fragments[j].size();
+			}
+			if(score+std::min(max_remaining_target_scores_[i], max_pair_score_*static_cast<int>(remaining_model_residues))<=best.score)
+			{
+				return;
+			}
+		}
+		bool ideal_produced_overlay=false;
+		for(std::size_t j=0;j<fragments.size() && !ideal_produced_overlay;j++)
+		{
+			const FragmentOverlay& overlay=get_overlay(i, fragments[j]);
+			ideal_produced_overlay=ideal_overlay(i, fragments[j], overlay);
+			choices.push_back(Choice(i, fragments[j]));
+			search(i+1, replace_fragment(fragments, j, overlay.leftovers), score+overlay.score, choices, best);
+			choices.pop_back();
+		}
+		search(i+1, fragments, score, choices, best);
+	}
+
+private:
+	const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer_;
+	const std::vector<std::string>& target_sequences_;
+	const std::vector<std::string>& model_sequences_;
+	const std::vector< std::vector<FragmentOverlay> >& chains_overlays_;
+	std::vector<int> max_remaining_target_scores_;
+	int max_pair_score_;
+	bool pruning_enabled_;
+	std::map<Choice, FragmentOverlay> overlays_cache_;
+};
+
+Overlay calculate_best_combined_overlay(
 		const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer,
 		const std::vector<ResidueVector>& target_divided_residues,
-		const std::size_t i,
 		const std::vector<ResidueVector>& model_divided_residues,
-		const Overlay& previous_overlay,
-		Overlay& currently_best_overlay)
+		const std::size_t number_of_threads)
 {
-	if(i>=target_divided_residues.size() || model_divided_residues.empty())
+	if(target_divided_residues.empty() || model_divided_residues.empty())
+	{
+		return Overlay();
+	}
+
+	std::vector<std::string> target_sequences(target_divided_residues.size());
+	for(std::size_t i=0;i<target_divided_residues.size();i++)
+	{
+		target_sequences[i]=collect_sequence_from_residues(target_divided_residues[i]);
+	}
+	std::vector<std::string> model_sequences(model_divided_residues.size());
+	std::vector<Fragment> model_fragments;
+	for(std::size_t j=0;j<model_divided_residues.size();j++)
+	{
+		model_sequences[j]=collect_sequence_from_residues(model_divided_residues[j]);
+		model_fragments.push_back(Fragment(j, 0, model_divided_residues[j].size()));
+	}
+
+	std::vector< std::vector<FragmentOverlay> > chains_overlays(target_sequences.size(), std::vector<FragmentOverlay>(model_sequences.size()));
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#else
+	static_cast<void>(number_of_threads);
+#endif
+	for(int p=0;p<static_cast<int>(target_sequences.size()*model_sequences.size());p++)
 	{
-		if(previous_overlay.score>currently_best_overlay.score)
+		const std::size_t i=static_cast<std::size_t>(p)/model_sequences.size();
+		const std::size_t j=static_cast<std::size_t>(p)%model_sequences.size();
+		chains_overlays[i][j]=produce_overlay(scorer, target_sequences[i], model_sequences[j], model_fragments[j]);
+	}
+
+	// The branches of the first target chain are searched independently, and then their results are taken in the search order
+	std::size_t branches_count=0;
+	{
+		CombinedOverlaySearch search(scorer, target_sequences, model_sequences, chains_overlays);
+		bool ideal_produced_overlay=false;
+		while(branches_count<model_fragments.size() && !ideal_produced_overlay)
 		{
-			currently_best_overlay=previous_overlay;
+			ideal_produced_overlay=search.ideal_overlay(0, model_fragments[branches_count], chains_overlays[0][branches_count]);
+			branches_count++;
 		}
 	}
-	else
+	std::vector<CombinedOverlaySearch::Result> branches_results(branches_count+1);
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(static_cast<int>(number_of_threads)) schedule(dynamic)
+#endif
+	for(int b=0;b<static_cast<int>(branches_results.size());b++)
 	{
-		bool ideal_produced_overlay=false;
-		for(std::size_t j=0;j<model_divided_residues.size() && !ideal_produced_overlay;j++)
+		CombinedOverlaySearch search(scorer, target_sequences, model_sequences, chains_overlays);
+		std::vector<CombinedOverlaySearch::Choice> choices;
+		if(b<static_cast<int>(branches_count))
 		{
-			std::vector<ResidueVector> leftovers;
-			const Overlay new_overlay=produce_overlay(scorer, target_divided_residues[i], model_divided_residues[j], leftovers);
-			ideal_produced_overlay=(target_divided_residues[i].size()==model_divided_residues[j].size() && new_overlay.score==(scorer.match(1, 1)*static_cast<int>(target_divided_residues[i].size())));
-			std::vector<ResidueVector> new_model_divided_residues;
-			for(std::size_t e=0;e<model_divided_residues.size();e++)
-			{
-				if(e!=j)
-				{
-					new_model_divided_residues.push_back(model_divided_residues[e]);
-				}
-				else if(!leftovers.empty())
-				{
-					new_model_divided_residues.insert(new_model_divided_residues.end(), leftovers.begin(), leftovers.end());
-				}
-			}
-			recursive_calculate_best_combined_overlay(scorer, target_divided_residues, i+1, new_model_divided_residues, Overlay::combine_overlays(previous_overlay, new_overlay), currently_best_overlay);
+			const std::size_t j=static_cast<std::size_t>(b);
+			const FragmentOverlay& overlay=chains_overlays[0][j];
+			choices.push_back(CombinedOverlaySearch::Choice(0, model_fragments[j]));
+			search.search(1, CombinedOverlaySearch::replace_fragment(model_fragments, j, overlay.leftovers), overlay.score, choices, branches_results[b]);
+		}
+		else
+		{
+			search.search(1, model_fragments, 0, choices, branches_results[b]);
+		}
+	}
+
+	CombinedOverlaySearch::Result best;
+	for(std::size_t b=0;b<branches_results.size();b++)
+	{
+		if(branches_results[b].score>best.score)
+		{
+			best=branches_results[b];
+		}
+	}
+
+	Overlay combined_overlay;
+	CombinedOverlaySearch search(scorer, target_sequences, model_sequences, chains_overlays);
+	for(std::size_t c=0;c<best.choices.size();c++)
+	{
+		const std::size_t i=best.choices[c].first;
+		const Fragment& fragment=best.choices[c].second;
+		const FragmentOverlay& overlay=search.get_overlay(i, fragment);
+		combined_overlay.score+=overlay.score;
+		for(std::size_t e=0;e<overlay.model_to_target.size();e++)
+		{
+			combined_overlay.model_to_target.insert(std::make_pair(model_divided_residues[fragment.chain][overlay.model_to_target[e].first].id, target_divided_residues[i][overlay.model_to_target[e].second].id));
 		}
-		recursive_calculate_best_combined_overlay(scorer, target_divided_residues, i+1, model_divided_residues, previous_overlay, currently_best_overlay);
 	}
+	return combined_overlay;
 }
 
 }
 
 void x_renumber_residues_by_reference(const auxiliaries::CommandLineOptions& clo)
 {
-	clo.check_allowed_options("--match: --mismatch: --gap-start: --gap-extension: --replace-residue-names --output-in-pdb-format --print-summary-log --print-detailed-log");
+	clo.check_allowed_options("--match: --mismatch: --gap-start: --gap-extension: --replace-residue-names --output-in-pdb-format --print-summary-log --print-detailed-log --threads:");
 
 	const int match_score=clo.arg_or_default_value<int>("--match", 10);
 	const int mismatch_score=clo.arg_or_default_value<int>("--mismatch", -10);
@@ -155,6 +349,7 @@ void x_renumber_residues_by_reference(const auxiliaries::CommandLineOptions& clo
 	const bool output_in_pdb_format=clo.isopt("--output-in-pdb-format");
 	const bool print_summary_log=clo.isopt("--print-summary-log");
 	const bool print_detailed_log=clo.isopt("--print-detailed-log");
+	const std::size_t number_of_threads=clo.isopt("--threads") ? clo.arg_with_min_value<std::size_t>("--threads", 1) : 1;
 
 	const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer scorer(match_score, mismatch_score, gap_start_score, gap_extension_score);
 
@@ -167,8 +362,7 @@ void x_renumber_residues_by_reference(const auxiliaries::CommandLineOptions& clo
 	const std::vector<ResidueVector> target_divided_residues=subdivide_residues_by_chain(target_residues);
 	const std::vector<ResidueVector> model_divided_residues=subdivide_residues_by_chain(model_residues);
 
-	Overlay best_combined_overlay;
-	recursive_calculate_best_combined_overlay(scorer, target_divided_residues, 0, model_divided_residues, Overlay(), best_combined_overlay);
+	const Overlay best_combined_overlay=calculate_best_combined_overlay(scorer, target_divided_residues, model_divided_residues, number_of_threads);
 
 	std::vector<protein::Atom> renumbered_model_atoms;
 	for(std::vector<protein::Atom>::const_iterator it=model_atoms.begin();it!=model_atoms.end();++it)
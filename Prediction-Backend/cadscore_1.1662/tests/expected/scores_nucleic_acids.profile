@@ -0,0 +1,893 @@
+cad_profile
+60
+A 1
+12
+AA 34.8935 107.376
+AM 32.9331 75.4743
+AS 6.46069 31.9016
+AW 9.079 182.555
+MA 28.193 57.7899
+MM 33.4237 56.3901
+MS 1.39977 1.39977
+MW 15.956 110.084
+SA 11.2009 49.586
+SM 0.4905 19.0842
+SS 11.6915 30.5018
+SW 6.8768 72.4708
+
+A 2
+11
+AA 27.5988 194.298
+AM 15.3765 72.533
+AS 38.3257 121.765
+AW 16.479 133.273
+MA 19.2636 142.426
+MM 15.3765 72.533
+MS 29.9905 69.8932
+MW 11.5663 60.0542
+SA 8.33519 51.8718
+SS 8.33519 51.8718
+SW 28.0457 73.2183
+
+A 3
+12
+AA 52.2074 310.258
+AM 57.2357 167.37
+AS 56.8194 142.888
+AW 16.6261 84.8028
+MA 72.8265 186.472
+MM 52.6226 116.877
+MS 25.7494 69.5947
+MW 9.5334 48.3523
+SA 42.3699 123.786
+SM 26.658 50.4931
+SS 32.5401 73.293
+SW 7.0926 36.4504
+
+A 4
+12
+AA 86.3385 343.468
+AM 17.3558 62.2278
+AS 95.0616 281.24
+AW 0.6824 74.1366
+MA 100.983 266.751
+MM 12.6495 61.6668
+MS 111.397 205.084
+MW 4.64857 4.64857
+SA 34.5372 76.7167
+SM 0.560939 0.560939
+SS 33.9763 76.1558
+SW 18.5328 69.488
+
+A 5
+12
+AA 78.3211 276.295
+AM 53.774 128.149
+AS 37.3572 148.146
+AW 40.6716 98.0474
+MA 87.2853 199.477
+MM 61.1399 99.9885
+MS 26.1455 99.4882
+MW 39.9518 39.9518
+SA 19.4878 76.8182
+SM 7.2694 28.1605
+SS 11.2119 48.6577
+SW 13.0361 58.0956
+
+A 6
+12
+AA 73.0748 258.97
+AM 60.1095 165.099
+AS 23.0819 93.8701
+AW 24.662 110.372
+MA 49.5467 155.642
+MM 31.9838 108.314
+MS 27.5964 47.3288
+MW 12.8752 64.0554
+SA 43.0523 103.327
+SM 28.1257 56.786
+SS 16.1086 46.5413
+SW 37.5363 46.3171
+
+A 7
+11
+AA 122.002 303.123
+AM 113.216 289.284
+AS 8.78555 13.8391
+AW 17.119 93.786
+MA 62.6611 132.66
+MM 62.6611 132.66
+MW 9.0177 93.6183
+SA 59.3405 170.462
+SM 56.3532 156.623
+SS 8.78555 13.8391
+SW 0.167688 0.167688
+
+A 8
+12
+AA 61.3531 279.799
+AM 67.4029 233.137
+AS 11.5128 46.6621
+AW 1.7627 95.5985
+MA 50.7148 144.834
+MM 57.0149 125.339
+MS 5.4388 19.4952
+MW 8.9899 71.3881
+SA 10.6379 134.965
+SM 10.3879 107.798
+SS 5.92203 27.1669
+SW 10.7526 24.2104
+
+A 9
+12
+AA 23.0902 330.727
+AM 43.3071 168.842
+AS 31.7911 161.886
+AW 5.0188 77.6168
+MA 8.50022 218.95
+MM 33.8747 107.958
+MS 26.622 110.991
+MW 0.646 26.7626
+SA 15.7026 111.778
+SM 9.43249 60.8838
+SS 5.16955 50.8947
+SW 4.3728 50.8542
+
+A 10
+11
+AA 43.7617 238.939
+AM 50.9051 208.76
+AS 7.1432 30.1788
+AW 2.413 123.798
+MA 40.4354 110.815
+MM 40.4354 110.815
+MW 8.6519 93.6537
+SA 28.9394 128.125
+SM 25.3447 97.9457
+SS 7.1432 30.1788
+SW 11.0649 30.1444
+
+A 11
+12
+AA 44.7251 224.821
+AM 55.228 153.582
+AS 10.5032 71.2384
+AW 14.756 119.26
+MA 35.2236 126.495
+MM 37.694 92.5182
+MS 2.4704 33.9764
+MW 13.2993 69.7694
+SA 14.5046 98.3256
+SM 22.5373 61.0636
+SS 9.05643 37.262
+SW 1.4571 49.4906
+
+A 12
+12
+AA 81.1873 396.7
+AM 96.4403 232.715
+AS 72.7124 163.984
+AW 8.3185 28.9474
+MA 48.3138 242.011
+MM 69.1506 115.046
+MS 54.9913 126.964
+MW 7.1456 13.5206
+SA 33.1693 154.688
+SM 24.8898 117.669
+SS 17.7212 37.0201
+SW 1.1728 15.4267
+
+A 13
+12
+AA 66.161 283.756
+AM 72.7515 237.492
+AS 8.4746 46.2638
+AW 20.9535 94.4097
+MA 39.8137 148.846
+MM 36.5876 129.351
+MS 3.3846 19.4952
+MW 10.1218 70.1993
+SA 42.6656 134.909
+SM 39.2612 108.14
+SS 14.0941 26.7686
+SW 10.8317 24.2104
+
+A 14
+11
+AA 55.4913 234.414
+AM 44.4651 216.521
+AS 11.0263 17.8925
+AW 34.711 124.036
+MA 34.5407 112.555
+MM 34.5407 112.555
+MW 52.4065 90.5975
+SA 20.9508 121.858
+SM 18.656 103.966
+SS 11.0263 17.8925
+SW 17.6955 33.4382
+
+A 15
+12
+AA 70.3163 214.895
+AM 72.5777 142.264
+AS 26.1759 72.6317
+AW 7.166 135.512
+MA 45.8923 128.218
+MM 58.5364 94.2556
+MS 12.644 33.9621
+MW 10.7813 75.4746
+SA 26.6661 86.6778
+SM 13.1343 48.0083
+SS 13.5319 38.6696
+SW 3.6155 60.0372
+
+A 16
+12
+AA 101.461 245.877
+AM 58.4535 155.191
+AS 43.0079 90.6861
+AW 25.286 115.13
+MA 65.3617 153.89
+MM 43.1317 102.049
+MS 22.23 51.8409
+MW 23.9663 63.3092
+SA 36.1001 91.987
+SM 15.3223 53.1418
+SS 20.7779 38.8452
+SW 1.3193 51.821
+
+A 17
+12
+AA 82.1207 428.005
+AM 77.0971 186.094
+AS 65.835 241.912
+AW 10.1258 37.3481
+MA 74.9743 286.985
+MM 58.1499 89.0589
+MS 46.6445 197.926
+MW 1.68242 1.68242
+SA 15.7005 141.021
+SM 18.9471 97.0346
+SS 19.3799 43.9861
+SW 15.2962 35.6657
+
+A 18
+12
+AA 51.9504 249.449
+AM 20.6902 70.3163
+AS 33.7345 179.133
+AW 44.126 118.309
+MA 46.6928 180.067
+MM 16.7815 54.206
+MS 32.3857 125.861
+MW 18.2222 48.5435
+SA 10.0995 69.382
+SM 3.9087 16.1103
+SS 6.19082 53.2717
+SW 25.9032 69.7659
+
+A 19
+12
+AA 79.6613 345.035
+AM 66.3149 193.13
+AS 76.2795 151.905
+AW 24.8546 57.1389
+MA 65.0657 219.366
+MM 43.8472 118.13
+MS 51.4765 101.237
+MW 15.7002 25.4955
+SA 39.1627 125.669
+SM 23.4726 75.0003
+SS 19.761 50.6684
+SW 9.1543 31.6433
+
+A 20
+12
+AA 48.7469 270.978
+AM 25.4395 180.488
+AS 27.8432 90.4899
+AW 15.8406 88.0724
+MA 46.842 167.538
+MM 27.2608 107.949
+MS 21.9203 59.59
+MW 10.5685 47.4355
+SA 32.6152 103.44
+SM 26.6923 72.5397
+SS 5.92288 30.8999
+SW 26.4088 40.6369
+
+A 21
+12
+AA 71.6788 215.193
+AM 69.1903 172.304
+AS 19.6032 42.8888
+AW 4.483 115.627
+MA 58.7281 114.266
+MM 54.7433 89.5314
+MS 3.9848 24.7347
+MW 6.0526 82.5363
+SA 39.302 100.927
+SM 14.447 82.7726
+SS 15.6184 18.1541
+SW 1.5695 33.0905
+
+A 22
+12
+AA 71.7796 391.119
+AM 58.0105 307.525
+AS 13.7692 83.594
+AW 23.6605 45.3224
+MA 63.9079 212.428
+MM 40.9687 161.498
+MS 22.9393 50.9302
+MW 9.7925 43.4893
+SA 46.5511 178.691
+SM 31.6575 146.027
+SS 15.6277 32.6639
+SW 1.83313 1.83313
+
+A 23
+12
+AA 89.4815 230.134
+AM 65.7704 182.533
+AS 23.7112 47.6012
+AW 26.1551 118.824
+MA 48.8558 113.448
+MM 38.9252 84.4487
+MS 9.93048 28.9994
+MW 18.8779 88.0991
+SA 54.2014 116.686
+SM 40.4207 98.0843
+SS 13.7806 18.6019
+SW 7.2774 30.7252
+
+A 24
+12
+AA 121.494 388.341
+AM 28.8772 230.758
+AS 96.7212 157.583
+AW 46.734 46.734
+MA 91.1631 243.634
+MM 28.1655 125.49
+MS 64.5349 118.144
+MW 23.5355 23.5355
+SA 50.7063 144.708
+SM 18.5201 105.269
+SS 32.1863 39.4389
+SW 23.1984 23.1984
+
+A 25
+12
+AA 71.6497 478.526
+AM 69.0542 286.889
+AS 50.0047 191.636
+AW 6.8134 7.9869
+MA 43.4484 293.826
+MM 43.5745 139.882
+MS 26.8882 153.945
+MW 3.46366 3.46366
+SA 44.4686 184.699
+SM 34.6858 147.007
+SS 23.1166 37.6918
+SW 1.77128 4.52324
+
+A 26
+12
+AA 44.2514 251.761
+AM 28.1267 114.764
+AS 41.4516 136.997
+AW 6.106 116.627
+MA 48.9047 165.666
+MM 34.0352 67.3389
+MS 21.7791 98.3272
+MW 13.7264 56.0068
+SA 37.6875 86.0949
+SM 7.1792 47.4254
+SS 19.6725 38.6696
+SW 19.8319 60.62
+
+A 27
+12
+AA 65.8974 276.704
+AM 48.2986 119.414
+AS 67.0509 157.29
+AW 11.099 100.642
+MA 53.257 184.661
+MM 30.6733 66.6147
+MS 25.6803 118.047
+MW 15.1622 48.8213
+SA 38.6357 92.0431
+SM 17.6253 52.7996
+SS 30.9848 39.2435
+SW 4.0636 51.821
+
+A 28
+11
+AA 91.7116 302.426
+AM 19.6109 34.5154
+AS 118.308 267.91
+AW 24.5973 93.3127
+MA 91.1038 249.963
+MM 19.6109 34.5154
+MS 91.416 215.447
+MW 5.04058 5.04058
+SA 30.1864 52.4628
+SS 30.1864 52.4628
+SW 2.8757 88.2721
+
+A 29
+12
+AA 29.399 276.17
+AM 46.7693 128.784
+AS 34.5722 147.385
+AW 15.9046 98.1729
+MA 30.1677 199.477
+MM 31.3476 99.9885
+MS 18.3822 99.4882
+MW 15.1338 39.9518
+SA 9.5148 76.6927
+SM 15.4216 28.7959
+SS 24.9364 47.8968
+SW 0.7708 58.2211
+
+A 30
+12
+AA 64.8204 217.175
+AM 26.6 106.341
+AS 41.436 110.834
+AW 0.278 133.275
+MA 35.4278 139.444
+MM 19.0186 73.2976
+MS 16.4092 66.1464
+MW 22.3269 66.5363
+SA 32.7549 77.7305
+SM 7.7281 33.0429
+SS 25.0268 44.6876
+SW 22.6051 66.739
+
+B 1
+12
+AA 75.4918 383.422
+AM 59.9163 197.253
+AS 100.495 186.17
+AW 10.1351 64.2518
+MA 108.581 243.265
+MM 71.268 100.899
+MS 77.3162 142.366
+MW 1.451 28.5861
+SA 30.2119 140.157
+SM 8.7172 96.354
+SS 26.0564 43.8032
+SW 8.6841 35.6657
+
+B 2
+12
+AA 40.3389 191.991
+AM 30.9727 141.97
+AS 18.6123 50.021
+AW 4.06 145.365
+MA 25.5783 107.368
+MM 28.4347 81.4328
+MS 17.0024 25.9357
+MW 14.3049 88.4061
+SA 23.3606 84.6225
+SM 2.5376 60.5372
+SS 20.823 24.0853
+SW 10.2449 56.9591
+
+B 3
+11
+AA 41.8382 237.452
+AM 46.8558 220.937
+AS 16.5157 16.5157
+AW 3.285 123.638
+MA 26.9327 103.45
+MM 26.9327 103.45
+MW 8.8478 99.4279
+SA 68.7712 134.002
+SM 72.5019 117.487
+SS 16.5157 16.5157
+SW 12.1327 24.2104
+
+B 4
+12
+AA 85.5149 391.836
+AM 79.8603 312.991
+AS 45.6501 78.8446
+AW 6.9615 53.4375
+MA 43.7586 207.269
+MM 46.9149 148.877
+MS 30.6306 58.3914
+MW 5.9822 52.3269
+SA 41.0396 184.567
+SM 32.3265 164.114
+SS 15.0195 20.4532
+SW 0.97925 1.11062
+
+B 5
+12
+AA 108.009 410.674
+AM 108.281 337.461
+AS 21.3431 73.2131
+AW 22.5709 47.2912
+MA 64.1259 221.452
+MM 71.7963 174.646
+MS 6.1368 46.806
+MW 6.7427 47.2912
+SA 53.3985 189.222
+SM 56.4501 162.815
+SS 16.74 26.4071
+SW 0 0
+
+B 6
+12
+AA 47.4007 288.124
+AM 59.6643 213.14
+AS 27.0963 74.9842
+AW 9.0664 95.4756
+MA 43.9836 161.506
+MM 47.6464 114.177
+MS 3.6628 47.3296
+MW 4.0804 62.0374
+SA 25.4604 126.618
+SM 29.3696 98.9635
+SS 23.4335 27.6546
+SW 13.1466 33.4382
+
+B 7
+12
+AA 127.175 440.406
+AM 107.895 313.929
+AS 32.7709 126.477
+AW 11.999 22.9974
+MA 88.2766 254.933
+MM 70.7694 159.162
+MS 13.8769 95.7714
+MW 14.3379 21.8868
+SA 42.3291 185.473
+SM 30.3154 154.767
+SS 17.4799 30.7061
+SW 1.11062 1.11062
+
+B 8
+12
+AA 53.3801 290.438
+AM 49.6459 227.911
+AS 31.0508 62.5266
+AW 1.591 88.8474
+MA 45.3463 155.529
+MM 38.3436 119.77
+MS 8.8145 35.758
+MW 18.8117 64.637
+SA 56.4121 134.909
+SM 36.4529 108.14
+SS 26.7686 26.7686
+SW 17.2207 24.2104
+
+B 9
+12
+AA 56.6213 270.359
+AM 55.6716 141.06
+AS 64.4117 129.299
+AW 8.9334 96.7406
+MA 39.3829 178.376
+MM 48.6005 88.7953
+MS 45.3914 89.5809
+MW 20.2446 44.9154
+SA 17.2385 91.9827
+SM 0.6581 52.2647
+SS 21.5553 39.718
+SW 11.3113 51.8252
+
+B 10
+12
+AA 106.551 401.833
+AM 66.3513 213.748
+AS 70.2953 188.085
+AW 10.8145 57.9426
+MA 65.3828 250.819
+MM 35.0958 121.267
+MS 43.1283 129.552
+MW 27.3926 27.3926
+SA 54.7315 151.014
+SM 23.4321 92.4816
+SS 36.2251 58.5327
+SW 18.4457 30.5501
+
+B 11
+12
+AA 96.9154 324.232
+AM 28.0613 124.235
+AS 87.9924 199.997
+AW 13.631 91.683
+MA 103.072 218.227
+MM 28.4204 80.2186
+MS 79.3725 138.009
+MW 13.5994 33.881
+SA 57.7949 106.004
+SM 21.5287 44.0164
+SS 36.2662 61.9877
+SW 0.0318 57.802
+
+B 12
+12
+AA 133.473 442.861
+AM 61.2063 184.134
+AS 86.5186 258.727
+AW 11.1074 31.7197
+MA 99.2436 295.078
+MM 41.2281 95.1752
+MS 64.1971 199.903
+MW 1.19352 1.19352
+SA 48.4166 147.783
+SM 31.1975 88.9586
+SS 22.3215 58.8246
+SW 2.7603 30.5262
+
+B 13
+12
+AA 103.143 352.353
+AM 39.6941 79.4619
+AS 111.932 272.89
+AW 11.1602 69.9509
+MA 50.1867 258.587
+MM 23.8231 63.5909
+MS 77.1855 194.997
+MW 3.73047 6.78423
+SA 58.5572 93.7648
+SM 15.871 15.871
+SS 42.6862 77.8938
+SW 7.4297 63.1667
+
+B 14
+12
+AA 47.1598 390.866
+AM 82.3997 217.62
+AS 64.4631 173.246
+AW 23.442 42.9342
+MA 40.8787 250.99
+MM 52.5837 136.4
+MS 41.5963 114.59
+MW 4.40717 10.4493
+SA 27.818 139.876
+SM 27.0403 81.2204
+SS 31.757 58.6561
+SW 19.0348 32.4849
+
+B 15
+12
+AA 97.7184 248.03
+AM 93.915 177.162
+AS 13.9172 70.8685
+AW 5.7143 99.4537
+MA 61.2772 130.902
+MM 43.6092 96.9258
+MS 23.3641 33.9764
+MW 5.3681 68.2442
+SA 71.9699 117.128
+SM 55.3941 80.2359
+SS 16.576 36.8921
+SW 0.3465 31.2095
+
+B 16
+11
+AA 40.6785 233.064
+AM 63.3803 204.791
+AS 20.154 28.2723
+AW 15.222 128.399
+MA 33.7723 103.765
+MM 33.7723 103.765
+MW 7.1151 99.4279
+SA 6.90642 129.298
+SM 29.6076 101.026
+SS 20.154 28.2723
+SW 8.1079 28.9707
+
+B 17
+12
+AA 14.9405 338.49
+AM 20.5704 233.191
+AS 8.26175 105.298
+AW 13.5588 74.2797
+MA 23.5345 182.854
+MM 12.1135 108.84
+MS 11.421 74.0139
+MW 19.3002 59.6562
+SA 29.279 155.636
+SM 26.1196 124.351
+SS 17.0506 31.2846
+SW 5.7414 14.6235
+
+B 18
+12
+AA 40.3958 200.352
+AM 38.4966 119.227
+AS 30.3649 81.1255
+AW 3.604 136.962
+MA 21.3325 132.688
+MM 23.7031 76.067
+MS 5.8601 56.6207
+MW 1.9513 72.1355
+SA 21.5791 67.6643
+SM 24.2631 43.1595
+SS 21.4119 24.5048
+SW 1.652 64.8267
+
+B 19
+12
+AA 71.615 240.433
+AM 51.3025 105.28
+AS 48.8775 135.153
+AW 17.2458 116.275
+MA 58.2077 155.836
+MM 18.1947 72.1248
+MS 47.0596 83.7109
+MW 14.6046 56.293
+SA 49.7399 84.5974
+SM 13.6055 33.1548
+SS 13.0899 51.4426
+SW 31.8507 59.9823
+
+B 20
+12
+AA 61.5943 225.919
+AM 33.7336 125.367
+AS 26.2837 100.552
+AW 4.182 107.319
+MA 40.7321 149.186
+MM 36.9532 80.6853
+MS 17.4449 68.5007
+MW 7.286 54.9786
+SA 19.3183 76.7327
+SM 10.7448 44.6816
+SS 20.8249 32.0511
+SW 3.1031 52.3408
+
+B 21
+12
+AA 119.258 306.478
+AM 51.3681 116.64
+AS 89.265 189.838
+AW 14.9781 88.2488
+MA 114.036 212.615
+MM 59.6873 100.448
+MS 60.9675 112.167
+MW 10.5014 25.1799
+SA 21.282 93.8627
+SM 8.3192 16.1926
+SS 28.2974 77.6701
+SW 4.4767 63.0689
+
+B 22
+11
+AA 57.6887 248.041
+AM 18.8309 72.9385
+AS 40.1043 175.102
+AW 28.798 113.473
+MA 45.0129 202.951
+MM 18.8309 72.9385
+MS 31.3431 130.013
+MW 22.4999 31.3475
+SA 13.6182 45.0894
+SS 13.6182 45.0894
+SW 6.2977 82.1255
+
+B 23
+12
+AA 58.5383 216.066
+AM 55.4212 146.21
+AS 15.9467 69.8558
+AW 19.9 120.707
+MA 33.316 130.787
+MM 40.554 89.9629
+MS 24.1642 40.824
+MW 16.5868 67.0343
+SA 35.9101 85.279
+SM 21.5029 56.2472
+SS 13.3172 29.0318
+SW 36.4867 53.6725
+
+B 24
+12
+AA 127.008 411.072
+AM 102.797 235.016
+AS 70.3296 176.056
+AW 24.4481 39.7572
+MA 77.8792 262.005
+MM 71.5756 136.857
+MS 40.5805 125.148
+MW 0.53655 9.28208
+SA 55.459 149.066
+SM 38.0634 98.1582
+SS 22.2604 50.9077
+SW 24.9846 30.4752
+
+B 25
+12
+AA 66.5205 357.002
+AM 56.4017 275.102
+AS 15.0707 81.9001
+AW 9.575 57.4539
+MA 63.5262 184.28
+MM 55.2875 141.044
+MS 8.23858 43.2358
+MW 6.9464 53.5362
+SA 36.3385 172.722
+SM 29.3021 134.057
+SS 7.73429 38.6642
+SW 2.62866 3.91774
+
+B 26
+12
+AA 73.4042 307.164
+AM 42.7751 127.43
+AS 62.6714 179.733
+AW 18.1316 76.5888
+MA 74.1844 213.206
+MM 32.9327 107.829
+MS 39.1055 105.378
+MW 17.0936 25.4955
+SA 18.8275 93.957
+SM 5.0354 19.6016
+SS 17.0983 74.3554
+SW 1.0379 51.0933
+
+B 27
+12
+AA 71.4899 229.186
+AM 82.3271 146.535
+AS 20.4395 82.6517
+AW 36.4318 115.044
+MA 60.7286 150.133
+MM 54.0031 112.682
+MS 2.8774 37.451
+MW 24.9141 62.0938
+SA 10.6514 79.0536
+SM 12.3051 33.8529
+SS 17.5621 45.2007
+SW 11.5174 52.95
+
+B 28
+12
+AA 41.7512 189.742
+AM 55.0994 130.205
+AS 17.7199 59.537
+AW 60.328 134.866
+MA 27.0016 113.009
+MM 33.4459 85.523
+MS 6.4443 27.4858
+MW 23.2821 82.5249
+SA 34.3589 76.7327
+SM 18.8185 44.6816
+SS 11.2756 32.0511
+SW 37.0461 52.3408
+
+B 29
+12
+AA 44.2295 206.996
+AM 17.7506 108.14
+AS 48.1656 98.8551
+AW 3.064 133.366
+MA 37.2947 133.041
+MM 28.3716 88.5384
+MS 30.6104 44.5031
+MW 9.0959 67.4788
+SA 11.4238 73.9536
+SM 10.621 19.6016
+SS 17.5552 54.352
+SW 12.1594 65.8869
+
+B 30
+11
+AA 20.3681 100.964
+AM 11.4326 39.1445
+AS 23.2425 61.8191
+AW 24.929 179.214
+MA 19.694 80.7703
+MM 11.4326 39.1445
+MS 17.3234 41.6258
+MW 1.2576 93.4477
+SA 5.9191 20.1933
+SS 5.9191 20.1933
+SW 23.6717 85.7663
+
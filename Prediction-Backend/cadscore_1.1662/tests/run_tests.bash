@@ -0,0 +1,309 @@
+#!/bin/bash
+
+##################################################
+### Printing usage help
+
+print_help()
+{
+cat << EOF 1>&2
+
+$0 parameters:
+
+  Optional:
+    -b    path to voroprot2 executable to test (by default it is built from the sources with OpenMP)
+    -s    path to directory with CAD-score scripts (by default the "bin" directory of the package)
+    -u    flag to rewrite the expected outputs instead of comparing with them
+    -p    flag to also check that the benchmark stages are not slower than in "benchmark_reference.json"
+    -h    show this message and exit
+
+The expected outputs were produced by the version 1.1662 executable and scripts
+(before the multithreaded construction and the open-addressing hash tables were introduced).
+Only the checks that compare with the expected outputs are run with "-u",
+so the expected outputs can be reproduced by any version of the executable and scripts.
+
+EOF
+}
+
+##################################################
+### Reading and checking arguments
+
+TESTS_DIR=$(cd "$(dirname "$0")" && pwd)
+SRC_DIR="$TESTS_DIR/../src"
+INPUT_DIR="$TESTS_DIR/input"
+EXPECTED_DIR="$TESTS_DIR/expected"
+
+VOROPROT=""
+SCRIPTS_DIR="$TESTS_DIR/../bin"
+UPDATE_EXPECTED=false
+CHECK_PERFORMANCE=false
+
+while getopts "hb:s:up" OPTION
+do
+  case $OPTION in
+    h)
+      print_help
+      exit 0
+      ;;
+    b)
+      VOROPROT=$OPTARG
+      ;;
+    s)
+      SCRIPTS_DIR=$OPTARG
+      ;;
+    u)
+      UPDATE_EXPECTED=true
+      ;;
+    p)
+      CHECK_PERFORMANCE=true
+      ;;
+    ?)
+      exit 1
+      ;;
+  esac
+done
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+
+mkdir -p "$WORK_DIR/bin"
+cp "$SCRIPTS_DIR"/CADscore_*.bash "$WORK_DIR/bin/"
+if [ -z "$VOROPROT" ]
+then
+  g++ -O3 -fopenmp -o "$WORK_DIR/bin/voroprot2" "$SRC_DIR"/*.cpp || exit 1
+else
+  cp "$VOROPROT" "$WORK_DIR/bin/voroprot2" || exit 1
+fi
+V="$WORK_DIR/bin/voroprot2"
+CALC="$WORK_DIR/bin/CADscore_calc.bash"
+
+FAILURES=0
+
+report()
+{
+  if [ "$2" -eq 0 ]
+  then
+    echo "passed: $1"
+  else
+    echo "FAILED: $1"
+    FAILURES=$((FAILURES+1))
+  fi
+}
+
+check_expected()
+{
+  if $UPDATE_EXPECTED
+  then
+    cp "$2" "$EXPECTED_DIR/$1"
+  else
+    cmp -s "$2" "$EXPECTED_DIR/$1"
+    report "$1 is the same as expected" $?
+  fi
+}
+
+check_same()
+{
+  cmp -s "$2" "$3"
+  report "$1" $?
+}
+
+check_close()
+{
+  awk -v tolerance="$4" 'NR==FNR { lines[FNR]=$0 ; count=FNR ; next }
+    {
+      if(split(lines[FNR], a)!=NF) { bad=1 }
+      for(i=1;i<=NF;i++)
+      {
+        if(a[i]!=$i)
+        {
+          if(a[i] !~ /^-?[0-9.]+(e[-+]?[0-9]+)?$/ || $i !~ /^-?[0-9.]+(e[-+]?[0-9]+)?$/) { bad=1 }
+          d=a[i]-$i ; if(d<0) { d=-d }
+          m=(a[i]<0 ? -a[i] : a[i]) ; if(m<1) { m=1 }
+          if(d>m*tolerance) { bad=1 }
+        }
+      }
+      checked=FNR
+    }
+    END { if(checked!=count) { bad=1 } ; exit bad }' "$2" "$3"
+  report "$1" $?
+}
+
+##################################################
+### Running unit tests of the header-only libraries
+
+if ! $UPDATE_EXPECTED
+then
+  for UNIT_TEST_FILE in "$TESTS_DIR"/unit/*.cpp
+  do
+    UNIT_TEST_NAME=$(basename "$UNIT_TEST_FILE" .cpp)
+    g++ -O2 -I"$SRC_DIR" -o "$WORK_DIR/$UNIT_TEST_NAME" "$UNIT_TEST_FILE" && "$WORK_DIR/$UNIT_TEST_NAME"
+    report "$UNIT_TEST_NAME" $?
+  done
+fi
+
+##################################################
+### Checking the Voronoi diagram and contacts of single structures
+
+W="$WORK_DIR/structures"
+mkdir -p "$W"
+
+cp "$INPUT_DIR/target_with_hidden_atoms.atoms" "$W/"
+for NAME in target rna_target
+do
+  $V --mode collect-atoms < "$INPUT_DIR/$NAME.pdb" > "$W/$NAME.atoms"
+  check_expected "$NAME.atoms" "$W/$NAME.atoms"
+done
+
+for NAME in target rna_target target_with_hidden_atoms
+do
+  $V --mode calc-inter-atom-contacts < "$W/$NAME.atoms" > "$W/$NAME.contacts" 2> /dev/null
+  $V --mode calc-quadruples < "$W/$NAME.atoms" > "$W/$NAME.quadruples" 2> /dev/null
+  $V --mode calc-quadruples --augment < "$W/$NAME.atoms" > "$W/$NAME.augmented_quadruples" 2> /dev/null
+  $V --mode calc-inter-atom-faces < "$W/$NAME.atoms" > "$W/$NAME.faces" 2> /dev/null
+  $V --mode calc-inter-residue-contacts < "$W/$NAME.contacts" > "$W/$NAME.residue_contacts"
+  for RESULT in contacts quadruples augmented_quadruples faces residue_contacts
+  do
+    check_expected "$NAME.$RESULT" "$W/$NAME.$RESULT"
+  done
+
+  if ! $UPDATE_EXPECTED
+  then
+    for THREADS in 1 2 4
+    do
+      $V --mode calc-inter-atom-contacts --threads $THREADS < "$W/$NAME.atoms" > "$W/$NAME.contacts.t$THREADS" 2> /dev/null
+      $V --mode calc-quadruples --threads $THREADS < "$W/$NAME.atoms" > "$W/$NAME.quadruples.t$THREADS" 2> /dev/null
+      $V --mode calc-quadruples --augment --threads $THREADS < "$W/$NAME.atoms" > "$W/$NAME.augmented_quadruples.t$THREADS" 2> /dev/null
+      $V --mode calc-inter-atom-faces --threads $THREADS < "$W/$NAME.atoms" > "$W/$NAME.faces.t$THREADS" 2> /dev/null
+      for RESULT in contacts quadruples augmented_quadruples faces
+      do
+        check_same "$NAME.$RESULT with --threads $THREADS is the same as without it" "$W/$NAME.$RESULT" "$W/$NAME.$RESULT.t$THREADS"
+      done
+    done
+
+    $V --mode calc-inter-atom-contacts --threads 4 < "$W/$NAME.atoms" > "$W/$NAME.contacts.t4.repeated" 2> /dev/null
+    $V --mode calc-quadruples --augment --threads 4 < "$W/$NAME.atoms" > "$W/$NAME.augmented_quadruples.t4.repeated" 2> /dev/null
+    check_same "$NAME.contacts with --threads 4 is the same in repeated runs" "$W/$NAME.contacts.t4" "$W/$NAME.contacts.t4.repeated"
+    check_same "$NAME.augmented_quadruples with --threads 4 is the same in repeated runs" "$W/$NAME.augmented_quadruples.t4" "$W/$NAME.augmented_quadruples.t4.repeated"
+
+    for RUN in first second
+    do
+      $V --mode calc-inter-atom-contacts --cache-dir "$W/cache" < "$W/$NAME.atoms" > "$W/$NAME.contacts.cached" 2> /dev/null
+      check_same "$NAME.contacts with the cache ($RUN run) is the same as without it" "$W/$NAME.contacts" "$W/$NAME.contacts.cached"
+    done
+
+    $V --mode calc-inter-atom-contacts --binary-io < "$W/$NAME.atoms" 2> /dev/null | $V --mode convert-data-format --type inter-atom-contacts > "$W/$NAME.contacts.from_binary" 2> /dev/null
+    check_same "$NAME.contacts written in binary format are the same after conversion" "$W/$NAME.contacts" "$W/$NAME.contacts.from_binary"
+  fi
+done
+
+(cat "$INPUT_DIR/homo_target.pdb" | $V --mode collect-atoms ; cat "$INPUT_DIR/homo_model_renumbered.pdb" | $V --mode collect-atoms) > "$W/renumbering.atoms"
+$V --mode x-renumber-residues-by-reference < "$W/renumbering.atoms" > "$W/renumbered.atoms"
+check_expected "renumbered.atoms" "$W/renumbered.atoms"
+if ! $UPDATE_EXPECTED
+then
+  $V --mode x-renumber-residues-by-reference --threads 3 < "$W/renumbering.atoms" > "$W/renumbered.atoms.t3"
+  check_same "renumbered.atoms with --threads 3 is the same as without it" "$W/renumbered.atoms" "$W/renumbered.atoms.t3"
+
+  cat "$INPUT_DIR/homo_model_renumbered.pdb" | $V --mode collect-atoms --binary-io > "$W/renumbering_model.atoms.binary"
+  (cat "$INPUT_DIR/homo_target.pdb" | $V --mode collect-atoms ; cat "$W/renumbering_model.atoms.binary") | $V --mode merge-atoms > "$W/merged.atoms.from_mixed"
+  $V --mode merge-atoms < "$W/renumbering.atoms" > "$W/merged.atoms"
+  check_same "merged atoms read from text and binary inputs are the same as from text inputs" "$W/merged.atoms" "$W/merged.atoms.from_mixed"
+
+  printf '\177CAD\001\000\000\000\005\000\000\000atoms\377\377\377\377\377\377\377\377' > "$W/forged_length.atoms"
+  (ulimit -v 2000000 ; $V --mode convert-data-format --type atoms < "$W/forged_length.atoms" > /dev/null 2> "$W/forged_length.log")
+  grep -q "unexpected end of binary input stream" "$W/forged_length.log"
+  report "binary input with a forged string length is rejected without allocating that length" $?
+fi
+
+##################################################
+### Checking CAD-score calculations with scripts
+
+W="$WORK_DIR/scoring"
+mkdir -p "$W"
+cp "$INPUT_DIR"/*.pdb "$W/"
+cd "$W"
+
+score()
+{
+  DATABASE_NAME=$1
+  shift
+  $CALC -D "$DATABASE_NAME" "$@" 2> /dev/null
+  "$WORK_DIR/bin/CADscore_read_global_scores.bash" -D "$DATABASE_NAME" > "$DATABASE_NAME.global_scores"
+}
+
+score db -t target.pdb -m model1.pdb -a
+score db -t target.pdb -m model2.pdb -a
+"$WORK_DIR/bin/CADscore_read_local_scores.bash" -D db -t target.pdb -m model1.pdb -c AS -w 3 > db.local_scores
+cp db/targets/target.pdb/models/model1.pdb/cad_profile db.model1_profile
+check_expected "scores.global_scores" db.global_scores
+check_expected "scores.local_scores" db.local_scores
+check_expected "scores.model1_profile" db.model1_profile
+
+score db_inter_chain -t target.pdb -m model1.pdb -c
+check_expected "scores_inter_chain.global_scores" db_inter_chain.global_scores
+
+score db_homo -t homo_target.pdb -m homo_model.pdb -q
+check_expected "scores_with_chains_renaming.global_scores" db_homo.global_scores
+
+score db_rna -t rna_target.pdb -m rna_model.pdb -n
+cp db_rna/targets/rna_target.pdb/models/rna_model.pdb/cad_profile db_rna.profile
+check_expected "scores_nucleic_acids.global_scores" db_rna.global_scores
+check_expected "scores_nucleic_acids.profile" db_rna.profile
+
+if ! $UPDATE_EXPECTED
+then
+  score db_binary -t target.pdb -m model1.pdb -a -k
+  score db_binary -t target.pdb -m model2.pdb -a -k
+  check_close "global scores with binary intermediate data are close to the ones with text data" db.global_scores db_binary.global_scores 1e-4
+  "$WORK_DIR/bin/CADscore_read_local_scores.bash" -D db_binary -t target.pdb -m model1.pdb -c AS -w 3 > db_binary.local_scores
+  check_close "local scores with binary intermediate data are close to the ones with text data" db.local_scores db_binary.local_scores 1e-4
+  $V --mode convert-data-format --type cad-profile < db_binary/targets/target.pdb/models/model1.pdb/cad_profile > db_binary.model1_profile
+  check_close "profile with binary intermediate data is close to the one with text data" db.model1_profile db_binary.model1_profile 2e-3
+
+  mkdir -p end_to_end
+  $V --mode calc-CAD-end-to-end --target target.pdb --model model1.pdb --output-dir end_to_end < /dev/null > end_to_end.global_scores 2> /dev/null
+  check_close "global scores of end-to-end mode are close to the ones of the scripts" db/targets/target.pdb/models/model1.pdb/cad_global_scores end_to_end/cad_global_scores 1e-4
+  check_close "profile of end-to-end mode is close to the one of the scripts" db.model1_profile end_to_end/cad_profile 2e-3
+  $V --mode calc-CAD-end-to-end --target target.pdb --model model1.pdb --engine icosahedron --depth 3 --probe 1.4 < /dev/null > end_to_end.explicit_defaults 2> /dev/null
+  check_same "global scores of end-to-end mode with explicit contacts options are the same as with the defaults" end_to_end.global_scores end_to_end.explicit_defaults
+
+  cut -f 1-19 db.global_scores > db.global_scores_without_atomic
+  for THREADS in 1 2 5
+  do
+    (echo model1.pdb ; echo model2.pdb) | $V --mode calc-CAD-batch --target target.pdb --threads $THREADS > batch.global_scores.t$THREADS 2> /dev/null
+    check_close "global scores of batch mode with --threads $THREADS are close to the ones of the scripts" db.global_scores_without_atomic batch.global_scores.t$THREADS 1e-4
+  done
+  check_same "global scores of batch mode with more threads than models are the same as with one thread" batch.global_scores.t1 batch.global_scores.t5
+fi
+
+##################################################
+### Checking the benchmark against the reference
+
+# The reference times were measured on one machine, so by default only the numbers of items produced by the stages are checked
+if ! $UPDATE_EXPECTED
+then
+  MAX_SLOWDOWN=1000000
+  if $CHECK_PERFORMANCE
+  then
+    MAX_SLOWDOWN=1.5
+  fi
+  (cd "$INPUT_DIR" && $V --mode benchmark --sizes 1000,10000 --pdb target.pdb --reference "$TESTS_DIR/benchmark_reference.json" --max-slowdown $MAX_SLOWDOWN < /dev/null > "$WORK_DIR/benchmark.json")
+  report "benchmark stages agree with the reference" $?
+  (cd "$INPUT_DIR" && $V --mode benchmark --sizes 1000 --pdb target.pdb --compare-d-validation < /dev/null > "$WORK_DIR/benchmark_d_validation.json")
+  report "quadruples do not depend on validating d in batches" $?
+fi
+
+##################################################
+### Summarizing
+
+if $UPDATE_EXPECTED
+then
+  echo "expected outputs were rewritten"
+  exit 0
+fi
+
+if [ "$FAILURES" -ne 0 ]
+then
+  echo "$FAILURES test(s) failed" 1>&2
+  exit 1
+fi
+echo "all tests passed"
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "auxiliaries/disk_cache.h"
+
+namespace
+{
+
+std::string value_path(const std::string& directory, const auxiliaries::DiskCache::Key& key)
+{
+	return (directory+"/"+key.str()+".cache");
+}
+
+bool check_disk_cache(const std::string& directory)
+{
+	const auxiliaries::DiskCache cache(directory, 1024*1024);
+
+	auxiliaries::DiskCache::Key key_a;
+	key_a.add(std::string("kind")).add(1.5);
+	auxiliaries::DiskCache::Key key_b;
+	key_b.add(std::string("kind")).add(2.5);
+
+	std::string value;
+	if(cache.read(key_a, value))
+	{
+		std::cerr << "Empty cache found a value\n";
+		return false;
+	}
+
+	const std::string value_a("value\nwith binary \0 bytes", 26);
+	cache.write(key_a, value_a);
+	if(!cache.read(key_a, value) || value!=value_a)
+	{
+		std::cerr << "Cache did not return the written value\n";
+		return false;
+	}
+
+	// Simulating a collision of the hashes: the value of one key is stored under the name of another key
+	if(std::rename(value_path(directory, key_a).c_str(), value_path(directory, key_b).c_str())!=0)
+	{
+		std::cerr << "Failed to rename the cached value\n";
+		return false;
+	}
+	if(cache.read(key_b, value))
+	{
+		std::cerr << "Cache returned the value of a different key with the same file name\n";
+		return false;
+	}
+
+	cache.write(key_b, std::string());
+	if(!cache.read(key_b, value) || !value.empty())
+	{
+		std::cerr << "Cache did not return the written empty value\n";
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	char directory_template[]="/tmp/test_disk_cache.XXXXXX";
+	if(mkdtemp(directory_template)==0)
+	{
+		std::cerr << "Failed to create a temporary directory\n";
+		return 1;
+	}
+	const std::string directory(directory_template);
+	const bool success=check_disk_cache(directory);
+	const int cleanup_status=std::system((std::string("rm -rf '")+directory+"'").c_str());
+	return ((success && cleanup_status==0) ? 0 : 1);
+}
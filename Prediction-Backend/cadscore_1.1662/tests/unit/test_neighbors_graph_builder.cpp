@@ -0,0 +1,60 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "apollota/triangulation.h"
+#include "apollota/utilities_for_triangulation.h"
+
+namespace
+{
+
+std::vector<apollota::SimpleSphere> generate_random_spheres(const std::size_t number_of_spheres, const unsigned int seed)
+{
+	std::srand(seed);
+	std::vector<apollota::SimpleSphere> spheres;
+	for(std::size_t i=0;i<number_of_spheres;i++)
+	{
+		apollota::SimpleSphere sphere;
+		sphere.x=static_cast<double>(std::rand()%20000)/1000.0;
+		sphere.y=static_cast<double>(std::rand()%20000)/1000.0;
+		sphere.z=static_cast<double>(std::rand()%20000)/1000.0;
+		sphere.r=1.0+static_cast<double>(std::rand()%1000)/1000.0;
+		spheres.push_back(sphere);
+	}
+	return spheres;
+}
+
+bool check_neighbors_graph_builder(const unsigned int seed)
+{
+	const std::vector<apollota::SimpleSphere> spheres=generate_random_spheres(600, seed);
+
+	apollota::Triangulation::QuadruplesSearchLog log=apollota::Triangulation::QuadruplesSearchLog();
+	const apollota::CompressedNeighborsGraph graph=apollota::Triangulation::construct_neighbors_graph(spheres, 3.5, true, 1, log);
+
+	const apollota::Triangulation::Result result=apollota::Triangulation::construct_result(spheres, 3.5, true, false);
+	const apollota::CompressedNeighborsGraph reference_graph=apollota::UtilitiesForTriangulation::collect_neighbors_graph_from_quadruples_map(result.quadruples_map, spheres.size());
+
+	if(graph.offsets!=reference_graph.offsets || graph.ids!=reference_graph.ids)
+	{
+		std::cerr << "Neighbors graph differs from the one collected from the quadruples map (seed " << seed << ")\n";
+		return false;
+	}
+	if(log.added_quadruples<result.quadruples_map.size() || log.added_quadruples==0 || log.added_tangent_spheres!=0)
+	{
+		std::cerr << "Neighbors graph builder reported " << log.added_quadruples << " quadruples and " << log.added_tangent_spheres << " tangent spheres, but the quadruples map has " << result.quadruples_map.size() << " quadruples (seed " << seed << ")\n";
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	bool success=true;
+	for(unsigned int seed=1;seed<=3;seed++)
+	{
+		success=(check_neighbors_graph_builder(seed) && success);
+	}
+	return (success ? 0 : 1);
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <map>
+#include <cstdlib>
+
+#include "apollota/open_addressing_hash_map.h"
+
+namespace
+{
+
+struct CollidingHashFunctor
+{
+	std::size_t operator()(const std::size_t value) const
+	{
+		return (value%7);
+	}
+};
+
+template<typename HashFunctor>
+bool check_contents(const apollota::OpenAddressingHashMap<std::size_t, int, HashFunctor>& map, const std::map<std::size_t, int>& reference_map)
+{
+	typedef apollota::OpenAddressingHashMap<std::size_t, int, HashFunctor> Map;
+	if(map.size()!=reference_map.size())
+	{
+		return false;
+	}
+	for(typename Map::const_iterator it=map.begin();it!=map.end();++it)
+	{
+		std::map<std::size_t, int>::const_iterator reference_it=reference_map.find(it->first);
+		if(reference_it==reference_map.end() || reference_it->second!=it->second)
+		{
+			return false;
+		}
+	}
+	for(std::map<std::size_t, int>::const_iterator it=reference_map.begin();it!=reference_map.end();++it)
+	{
+		typename Map::const_iterator found_it=map.find(it->first);
+		if(found_it==map.end() || found_it->second!=it->second)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename HashFunctor>
+bool run_random_operations(const std::size_t keys_range, const std::size_t operations_count, const unsigned int seed)
+{
+	apollota::OpenAddressingHashMap<std::size_t, int, HashFunctor> map;
+	std::map<std::size_t, int> reference_map;
+	std::srand(seed);
+	for(std::size_t i=0;i<operations_count;i++)
+	{
+		const std::size_t key=static_cast<std::size_t>(std::rand())%keys_range;
+		const int operation=std::rand()%4;
+		if(operation==0)
+		{
+			const int value=std::rand();
+			const bool inserted=map.insert(std::make_pair(key, value)).second;
+			const bool reference_inserted=reference_map.insert(std::make_pair(key, value)).second;
+			if(inserted!=reference_inserted)
+			{
+				return false;
+			}
+		}
+		else if(operation==1)
+		{
+			const int value=std::rand();
+			map[key]=value;
+			reference_map[key]=value;
+		}
+		else if(operation==2)
+		{
+			if(map.erase(key)!=reference_map.erase(key))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if(map.count(key)!=reference_map.count(key))
+			{
+				return false;
+			}
+		}
+		if(i%97==0 && !check_contents(map, reference_map))
+		{
+			return false;
+		}
+	}
+	return check_contents(map, reference_map);
+}
+
+}
+
+int main()
+{
+	bool success=true;
+	for(unsigned int seed=1;seed<=5;seed++)
+	{
+		if(!run_random_operations<apollota::IdentityHashFunctor>(200, 20000, seed))
+		{
+			std::cerr << "Map with identity hash differs from std::map (seed " << seed << ")\n";
+			success=false;
+		}
+		if(!run_random_operations<apollota::IdentityHashFunctor>(5000, 20000, seed))
+		{
+			std::cerr << "Map with identity hash and sparse keys differs from std::map (seed " << seed << ")\n";
+			success=false;
+		}
+		if(!run_random_operations<CollidingHashFunctor>(300, 20000, seed))
+		{
+			std::cerr << "Map with colliding hash differs from std::map (seed " << seed << ")\n";
+			success=false;
+		}
+	}
+	return (success ? 0 : 1);
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "protein/sequence_tools.h"
+
+namespace
+{
+
+// The full matrices version of the alignment, which the compact version must reproduce exactly, including the choices between equal scores
+template<typename T, typename Scorer>
+std::vector< std::pair<int, int> > construct_reference_sequence_alignment(const T& seq1, const T& seq2, const Scorer& scorer, const bool local, int* result_score)
+{
+	std::vector< std::pair<int, int> > alignment;
+	if(!seq1.empty() && !seq2.empty())
+	{
+		std::vector< std::vector<int> > scores_matrix(seq1.size()+1, std::vector<int>(seq2.size()+1, 0));
+		std::vector< std::vector<int> > directions_matrix(seq1.size()+1, std::vector<int>(seq2.size()+1, 0));
+		for(std::size_t i=1;i<=seq1.size();i++)
+		{
+			scores_matrix[i][0]=((i==1) ? scorer.gap_start() : (scores_matrix[i-1][0]+scorer.gap_extension()));
+			directions_matrix[i][0]=1;
+		}
+		for(std::size_t j=1;j<=seq2.size();j++)
+		{
+			scores_matrix[0][j]=((j==1) ? scorer.gap_start() : (scores_matrix[0][j-1]+scorer.gap_extension()));
+			directions_matrix[0][j]=2;
+		}
+		std::pair<std::size_t, std::size_t> result_score_pos(0, 0);
+		for(std::size_t i=1;i<=seq1.size();i++)
+		{
+			for(std::size_t j=1;j<=seq2.size();j++)
+			{
+				const typename T::value_type& v1=seq1[i-1];
+				const typename T::value_type& v2=seq2[j-1];
+				const int match_score=scores_matrix[i-1][j-1]+scorer.match(v1, v2);
+				const int deletion_score=scores_matrix[i-1][j]+(directions_matrix[i-1][j]!=1 ? scorer.gap_start() : scorer.gap_extension());
+				const int insertion_score=scores_matrix[i][j-1]+(directions_matrix[i][j-1]!=2 ? scorer.gap_start() : scorer.gap_extension());
+				const int max_score=std::max(match_score, std::max(deletion_score, insertion_score));
+				directions_matrix[i][j]=(max_score==insertion_score ? 2 : (max_score==deletion_score ? 1 : 0));
+				scores_matrix[i][j]=(local ? std::max(0, max_score) : max_score);
+				if(local && scores_matrix[i][j]>scores_matrix[result_score_pos.first][result_score_pos.second])
+				{
+					result_score_pos=std::make_pair(i, j);
+				}
+			}
+		}
+		if(!local)
+		{
+			result_score_pos.first=seq1.size();
+			result_score_pos.second=seq2.size();
+		}
+		if(result_score!=0)
+		{
+			*result_score=scores_matrix[result_score_pos.first][result_score_pos.second];
+		}
+
+		int i=static_cast<int>(seq1.size());
+		int j=static_cast<int>(seq2.size());
+		while(i>static_cast<int>(result_score_pos.first))
+		{
+			i--;
+			alignment.push_back(std::make_pair(i, -1));
+		}
+		while(j>static_cast<int>(result_score_pos.second))
+		{
+			j--;
+			alignment.push_back(std::make_pair(-1, j));
+		}
+		while(i>0 && j>0 && (!local || scores_matrix[i][j]>0))
+		{
+			const int dir=directions_matrix[i][j];
+			if(dir==0)
+			{
+				i--;
+				j--;
+				alignment.push_back(std::make_pair(i, j));
+			}
+			else if(dir==1)
+			{
+				i--;
+				alignment.push_back(std::make_pair(i, -1));
+			}
+			else
+			{
+				j--;
+				alignment.push_back(std::make_pair(-1, j));
+			}
+		}
+		while(i>0)
+		{
+			i--;
+			alignment.push_back(std::make_pair(i, -1));
+		}
+		while(j>0)
+		{
+			j--;
+			alignment.push_back(std::make_pair(-1, j));
+		}
+		std::reverse(alignment.begin(), alignment.end());
+	}
+	return alignment;
+}
+
+std::string generate_random_sequence(const std::size_t max_length, const std::size_t alphabet_size)
+{
+	std::string sequence(1+static_cast<std::size_t>(std::rand())%max_length, 'A');
+	for(std::size_t i=0;i<sequence.size();i++)
+	{
+		sequence[i]=static_cast<char>('A'+std::rand()%static_cast<int>(alphabet_size));
+	}
+	return sequence;
+}
+
+bool check_alignment(const std::string& seq1, const std::string& seq2, const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer& scorer, const bool local)
+{
+	int score=0;
+	int reference_score=0;
+	const std::vector< std::pair<int, int> > alignment=protein::sequence_tools::PairwiseSequenceAlignment::construct_sequence_alignment(seq1, seq2, scorer, local, &score);
+	const std::vector< std::pair<int, int> > reference_alignment=construct_reference_sequence_alignment(seq1, seq2, scorer, local, &reference_score);
+	if(alignment!=reference_alignment || score!=reference_score)
+	{
+		std::cerr << "Alignment differs from the reference (" << (local ? "local" : "global") << ", score " << score << " vs " << reference_score << "):\n" << seq1 << "\n" << seq2 << "\n";
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	std::srand(1);
+	bool success=true;
+	for(int i=0;i<20000 && success;i++)
+	{
+		const std::size_t max_length=(i%10==0 ? 300 : 40);
+		const std::size_t alphabet_size=2+static_cast<std::size_t>(std::rand()%20);
+		const std::string seq1=generate_random_sequence(max_length, alphabet_size);
+		const std::string seq2=generate_random_sequence(max_length, alphabet_size);
+		const protein::sequence_tools::PairwiseSequenceAlignment::SimpleScorer scorer(std::rand()%11, -(std::rand()%11), -(std::rand()%11), -(std::rand()%11));
+		success=(check_alignment(seq1, seq2, scorer, false) && check_alignment(seq1, seq2, scorer, true));
+	}
+	return (success ? 0 : 1);
+}